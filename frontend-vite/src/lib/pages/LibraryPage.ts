@@ -21,6 +21,7 @@ interface LibraryState extends ComponentState {
 export class LibraryPage extends BaseComponent<LibraryState> {
   private eventUnsubscribers: Array<() => void> = [];
   private thumbnailsLoaded: Set<string> = new Set();
+  private streamBase: Promise<string> | null = null;
 
   constructor() {
     super({
@@ -225,6 +226,23 @@ export class LibraryPage extends BaseComponent<LibraryState> {
     }
   }
 
+  /**
+   * Base URL for thumbnails, pages and files: the streaming port reported
+   * by /api/health, or the API port when streaming is disabled
+   */
+  private getStreamBase(): Promise<string> {
+    if (!this.streamBase) {
+      this.streamBase = fetch('http://localhost:8080/api/health')
+        .then(response => response.json())
+        .then(result => {
+          const streamPort = result.data?.stream_port;
+          return streamPort ? `http://localhost:${streamPort}` : 'http://localhost:8080';
+        })
+        .catch(() => 'http://localhost:8080');
+    }
+    return this.streamBase;
+  }
+
   /**
    * Load thumbnails for all books
    */
@@ -252,10 +270,9 @@ export class LibraryPage extends BaseComponent<LibraryState> {
     }
 
     try {
-      const token = localStorage.getItem('sessionToken');
-      const response = await fetch(`http://localhost:8080/api/books/${bookId}/thumbnail`, {
-        headers: { 'X-Session-Token': token || '' }
-      });
+      // Thumbnails are public, so no token header (and no CORS preflight)
+      const streamBase = await this.getStreamBase();
+      const response = await fetch(`${streamBase}/api/books/${bookId}/thumbnail`);
 
       if (response.ok) {
         const blob = await response.blob();
@@ -0,0 +1,172 @@
+/**
+ * @file archive_handle_pool.h
+ * @brief Pool of open ZIP handles and parsed central directories for EPUB/CBZ files
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef ARCHIVE_HANDLE_POOL_H
+#define ARCHIVE_HANDLE_POOL_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <minizip/unzip.h>
+#include <nlohmann/json.hpp>
+
+/**
+ * @struct ArchiveIndex
+ * @brief Parsed central directory of one archive
+ *
+ * Built once per (inode, mtime) and shared by every lease on that file, so
+ * finding an entry is a hash lookup plus unzGoToFilePos64 instead of a
+ * linear unzLocateFile scan over the central directory.
+ */
+struct ArchiveIndex {
+    struct Entry {
+        std::string name;             ///< Entry path inside the archive
+        unz64_file_pos position;      ///< Position of the entry in the central directory
+        uint64_t compressed_size = 0;
+        uint64_t uncompressed_size = 0;
+    };
+
+    std::vector<Entry> entries;                          ///< Entries in central directory order
+    std::unordered_map<std::string, size_t> by_name;     ///< Entry name -> index into entries
+
+    /**
+     * @brief Finds an entry by name
+     * @param name Entry path inside the archive
+     * @return Entry or nullptr if the archive has no such entry
+     */
+    const Entry* find(const std::string& name) const;
+};
+
+/**
+ * @class ArchiveHandlePool
+ * @brief Keeps unzFile handles and central-directory indexes of recently used archives
+ *
+ * Opening an archive with minizip costs an open(2), a seek to the end of the
+ * file and parsing of the end-of-central-directory record; finding an entry
+ * then walks the central directory. Page and chapter requests hit the same
+ * few books over and over, so both are cached here:
+ * - Files are keyed by path and validated against (device, inode, mtime);
+ *   a replaced file gets a fresh index and its old handles are closed
+ * - A handle is leased exclusively to one caller (minizip handles carry a
+ *   cursor and are not thread-safe) and returned to the pool when the lease
+ *   goes out of scope
+ * - The number of open handles is capped; idle handles of the least
+ *   recently used archives are closed first
+ */
+class ArchiveHandlePool {
+private:
+    struct File;
+
+public:
+    /**
+     * @class Lease
+     * @brief Exclusive use of one open handle; returns it to the pool on destruction
+     */
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease();
+
+        /**
+         * @brief Gets the leased minizip handle
+         * @return Open unzFile
+         */
+        unzFile handle() const { return zip; }
+
+        /**
+         * @brief Gets the central-directory index of the archive
+         * @return Shared index
+         */
+        const ArchiveIndex& index() const;
+
+        /**
+         * @brief Makes an entry the current file of the handle using the index
+         * @param entry_name Entry path inside the archive
+         * @return true if the entry exists and the handle is positioned on it
+         */
+        bool seek(const std::string& entry_name);
+
+    private:
+        friend class ArchiveHandlePool;
+        Lease(ArchiveHandlePool* pool, std::shared_ptr<File> file, unzFile zip);
+
+        ArchiveHandlePool* pool;
+        std::shared_ptr<File> file;
+        unzFile zip;
+    };
+
+    /**
+     * @brief Constructor
+     * @param max_open_handles Upper bound on idle + leased handles kept open
+     * @param max_files Upper bound on archives whose index is kept
+     */
+    explicit ArchiveHandlePool(size_t max_open_handles = 64, size_t max_files = 512);
+
+    /**
+     * @brief Destructor - closes all idle handles
+     */
+    ~ArchiveHandlePool();
+
+    /**
+     * @brief Leases an open handle for an archive
+     * @param file_path Path to the EPUB/CBZ file
+     * @return Lease holding the handle and index
+     * @throws std::runtime_error if the archive cannot be opened
+     */
+    Lease acquire(const std::string& file_path);
+
+    /**
+     * @brief Gets pool statistics
+     * @return JSON object with handle counts and hit/miss counters
+     */
+    nlohmann::json get_stats();
+
+    /**
+     * @brief Gets the process-wide pool used by BookManager
+     * @return Shared pool sized from RLIMIT_NOFILE
+     */
+    static ArchiveHandlePool& shared();
+
+private:
+    struct File {
+        std::string path;
+        std::string identity;                        ///< "dev:inode:mtime" when the index was built
+        std::shared_ptr<const ArchiveIndex> index;
+        std::vector<unzFile> idle;                   ///< Open handles not currently leased
+        std::list<std::string>::iterator lru_position;
+        bool retired = false;                        ///< Replaced or evicted; close handles on release
+    };
+
+    size_t max_open;
+    size_t max_files;
+
+    std::mutex pool_mutex;
+    std::unordered_map<std::string, std::shared_ptr<File>> files;
+    std::list<std::string> lru;                      ///< Paths, most recently used at the front
+    size_t open_handles = 0;
+
+    std::atomic<uint64_t> handle_hits{0};
+    std::atomic<uint64_t> handle_opens{0};
+    std::atomic<uint64_t> index_builds{0};
+
+    void release(const std::shared_ptr<File>& file, unzFile zip);
+    void retire_locked(std::shared_ptr<File> file);
+    void enforce_limits_locked();
+
+    static std::shared_ptr<const ArchiveIndex> build_index(unzFile zip);
+};
+
+#endif // ARCHIVE_HANDLE_POOL_H
@@ -0,0 +1,176 @@
+/**
+ * @file book_catalog.h
+ * @brief Columnar in-memory catalog for sorted and filtered book listings
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef BOOK_CATALOG_H
+#define BOOK_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+class Database;
+struct CatalogRow;
+
+/**
+ * @class BookCatalog
+ * @brief Structure-of-arrays copy of the listing attributes of every book
+ *
+ * Each attribute lives in its own vector indexed by row: IDs, sizes and
+ * timestamps as plain integers, format as a one-byte code, and authors,
+ * publishers and languages as IDs into interned string pools. Titles carry
+ * their Collation sort key, whose first 8 bytes are also packed into an
+ * integer so most comparisons never touch the string. Filtering is a
+ * linear scan over a few of these vectors and sorting only moves 32-bit
+ * row indices; JSON is built for the returned page only.
+ *
+ * Loaded from the database at startup and updated per book as books are
+ * uploaded or scanned.
+ */
+class BookCatalog {
+public:
+    /**
+     * @enum SortKey
+     * @brief Listing order
+     */
+    enum class SortKey {
+        Title,
+        Author,
+        Size,
+        Date
+    };
+
+    /**
+     * @struct Query
+     * @brief Filters, order and page of a listing
+     */
+    struct Query {
+        SortKey sort = SortKey::Date;
+        bool descending = true;
+        std::string format;     ///< File type, empty for any
+        std::string language;   ///< Language code, empty for any
+        std::string author;     ///< Author name (case-insensitive), empty for any
+        long min_size = 0;      ///< Bytes
+        long max_size = -1;     ///< Bytes, -1 for no limit
+        size_t offset = 0;
+        size_t limit = 50;
+    };
+
+    /**
+     * @struct Page
+     * @brief One page of a listing
+     */
+    struct Page {
+        size_t total = 0;      ///< Matching books before paging
+        nlohmann::json books;  ///< Array of book objects
+    };
+
+    /**
+     * @brief Constructor
+     * @param db Database the catalog is loaded from
+     */
+    explicit BookCatalog(Database* db);
+
+    /**
+     * @brief Reloads every book from the database
+     * @return true on success (the old catalog is kept on failure)
+     */
+    bool rebuild();
+
+    /**
+     * @brief Loads or reloads a single book
+     * @param book_id ID of the book
+     * @return true if the book was found
+     */
+    bool upsert(long book_id);
+
+    /**
+     * @brief Drops a book
+     * @param book_id ID of the book
+     */
+    void remove(long book_id);
+
+    /**
+     * @brief Runs a listing query
+     * @param query Filters, order and page
+     * @return Total matches and the requested page
+     */
+    Page query(const Query& query) const;
+
+    /**
+     * @brief Parses a sort name (title, author, size, date)
+     * @param name Sort name
+     * @param key Receives the sort key
+     * @return false if the name is unknown
+     */
+    static bool parse_sort_key(const std::string& name, SortKey& key);
+
+    /**
+     * @brief Gets a counter that changes whenever any row changes
+     * @return Current version, for caching serialized query results
+     */
+    uint64_t version() const { return generation.load(); }
+
+    /**
+     * @brief Gets catalog size statistics
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats() const;
+
+private:
+    /**
+     * @struct StringPool
+     * @brief Interned strings with a lazily computed sort rank per entry
+     */
+    struct StringPool {
+        std::vector<std::string> values;
+        std::vector<std::string> keys;       ///< Sort key of each value
+        std::unordered_map<std::string, uint32_t> lookup;
+        std::vector<uint32_t> ranks;         ///< Position of each value in key order
+
+        uint32_t intern(const std::string& value);
+        void compute_ranks();
+        size_t memory_bytes() const;
+    };
+
+    Database* database;
+
+    mutable std::shared_mutex catalog_mutex;
+    mutable std::atomic<bool> ranks_dirty{false};
+    std::atomic<uint64_t> generation{0};
+    std::unordered_map<long, uint32_t> rows;   ///< Book ID -> row
+
+    // Columns, all indexed by row
+    std::vector<long> ids;
+    std::vector<std::string> titles;
+    std::vector<std::string> title_keys;
+    std::vector<uint64_t> title_prefixes;      ///< First 8 bytes of the title key, big-endian
+    std::vector<uint32_t> author_ids;
+    std::vector<uint32_t> publisher_ids;
+    std::vector<uint32_t> language_ids;
+    std::vector<uint8_t> format_codes;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> added;
+
+    mutable StringPool authors;
+    mutable StringPool publishers;
+    StringPool languages;
+
+    void apply_locked(const CatalogRow& row);
+    void remove_locked(long book_id);
+    void ensure_ranks() const;
+
+    static uint64_t key_prefix(const std::string& key);
+    static uint8_t format_code(const std::string& file_type);
+    static std::string format_timestamp(int64_t seconds);
+};
+
+#endif // BOOK_CATALOG_H
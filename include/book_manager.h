@@ -11,6 +11,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 #include <minizip/unzip.h>
 
@@ -46,6 +47,16 @@ struct BookInfo {
     std::string extraction_error; ///< Error message if extraction failed
 };
 
+/**
+ * @struct ArchiveEntryRange
+ * @brief Location of an entry's compressed data inside a ZIP-based book file
+ */
+struct ArchiveEntryRange {
+    std::string name;           ///< Entry path inside the archive
+    uint64_t offset = 0;        ///< Byte offset of the compressed data in the archive file
+    uint64_t length = 0;        ///< Compressed size in bytes
+};
+
 /**
  * @class BookManager
  * @brief Manages book file operations and metadata extraction
@@ -177,6 +188,13 @@ public:
                                  const std::vector<unsigned char>& cover_image,
                                  const std::string& output_path);
 
+    /**
+     * @brief Picks the thumbnail file extension for a cover image
+     * @param cover_format MIME type of the cover, empty if there is none
+     * @return ".jpg", ".png", or ".svg" for the placeholder when there is no cover
+     */
+    static std::string thumbnail_extension(const std::string& cover_format);
+
     /**
      * @brief Gets the thumbnail directory path
      * @return Path to thumbnails directory
@@ -211,6 +229,49 @@ public:
      */
     static void extract_cover_image_from_epub(unzFile epub_file, const std::string& opf_path, BookMetadata& metadata);
 
+    /**
+     * @brief Lists the page images of a comic book archive in reading order
+     * @param file_path Path to the CBZ file
+     * @return Entry names of image files, naturally sorted (page2 before page10)
+     * @throws std::runtime_error if the archive cannot be opened
+     */
+    static std::vector<std::string> list_archive_pages(const std::string& file_path);
+
+    /**
+     * @brief Reads (inflates) a single entry from a ZIP-based book file
+     * @param file_path Path to the EPUB/CBZ file
+     * @param entry_name Entry path inside the archive
+     * @return Entry content
+     * @throws std::runtime_error if the archive or entry cannot be read
+     */
+    static std::string read_archive_entry(const std::string& file_path, const std::string& entry_name);
+
+    /**
+     * @brief Determines the MIME type of an image entry from its name
+     * @param entry_name Entry or file name
+     * @return MIME type, application/octet-stream if unknown
+     */
+    static std::string get_image_content_type(const std::string& entry_name);
+
+    /**
+     * @brief Lists the chapters of an EPUB in spine (reading) order
+     * @param file_path Path to the EPUB file
+     * @return Archive entry paths of the spine documents
+     * @throws std::runtime_error if the archive or its OPF cannot be read
+     */
+    static std::vector<std::string> list_epub_chapters(const std::string& file_path);
+
+    /**
+     * @brief Finds where entries' compressed bytes live in the archive file
+     *
+     * Used to issue readahead hints for exactly the bytes a later read will touch.
+     * @param file_path Path to the EPUB/CBZ file
+     * @param entry_names Entries to locate
+     * @return Ranges for the entries that were found (missing entries are skipped)
+     */
+    static std::vector<ArchiveEntryRange> locate_archive_entries(const std::string& file_path,
+                                                                 const std::vector<std::string>& entry_names);
+
 private:
     std::string thumbnails_directory; ///< Directory where thumbnails are stored
 };
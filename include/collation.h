@@ -0,0 +1,61 @@
+/**
+ * @file collation.h
+ * @brief Binary sort keys for mixed Korean/English titles and names
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include <string>
+#include <cstdint>
+
+/**
+ * @class Collation
+ * @brief Computes byte strings whose memcmp order is the browsing order
+ *
+ * Keys are computed once when a book is stored and compared as plain bytes
+ * (BYTEA in PostgreSQL, std::string in memory), so no database collation
+ * is involved. Rules:
+ * - Case and Latin accents are ignored; punctuation and symbols are skipped.
+ * - A leading English article ("The", "A", "An") is ignored.
+ * - Digit runs compare by numeric value ("Vol. 2" before "Vol. 10").
+ * - Latin letters sort before Hangul. Hangul syllables compare jamo by jamo
+ *   (initial, medial, final), and a bare consonant such as "ㄱ" sorts just
+ *   before the syllables that start with it.
+ * - Other characters sort by code point after Hangul.
+ */
+class Collation {
+public:
+    /**
+     * @brief Version of the key format, stored as the first byte of sort_key()
+     *
+     * Stored keys with a different version are recomputed at startup.
+     */
+    static constexpr uint8_t VERSION = 1;
+
+    /**
+     * @brief Computes the primary key (equal for case/accent/punctuation variants)
+     * @param text UTF-8 text
+     * @return Binary key
+     */
+    static std::string primary_key(const std::string& text);
+
+    /**
+     * @brief Computes the full sort key
+     * @param text UTF-8 text
+     * @return VERSION byte, primary key, then the text itself as a tie-breaker
+     */
+    static std::string sort_key(const std::string& text);
+
+    /**
+     * @brief Hex-encodes a key for decode(..., 'hex') in SQL
+     * @param key Binary key
+     * @return Lowercase hex string
+     */
+    static std::string to_hex(const std::string& key);
+};
+
+#endif // COLLATION_H
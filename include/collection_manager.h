@@ -19,8 +19,11 @@
 #include <vector>
 #include <memory>
 #include <optional>
+#include <mutex>
 #include <pqxx/pqxx>
 #include <nlohmann/json.hpp>
+#include "pg_pipeline.h"
+#include "invalidation_bus.h"
 
 /**
  * @brief Enumeration of permission types for collection access
@@ -55,6 +58,43 @@ struct Collection {
     std::string updated_at;          ///< Last modification timestamp
     std::vector<int> book_ids;       ///< List of book IDs in this collection
     int book_count;                  ///< Number of books in collection
+    bool is_smart = false;           ///< Membership is maintained from SmartRules
+};
+
+/**
+ * @brief Rules of a smart collection
+ * 
+ * A book belongs to the collection when it satisfies every rule that is
+ * set; list rules match any of their values. Empty lists and zero/false
+ * values mean "no restriction".
+ */
+struct SmartRules {
+    std::vector<std::string> authors;     ///< Any of these authors (case-insensitive)
+    std::vector<std::string> languages;   ///< Any of these language codes
+    std::vector<std::string> file_types;  ///< Any of these file types (epub, pdf, cbz)
+    int added_within_days = 0;            ///< Added in the last N days
+    bool unread = false;                  ///< Not yet opened by the collection owner
+
+    /**
+     * @brief Serialize for the collections.smart_rules column
+     * @return JSON object with only the rules that are set
+     */
+    nlohmann::json toJson() const;
+
+    /**
+     * @brief Parse rules from JSON
+     * @param json JSON object as produced by toJson()
+     * @return Parsed rules
+     */
+    static SmartRules fromJson(const nlohmann::json& json);
+};
+
+/**
+ * @brief One page of a cursor-paginated collection listing
+ */
+struct CollectionPage {
+    std::vector<Collection> collections;   ///< Collections on this page
+    std::string next_cursor;               ///< Cursor for the next page, empty on the last page
 };
 
 /**
@@ -105,11 +145,15 @@ public:
     /**
      * @brief Constructor
      * @param connection Shared database connection
+     * @param batch_connection Connection for statements sent as one pipelined batch
+     * @param invalidation_bus Bus to announce collection changes on (may be nullptr)
      * 
      * Initializes the collection manager with a database connection.
      * The connection should be established and ready for use.
      */
-    explicit CollectionManager(std::shared_ptr<pqxx::connection> connection);
+    CollectionManager(std::shared_ptr<pqxx::connection> connection,
+                      std::shared_ptr<PgPipeline> batch_connection,
+                      InvalidationBus* invalidation_bus = nullptr);
 
     /**
      * @brief Destructor
@@ -176,6 +220,51 @@ public:
      */
     bool deleteCollection(int collection_id, int user_id);
 
+    // ========== Smart Collections ==========
+
+    /**
+     * @brief Create a rule-based collection
+     * @param owner_id User ID of the collection owner
+     * @param name Collection name (must be unique per user)
+     * @param rules Membership rules
+     * @param description Optional description of the collection
+     * @param is_public Whether the collection should be publicly visible
+     * @return Collection ID on success, -1 on failure
+     * 
+     * Membership is materialized into collection_books right away and then
+     * kept up to date by refreshSmartMembership(), so reading a smart
+     * collection costs the same as reading a manual one.
+     */
+    int createSmartCollection(int owner_id, const std::string& name, const SmartRules& rules,
+                              const std::string& description = "", bool is_public = false);
+
+    /**
+     * @brief Replace the rules of a smart collection and rebuild its membership
+     * @param collection_id Smart collection to update
+     * @param user_id User performing the update (needs EDIT permission)
+     * @param rules New membership rules
+     * @return true on success, false on failure
+     */
+    bool updateSmartRules(int collection_id, int user_id, const SmartRules& rules);
+
+    /**
+     * @brief Get the rules of a smart collection
+     * @param collection_id Collection identifier
+     * @return Rules, or nullopt if the collection is not smart
+     */
+    std::optional<SmartRules> getSmartRules(int collection_id);
+
+    /**
+     * @brief Re-evaluate one book against every smart collection
+     * @param book_id Book that was added, changed or opened
+     * 
+     * Adds the book to smart collections whose rules it now satisfies and
+     * removes it from those it no longer does. Call after ingest, metadata
+     * changes and a book's first progress save (later page turns can't change
+     * "unread" rules); deletions are handled by ON DELETE CASCADE.
+     */
+    void refreshSmartMembership(int book_id);
+
     // ========== Collection Discovery ==========
 
     /**
@@ -208,9 +297,32 @@ public:
      * 
      * Returns publicly visible collections for discovery.
      * Results are ordered by creation date (newest first).
+     * Deep offsets get slower; prefer getPublicCollectionsPage().
      */
     std::vector<Collection> getPublicCollections(int limit = 50, int offset = 0);
 
+    /**
+     * @brief Get a page of public collections by cursor
+     * @param limit Maximum number of collections to return
+     * @param cursor next_cursor of the previous page, empty for the first page
+     * @return Collections plus the cursor of the following page
+     * 
+     * Keyset pagination over (created_at, id): every page is an index range
+     * scan on the public collections index, so page 500 costs the same as page 1.
+     * Malformed cursors are treated as the first page; validate user input
+     * with parsePageCursor() first.
+     */
+    CollectionPage getPublicCollectionsPage(int limit = 50, const std::string& cursor = "");
+
+    /**
+     * @brief Validates and splits a cursor returned by getPublicCollectionsPage()
+     * @param cursor Cursor to parse
+     * @param created_at Receives the creation timestamp of the last row
+     * @param id Receives the ID of the last row
+     * @return true if the cursor is well formed
+     */
+    static bool parsePageCursor(const std::string& cursor, std::string& created_at, int& id);
+
     /**
      * @brief Search collections by name
      * @param query Search term
@@ -234,7 +346,8 @@ public:
      * @return true on success, false on failure
      * 
      * Adds a book to the specified collection. Requires ADD_BOOKS permission
-     * or higher. Prevents duplicate additions of the same book.
+     * or higher. Prevents duplicate additions of the same book. Not allowed
+     * for smart collections.
      */
     bool addBookToCollection(int collection_id, int book_id, int user_id);
 
@@ -246,7 +359,8 @@ public:
      * @return true on success, false on failure
      * 
      * Removes a book from the collection. Requires ADD_BOOKS permission
-     * or higher, or the user must be the one who added the book.
+     * or higher, or the user must be the one who added the book. Not allowed
+     * for smart collections.
      */
     bool removeBookFromCollection(int collection_id, int book_id, int user_id);
 
@@ -362,6 +476,17 @@ public:
 
 private:
     std::shared_ptr<pqxx::connection> db_connection; ///< Database connection
+    std::recursive_mutex connection_mutex;           ///< Serializes use of db_connection across threads
+    std::shared_ptr<PgPipeline> pipeline;            ///< Pipelined batches (separate connection)
+    InvalidationBus* invalidations;                  ///< Change events for other instances (not owned)
+
+    /**
+     * @brief Announce a change to other server instances when txn commits
+     * @param txn Transaction making the change
+     * @param kind Event kind ("collection" or "collection_books")
+     * @param fields Event fields
+     */
+    void notifyChange(pqxx::work& txn, const std::string& kind, const nlohmann::json& fields);
 
     /**
      * @brief Check if user has required permission level
@@ -390,6 +515,45 @@ private:
      * Internal helper to maintain updated_at timestamps.
      */
     void updateCollectionTimestamp(int collection_id);
+
+    /**
+     * @brief Build the shared SELECT used by all collection listings
+     * @param preview_limit Number of most recent book IDs per collection, 0 for all
+     * @return Query text to be followed by WHERE/ORDER BY clauses
+     * 
+     * Book counts and book ID previews come from one lateral aggregate, so a
+     * listing is a single round trip regardless of how many collections it returns.
+     */
+    static std::string collectionListQuery(int preview_limit);
+
+    /**
+     * @brief Decode a row of collectionListQuery() into a Collection
+     * @param row Result row
+     * @return Collection object
+     */
+    static Collection collectionFromRow(const pqxx::row& row);
+
+    /**
+     * @brief Rebuild the membership of one smart collection from its rules
+     * @param txn Open transaction
+     * @param collection_id Smart collection
+     */
+    static void materializeSmartCollection(pqxx::work& txn, int collection_id);
+
+    /**
+     * @brief Drop books that aged out of an added-within rule
+     * @param txn Open transaction
+     * @param collection_id Collection about to be read
+     */
+    static void expireSmartMembership(pqxx::work& txn, int collection_id);
+
+    /**
+     * @brief Check whether a collection is rule-based
+     * @param txn Open transaction
+     * @param collection_id Collection identifier
+     * @return true if the collection has smart rules
+     */
+    static bool isSmartCollection(pqxx::work& txn, int collection_id);
 };
 
 #endif // COLLECTION_MANAGER_H
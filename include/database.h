@@ -11,7 +11,62 @@
 
 #include <pqxx/pqxx>
 #include <string>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <nlohmann/json.hpp>
+#include "pg_pipeline.h"
+#include "replica_set.h"
+#include "invalidation_bus.h"
+
+/**
+ * @struct BookFacetRow
+ * @brief Facet attributes of one book
+ */
+struct BookFacetRow {
+    long id;
+    std::string language;
+    std::string file_type;
+};
+
+/**
+ * @struct BookTagRow
+ * @brief One tag assignment
+ */
+struct BookTagRow {
+    long book_id;
+    std::string tag;
+};
+
+/**
+ * @struct ProgressFacetRow
+ * @brief Reading state of one book for one user
+ */
+struct ProgressFacetRow {
+    long user_id;
+    long book_id;
+    double percent;
+};
+
+/**
+ * @struct CatalogRow
+ * @brief Listing attributes of one book for the in-memory catalog
+ */
+struct CatalogRow {
+    long id;
+    std::string title;
+    std::string author;
+    std::string publisher;
+    std::string language;
+    std::string file_type;
+    long file_size;
+    long uploaded_at;   ///< Seconds since the epoch
+};
 
 /**
  * @class Database
@@ -19,36 +74,72 @@
  * 
  * This class provides a centralized interface for all database operations
  * including user management, book management, and progress tracking.
+ *
+ * With standbys configured, book listings, book lookups and progress
+ * reads go to a standby whose staleness is within a bound (see
+ * ReplicaSet), everything else to the primary. Reads that must see the
+ * caller's own writes stay on the primary: a user's progress and
+ * listings for a while after that user saved progress, and every book
+ * read for a while after books were added or removed.
+ *
+ * Writes of books, tags and progress also announce themselves on the
+ * InvalidationBus, inside their transaction, so other server instances
+ * can drop what they cached. Events from other instances extend the
+ * read-your-writes rules above to writes made there.
  */
 class Database {
 private:
     std::unique_ptr<pqxx::connection> conn; ///< PostgreSQL connection object
+    mutable std::recursive_mutex conn_mutex; ///< Serializes use of conn across HTTP and background threads
+    std::unique_ptr<PgPipeline> pipeline;   ///< Second connection for pipelined batches
+    std::unique_ptr<ReplicaSet> replicas;   ///< Standbys for reads, nullptr if none are configured
+    InvalidationBus* invalidations;         ///< Change events for other instances (not owned), may be nullptr
+    int schema_version = 0;                 ///< Applied by SchemaMigrator at startup
+
+    std::mutex pin_mutex;                                                   ///< Guards user_writes and user_ids
+    std::unordered_map<long, std::chrono::steady_clock::time_point> user_writes;   ///< Last progress write per user
+    std::unordered_map<std::string, long> user_ids;                         ///< Usernames seen by get_user_id
+    std::atomic<int64_t> library_written_at{0};                            ///< steady_clock ticks of the last book write
+    std::function<void(const std::vector<int>&)> books_removed_listener;   ///< Set once at startup, may be empty
+
+    std::vector<PgPipeline::Result> run_read(const std::vector<PgPipeline::Statement>& statements,
+                                             double max_staleness_seconds, bool needs_primary);
+    void note_user_write(long user_id);
+    bool user_pinned(long user_id);
+    bool user_pinned_locked(long user_id);
+    void note_library_write();
+    bool library_pinned() const;
+    void notify(pqxx::work& txn, const std::string& kind, const nlohmann::json& fields);
+    void on_remote_change(const nlohmann::json& event);
 
 public:
     /**
      * @brief Constructor that establishes database connection
      * @param connection_string PostgreSQL connection string
+     * @param replica_connection_strings Connection strings of streaming-replication standbys for reads
+     * @param invalidation_bus Bus to announce writes on and to hear other instances' writes from
      * @throws std::runtime_error if connection fails
      */
-    explicit Database(const std::string& connection_string);
+    explicit Database(const std::string& connection_string,
+                      const std::vector<std::string>& replica_connection_strings = {},
+                      InvalidationBus* invalidation_bus = nullptr);
     
     /**
      * @brief Destructor
      */
     ~Database() = default;
 
-    /**
-     * @brief Creates all necessary database tables if they don't exist
-     * @throws std::runtime_error if table creation fails
-     */
-    void create_tables_if_not_exists();
-
     /**
      * @brief Creates prepared statements for database operations
      * @throws std::runtime_error if statement preparation fails
      */
     void prepare_statements();
 
+    /**
+     * @brief Computes missing or outdated title/author collation keys
+     */
+    void refresh_sort_keys();
+
     /**
      * @brief Creates a new user in the database
      * @param username Unique username for the user
@@ -87,6 +178,7 @@ public:
      * @param page_count Number of pages (optional)
      * @param metadata_extracted Whether metadata was extracted successfully
      * @param extraction_error Error message if metadata extraction failed
+     * @param uploaded_by ID of the uploading user, -1 for books found by a scan
      * @return Book ID of the newly added book
      * @throws std::runtime_error if book addition fails
      */
@@ -96,7 +188,15 @@ public:
                   const std::string& publisher = "", const std::string& isbn = "",
                   const std::string& language = "en", const std::string& thumbnail_path = "",
                   int page_count = 0, bool metadata_extracted = false,
-                  const std::string& extraction_error = "");
+                  const std::string& extraction_error = "", long uploaded_by = -1);
+
+    /**
+     * @brief Sets the thumbnail of a book added without one
+     * @param book_id ID of the book
+     * @param thumbnail_path Path to the thumbnail image
+     * @return true on success, false on failure
+     */
+    bool set_book_thumbnail(long book_id, const std::string& thumbnail_path);
 
     /**
      * @brief Retrieves book ID by file path
@@ -105,6 +205,14 @@ public:
      */
     long get_book_id(const std::string& file_path);
 
+    /**
+     * @brief Loads the paths of all known books under a directory in one query
+     * @param root Directory prefix (empty for all books)
+     * @param paths Receives the file paths
+     * @return true on success, false on failure
+     */
+    bool get_known_book_paths(const std::string& root, std::unordered_set<std::string>& paths);
+
     /**
      * @brief Updates or inserts user reading progress for a book
      * @param user_id ID of the user
@@ -116,11 +224,34 @@ public:
                                    const nlohmann::json& progress_details);
 
     /**
-     * @brief Retrieves all books and their progress for a user
+     * @brief Updates or inserts reading progress from already validated JSON text
      * @param user_id ID of the user
+     * @param book_id ID of the book
+     * @param progress_json JSON object text, stored as sent (see ProgressJson)
+     * @return true if this is the user's first progress on the book
+     * @throws std::runtime_error if progress update fails
+     */
+    bool update_user_book_progress_raw(long user_id, long book_id, const std::string& progress_json);
+
+    /**
+     * @brief Retrieves all books and their progress for a user
+     * @param username Name of the user
+     * @param user_id Receives the user's ID, -1 if there is no such user
+     * @param order_by "recent" (last read first), "title" or "author"
      * @return JSON array containing books and progress information
+     * @throws std::runtime_error if the query fails
+     *
+     * The user lookup and the listing go out as one pipelined batch.
+     */
+    nlohmann::json get_user_books_with_progress(const std::string& username, long& user_id,
+                                                const std::string& order_by = "recent");
+
+    /**
+     * @brief Runs independent statements in one round trip (see PgPipeline)
+     * @param statements Statements, sent in order
+     * @return One result per statement
      */
-    nlohmann::json get_user_books_with_progress(long user_id);
+    std::vector<PgPipeline::Result> run_batch(const std::vector<PgPipeline::Statement>& statements);
 
     /**
      * @brief Get user's reading progress for a specific book
@@ -132,9 +263,17 @@ public:
 
     /**
      * @brief Retrieves all books in the library
+     * @param order_by "uploaded" (newest first), "title" or "author"
      * @return JSON array containing all books information
      */
-    nlohmann::json get_all_books();
+    nlohmann::json get_all_books(const std::string& order_by = "uploaded");
+
+    /**
+     * @brief Retrieves a single book by ID
+     * @param book_id ID of the book
+     * @return JSON object with book information, or null if not found
+     */
+    nlohmann::json get_book_by_id(long book_id);
 
     /**
      * @brief Checks if database connection is valid
@@ -142,17 +281,98 @@ public:
      */
     bool is_connected() const;
 
+    /**
+     * @brief Gets the schema version the database was migrated to at startup
+     */
+    int get_schema_version() const;
+
+    /**
+     * @brief Gets standby routing statistics
+     * @return JSON object with statistics, null if no standbys are configured
+     */
+    nlohmann::json get_replica_stats();
+
     /**
      * @brief Finds books in database where file doesn't exist on disk
+     * @param root Only consider books under this directory (empty for all)
      * @return Vector of book IDs that are orphaned
      */
-    std::vector<int> find_orphaned_book_ids();
+    std::vector<int> find_orphaned_book_ids(const std::string& root = "");
 
     /**
      * @brief Removes orphaned books from database
+     * @param root Only consider books under this directory (empty for all)
      * @return Number of orphaned books removed
      */
-    int cleanup_orphaned_books();
+    int cleanup_orphaned_books(const std::string& root = "");
+
+    /**
+     * @brief Registers a callback for books deleted by cleanup_orphaned_books
+     * @param listener Receives the IDs of the deleted books after the commit
+     */
+    void set_books_removed_listener(std::function<void(const std::vector<int>&)> listener);
+
+    /**
+     * @brief Saves (replaces) the checkpoint of a library scan
+     * @param root Scanned directory
+     * @param state Serialized scan position and counters
+     * @return true on success, false on failure
+     */
+    bool save_scan_checkpoint(const std::string& root, const nlohmann::json& state);
+
+    /**
+     * @brief Loads the checkpoint of an unfinished library scan
+     * @param root Scanned directory
+     * @return Saved state, or null if the last scan of root completed
+     */
+    nlohmann::json load_scan_checkpoint(const std::string& root);
+
+    /**
+     * @brief Removes the checkpoint once a scan completes
+     * @param root Scanned directory
+     */
+    void clear_scan_checkpoint(const std::string& root);
+
+    /**
+     * @brief Gets the tags of a book
+     * @param book_id ID of the book
+     * @return Tag names, sorted (empty on error)
+     */
+    std::vector<std::string> get_book_tags(long book_id);
+
+    /**
+     * @brief Replaces the tags of a book
+     * @param book_id ID of the book
+     * @param tags New tag names
+     * @return true on success, false on failure
+     */
+    bool set_book_tags(long book_id, const std::vector<std::string>& tags);
+
+    /**
+     * @brief Checks whether a user may change a book's shared metadata (tags)
+     * @param book_id ID of the book
+     * @param user_id ID of the user
+     * @return true for the uploader of the book and for administrators
+     */
+    bool can_edit_book(long book_id, long user_id);
+
+    /**
+     * @brief Loads books, tags and reading progress for the facet index in one transaction
+     * @param books Receives the facet attributes of every book, ordered by ID
+     * @param tags Receives every tag assignment
+     * @param progress Receives every progress record
+     * @return true on success, false on failure
+     */
+    bool load_facet_rows(std::vector<BookFacetRow>& books, std::vector<BookTagRow>& tags,
+                         std::vector<ProgressFacetRow>& progress);
+
+    /**
+     * @brief Loads listing attributes for the in-memory catalog
+     * @param rows Receives the rows, ordered by ID
+     * @param book_id Only this book (default: -1, all books)
+     * @return true on success, false on failure
+     */
+    bool load_catalog_rows(std::vector<CatalogRow>& rows, long book_id = -1);
 };
 
 #endif // DATABASE_H
@@ -0,0 +1,136 @@
+/**
+ * @file facet_index.h
+ * @brief In-memory bitmap index for faceted library filtering
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FACET_INDEX_H
+#define FACET_INDEX_H
+
+#include "roaring_bitmap.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+class Database;
+
+/**
+ * @class FacetIndex
+ * @brief Answers tag x language x format x read-state filters from bitmaps
+ *
+ * Every book gets a dense ordinal; each facet value (a tag, a language, a
+ * file type) maps to a RoaringBitmap of ordinals, and each user has bitmaps
+ * of the books they started and finished. A query ORs the selected values
+ * within a facet, ANDs across facets, and counts every facet value against
+ * the selection of the *other* facets, so the UI can show how many books
+ * each further click would leave.
+ *
+ * The index is built from the database at startup and then updated by the
+ * server as books, tags and reading progress change.
+ */
+class FacetIndex {
+public:
+    /**
+     * @struct Query
+     * @brief Selected facet values
+     */
+    struct Query {
+        std::map<std::string, std::vector<std::string>> filters;   ///< Facet name -> accepted values
+        long user_id = -1;                                          ///< Whose read state to use
+    };
+
+    /**
+     * @struct Result
+     * @brief Matching books and per-value counts
+     */
+    struct Result {
+        std::vector<long> book_ids;                                      ///< Newest first
+        std::map<std::string, std::map<std::string, uint64_t>> counts;   ///< Facet -> value -> books
+    };
+
+    /**
+     * @brief Constructor
+     * @param db Database the index is built from
+     */
+    explicit FacetIndex(Database* db);
+
+    /**
+     * @brief Rebuilds the whole index from the database
+     * @return true on success (the old index is kept on failure)
+     */
+    bool rebuild();
+
+    /**
+     * @brief Adds or updates a book
+     * @param book_id ID of the book
+     * @param language Language code
+     * @param file_type File type (epub, pdf, cbz)
+     */
+    void add_book(long book_id, const std::string& language, const std::string& file_type);
+
+    /**
+     * @brief Replaces the tags of a book
+     * @param book_id ID of the book
+     * @param tags Normalized tag names
+     */
+    void set_tags(long book_id, const std::vector<std::string>& tags);
+
+    /**
+     * @brief Records reading progress
+     * @param user_id ID of the user
+     * @param book_id ID of the book
+     * @param percent Progress percentage (100 = finished)
+     */
+    void set_progress(long user_id, long book_id, double percent);
+
+    /**
+     * @brief Runs a faceted query
+     * @param query Selected values per facet
+     * @return Matching books and counts for every facet value
+     */
+    Result query(const Query& query) const;
+
+    /**
+     * @brief Gets index size statistics
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats() const;
+
+    /**
+     * @brief Trims, lowercases and deduplicates tag names
+     * @param tags Raw tag names
+     * @return Valid tags (1-100 characters), sorted
+     */
+    static std::vector<std::string> normalize_tags(const std::vector<std::string>& tags);
+
+private:
+    using ValueMap = std::unordered_map<std::string, RoaringBitmap>;
+
+    struct UserState {
+        RoaringBitmap started;    ///< Books with any progress
+        RoaringBitmap finished;   ///< Books at 100%
+    };
+
+    Database* database;
+
+    mutable std::shared_mutex index_mutex;
+    std::unordered_map<long, uint32_t> ordinals;   ///< Book ID -> ordinal
+    std::vector<long> book_ids;                    ///< Ordinal -> book ID
+    RoaringBitmap all_books;
+    ValueMap tags;
+    ValueMap languages;
+    ValueMap formats;
+    std::unordered_map<long, UserState> users;
+
+    uint32_t ordinal_locked(long book_id);
+    static void assign_value(ValueMap& values, const std::string& value, uint32_t ordinal);
+    std::map<std::string, RoaringBitmap> read_state_bitmaps(long user_id) const;
+};
+
+#endif // FACET_INDEX_H
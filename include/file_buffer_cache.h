@@ -0,0 +1,90 @@
+/**
+ * @file file_buffer_cache.h
+ * @brief Memory cache of small immutable files served over HTTP
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FILE_BUFFER_CACHE_H
+#define FILE_BUFFER_CACHE_H
+
+#include <string>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+class FileIoBackend;
+
+/**
+ * @class FileBufferCache
+ * @brief LRU cache of whole files held as shared, immutable buffers
+ *
+ * Thumbnails and transcoded pages are small files that get requested over
+ * and over. A hit hands out another reference to the same buffer, which
+ * the response writes straight to the socket (see
+ * HttpServer::send_buffer), so it costs a stat(2) and no allocation or
+ * copy. Entries are revalidated against size and mtime on every lookup,
+ * so a regenerated file is picked up immediately.
+ */
+class FileBufferCache {
+public:
+    using Buffer = std::shared_ptr<const std::string>;
+
+    /**
+     * @brief Constructor
+     * @param file_io Backend used to read files on a miss
+     * @param budget_bytes Maximum total size of cached files
+     * @param max_file_bytes Larger files are read but not cached
+     */
+    FileBufferCache(FileIoBackend* file_io, size_t budget_bytes = 64 * 1024 * 1024,
+                    size_t max_file_bytes = 4 * 1024 * 1024);
+
+    /**
+     * @brief Returns the content of a file, reading it on a miss
+     * @param path File to read
+     * @return File content, or nullptr if the file cannot be read
+     */
+    Buffer get(const std::string& path);
+
+    /**
+     * @brief Drops a file from the cache
+     * @param path File path
+     */
+    void invalidate(const std::string& path);
+
+    /**
+     * @brief Gets hit/miss counters and memory usage
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats();
+
+private:
+    struct Entry {
+        Buffer data;
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    FileIoBackend* file_io;
+    size_t budget;
+    size_t max_file_size;
+    size_t used_bytes = 0;
+
+    std::mutex cache_mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru;    ///< Most recently used first
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+
+    void erase_locked(std::unordered_map<std::string, Entry>::iterator it);
+};
+
+#endif // FILE_BUFFER_CACHE_H
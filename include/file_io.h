@@ -0,0 +1,184 @@
+/**
+ * @file file_io.h
+ * @brief Batched file read backends (io_uring with pread thread pool fallback)
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef FILE_IO_H
+#define FILE_IO_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @struct FileReadRequest
+ * @brief A single read: a byte range of a file, or the whole file
+ */
+struct FileReadRequest {
+    std::string path;      ///< File to read
+    uint64_t offset = 0;   ///< Start offset in bytes
+    size_t length = 0;     ///< Bytes to read, 0 = until end of file
+    bool borrow = false;   ///< Result may stay in a registered buffer; read it via bytes() and drop it soon
+};
+
+/**
+ * @struct FileReadResult
+ * @brief Outcome of a FileReadRequest
+ */
+struct FileReadResult {
+    bool ok = false;       ///< Whether the read succeeded
+    std::string data;      ///< Bytes read (may be shorter than requested at EOF), unless held in buffer
+    std::string error;     ///< Error message if the read failed
+    std::shared_ptr<const char> buffer;   ///< Registered buffer holding the bytes of a borrowed read
+    size_t buffer_size = 0;               ///< Bytes in buffer
+
+    /**
+     * @brief The bytes read, wherever they ended up
+     * @return View valid as long as this result
+     */
+    std::string_view bytes() const {
+        return buffer ? std::string_view(buffer.get(), buffer_size) : std::string_view(data);
+    }
+};
+
+/**
+ * @class FileIoBackend
+ * @brief Interface for reading many small files or ranges in parallel
+ *
+ * Thumbnail, file and static asset reads go through this interface so that a
+ * batch of reads costs as few syscalls as the platform allows.
+ */
+class FileIoBackend {
+public:
+    virtual ~FileIoBackend() = default;
+
+    /**
+     * @brief Reads a batch of files/ranges
+     * @param requests Reads to perform
+     * @return One result per request, in the same order
+     */
+    virtual std::vector<FileReadResult> read_batch(const std::vector<FileReadRequest>& requests) = 0;
+
+    /**
+     * @brief Gets the backend name for logging
+     * @return "io_uring" or "pread"
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Reads a whole file
+     * @param path File to read
+     * @param borrow Allow the result to stay in a registered buffer (see FileReadRequest::borrow)
+     * @return Read result
+     */
+    FileReadResult read_file(const std::string& path, bool borrow = false);
+
+    /**
+     * @brief Creates the best available backend
+     * @param backend "auto", "io_uring" or "pread"
+     * @param threads Worker threads for the pread backend
+     * @return Backend instance; falls back to pread if io_uring is unavailable
+     */
+    static std::unique_ptr<FileIoBackend> create(const std::string& backend = "auto", size_t threads = 4);
+};
+
+/**
+ * @class PreadPoolBackend
+ * @brief Portable backend: a fixed thread pool issuing pread(2)
+ */
+class PreadPoolBackend : public FileIoBackend {
+public:
+    /**
+     * @brief Constructor
+     * @param thread_count Number of worker threads
+     */
+    explicit PreadPoolBackend(size_t thread_count);
+
+    /**
+     * @brief Destructor - joins worker threads
+     */
+    ~PreadPoolBackend() override;
+
+    std::vector<FileReadResult> read_batch(const std::vector<FileReadRequest>& requests) override;
+    const char* name() const override { return "pread"; }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex tasks_mutex;
+    std::condition_variable tasks_cv;
+    bool stopping = false;
+
+    void worker_loop();
+};
+
+#ifdef MYLIBRARY_HAVE_LIBURING
+
+struct io_uring;
+
+/**
+ * @class IoUringBackend
+ * @brief io_uring backend with batched submissions and registered buffers
+ *
+ * A single ring thread owns the ring. Callers enqueue whole batches; the
+ * ring thread turns every queued request (from all callers) into SQEs and
+ * submits them with one io_uring_submit. Files are opened and sized with
+ * IORING_OP_OPENAT and IORING_OP_STATX, so the ring thread never blocks
+ * on a slow mount. Reads go straight into the result string. Borrowed
+ * reads that fit a slot of the registered buffer pool use
+ * IORING_OP_READ_FIXED instead, and the slot itself is handed to the
+ * caller (FileReadResult::buffer); it returns to the pool when released.
+ */
+class IoUringBackend : public FileIoBackend {
+public:
+    /**
+     * @brief Constructor
+     * @param queue_depth Ring size (max operations in flight)
+     * @throws std::runtime_error if the ring cannot be set up or lacks OPENAT/STATX
+     */
+    explicit IoUringBackend(unsigned queue_depth = 256);
+
+    /**
+     * @brief Destructor - stops the ring thread and tears down the ring
+     */
+    ~IoUringBackend() override;
+
+    std::vector<FileReadResult> read_batch(const std::vector<FileReadRequest>& requests) override;
+    const char* name() const override { return "io_uring"; }
+
+private:
+    struct Batch;
+    struct Operation;
+    struct BufferPool;
+
+    std::unique_ptr<io_uring> ring;
+    unsigned depth;
+
+    // Registered buffer pool, shared with the results that borrow a slot
+    static constexpr size_t FIXED_BUFFER_SIZE = 256 * 1024;
+    std::shared_ptr<BufferPool> buffer_pool;
+    bool buffers_registered = false;
+
+    std::thread ring_thread;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<std::shared_ptr<Batch>> pending_batches;
+    std::atomic<bool> stopping{false};
+
+    void ring_loop();
+};
+
+#endif // MYLIBRARY_HAVE_LIBURING
+
+#endif // FILE_IO_H
@@ -11,9 +11,23 @@
 
 #include <httplib.h>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "database.h"
 #include "book_manager.h"
-#include "library_scanner.h"
+#include "collection_manager.h"
+#include "facet_index.h"
+#include "book_catalog.h"
+#include "router.h"
+#include "scan_scheduler.h"
+#include "transfer_engine.h"
+#include "file_io.h"
+#include "file_buffer_cache.h"
+#include "static_bundle.h"
+#include "readahead_engine.h"
+#include "page_transcoder.h"
+#include "prewarm_service.h"
+#include "invalidation_bus.h"
 
 /**
  * @class HttpServer
@@ -28,10 +42,28 @@
 class HttpServer {
 private:
     httplib::Server server;                    ///< HTTP server instance
+    Router router;                             ///< API routes (segment trie, no std::regex)
     std::unique_ptr<Database> database;        ///< Database connection
     std::unique_ptr<BookManager> book_manager; ///< Book file manager
-    std::unique_ptr<LibraryScanner> library_scanner; ///< Library scanner for background operations
+    std::unique_ptr<CollectionManager> collection_manager; ///< Collections; keeps smart collections current
+    std::unique_ptr<FacetIndex> facet_index;   ///< Tag/language/format/read-state bitmaps
+    std::unique_ptr<BookCatalog> catalog;      ///< Columnar copy of book listings for sorting
+    std::unique_ptr<FileIoBackend> file_io;    ///< Batched file reads (io_uring or pread pool)
+    std::unique_ptr<InflatedEntryCache> entry_cache; ///< Inflated EPUB/CBZ entries shared by all readers
+    std::unique_ptr<FileBufferCache> file_cache;    ///< Thumbnails and transcoded pages held in memory
+    std::unique_ptr<StaticBundle> static_bundle;    ///< Web frontend, preloaded and precompressed
+    std::unique_ptr<ReadaheadEngine> readahead;     ///< Prefetches upcoming pages/chapters per reader
+    std::unique_ptr<PageTranscoder> page_transcoder; ///< Resized JPEG/WebP comic pages
+    std::unique_ptr<PrewarmService> prewarm;        ///< Background warming of newly added books
+    // Declared after the components above so their threads stop first on destruction
+    std::unique_ptr<ScanScheduler> scan_scheduler;   ///< One library scanner per library root
+    std::unique_ptr<TransferEngine> transfer_engine; ///< Event-driven streaming for file routes
+    std::unique_ptr<InvalidationBus> invalidation_bus; ///< Writes of other instances; its handlers use the above
+    std::mutex snapshot_mutex;
+    uint64_t snapshot_version = 0;             ///< Catalog version the snapshots below belong to
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> catalog_snapshots; ///< Serialized catalog responses by query
     int port;                                  ///< Server port
+    int stream_port;                           ///< Streaming port (0 = disabled)
 
     /**
      * @brief Sets up all API routes and handlers
@@ -65,6 +97,32 @@ private:
      */
     void send_success(httplib::Response& res, const nlohmann::json& data);
 
+    /**
+     * @brief Sends a shared, immutable buffer as the response body
+     * @param res HTTP response object
+     * @param buffer Body, kept alive until the response is written
+     * @param content_type Content-Type header value
+     *
+     * The buffer is written to the socket from a content provider, so
+     * cached bodies are never copied into res.body.
+     */
+    void send_buffer(httplib::Response& res, std::shared_ptr<const std::string> buffer,
+                     const std::string& content_type);
+
+    /**
+     * @brief Serves a file of the web frontend from the static bundle
+     * @param req HTTP request (GET or HEAD)
+     * @param res HTTP response
+     * @return false if the bundle has nothing for the path
+     */
+    bool serve_static(const httplib::Request& req, httplib::Response& res);
+
+    /**
+     * @brief Updates the in-memory indexes after another instance's write
+     * @param event InvalidationBus event
+     */
+    void apply_remote_change(const nlohmann::json& event);
+
     // Route handlers
     
     /**
@@ -119,6 +177,28 @@ private:
      */
     void handle_list_books(const httplib::Request& req, httplib::Response& res);
 
+    /**
+     * @brief Handles sorted and filtered catalog listings
+     * @param req HTTP request (GET /api/books/catalog)
+     * @param res HTTP response
+     *
+     * Query parameters: sort (title, author, size, date), order (asc, desc),
+     * format, language, author, min_size, max_size, offset, limit (1-500).
+     * Served from memory without a database round trip.
+     */
+    void handle_catalog(const httplib::Request& req, httplib::Response& res);
+
+    /**
+     * @brief Handles discovery of public collections
+     * @param req HTTP request (GET /api/collections/public?limit=&cursor=)
+     * @param res HTTP response
+     *
+     * Newest first, limit 1-100 (default 50). The response carries
+     * next_cursor, to be passed as cursor for the following page; it is
+     * empty on the last page. Unknown or malformed cursors give the first page.
+     */
+    void handle_public_collections(const httplib::Request& req, httplib::Response& res);
+
     /**
      * @brief Handles requests to update reading progress
      * @param req HTTP request (PUT /api/books/{book_id}/progress)
@@ -132,36 +212,134 @@ private:
      *   "last_position": "string",
      *   "notes": "string"
      * }
+     *
+     * The body must be a JSON object; it is validated with ProgressJson and
+     * stored without being re-serialized. The response only echoes the
+     * book ID.
      */
-    void handle_update_progress(const httplib::Request& req, httplib::Response& res);
+    void handle_update_progress(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
 
     /**
      * @brief Handles requests to get reading progress
      * @param req HTTP request (GET /api/books/{book_id}/progress)
      * @param res HTTP response
      */
-    void handle_get_progress(const httplib::Request& req, httplib::Response& res);
+    void handle_get_progress(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
+
+    /**
+     * @brief Handles faceted book filtering
+     * @param req HTTP request (GET /api/books/facets?tag=&language=&format=&read_state=)
+     * @param res HTTP response
+     *
+     * Each parameter may be repeated; values of one facet are ORed and
+     * facets are ANDed. The response carries the matching book IDs and,
+     * for every facet value, how many books it would match.
+     */
+    void handle_book_facets(const httplib::Request& req, httplib::Response& res);
+
+    /**
+     * @brief Handles requests to get the tags of a book
+     * @param req HTTP request (GET /api/books/{book_id}/tags)
+     * @param res HTTP response
+     */
+    void handle_get_book_tags(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
+
+    /**
+     * @brief Handles requests to replace the tags of a book
+     * @param req HTTP request (PUT /api/books/{book_id}/tags)
+     * @param res HTTP response
+     *
+     * Expected JSON body:
+     * {
+     *   "tags": ["string"]
+     * }
+     */
+    void handle_set_book_tags(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
 
     /**
      * @brief Handles requests to download book files
      * @param req HTTP request (GET /api/books/{book_id}/download)
      * @param res HTTP response
      */
-    void handle_book_download(const httplib::Request& req, httplib::Response& res);
+    void handle_book_download(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
 
     /**
      * @brief Handles requests to access book files for reading
      * @param req HTTP request (GET /api/books/{book_id}/file)
      * @param res HTTP response
      */
-    void handle_book_file_access(const httplib::Request& req, httplib::Response& res);
+    void handle_book_file_access(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
     
     /**
      * @brief Handles requests to access book thumbnails
      * @param req HTTP request (GET /api/books/{book_id}/thumbnail)
      * @param res HTTP response
      */
-    void handle_book_thumbnail(const httplib::Request& req, httplib::Response& res);
+    void handle_book_thumbnail(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
+
+    /**
+     * @brief Swaps a stored thumbnail for a resized copy from the transcode cache
+     * @param book_id ID of the book
+     * @param width Requested width (?w=)
+     * @param format Requested format (?format=)
+     * @param accept Accept header of the request
+     * @param thumbnail_path In: stored thumbnail; out: resized file on success
+     * @param content_type In: stored type; out: resized type on success
+     * @return true if the thumbnail was replaced by a resized copy
+     */
+    bool resize_thumbnail(long book_id, int width, const std::string& format, const std::string& accept,
+                          std::string& thumbnail_path, std::string& content_type);
+
+    /**
+     * @brief Handles requests for a single page image of a comic archive
+     * @param req HTTP request (GET /api/books/{book_id}/pages/{page}[?w=800&format=webp])
+     * @param res HTTP response
+     */
+    void handle_book_page(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
+
+    /**
+     * @brief Handles requests for a single chapter document of an EPUB
+     * @param req HTTP request (GET /api/books/{book_id}/chapters/{chapter})
+     * @param res HTTP response
+     */
+    void handle_book_chapter(const httplib::Request& req, httplib::Response& res, const RouteParams& params);
+
+    /**
+     * @brief Builds the response for a comic page (shared by HTTP and streaming paths)
+     * @param book_id ID of the book
+     * @param page_index Zero-based page index
+     * @param username Reader requesting the page (keys the readahead session)
+     * @param width Target width for a transcoded page, 0 = original image
+     * @param format Requested output format (?format=), empty = negotiate from Accept
+     * @param accept Accept header of the request
+     * @return Transfer target carrying the page image (or a transcoded file) or an error body
+     */
+    TransferTarget resolve_book_page(long book_id, long page_index, const std::string& username,
+                                     int width = 0, const std::string& format = "",
+                                     const std::string& accept = "");
+
+    /**
+     * @brief Builds the response for an EPUB chapter (shared by HTTP and streaming paths)
+     * @param book_id ID of the book
+     * @param chapter_index Zero-based index into the spine
+     * @param username Reader requesting the chapter (keys the readahead session)
+     * @return Transfer target carrying the chapter XHTML or an error body
+     */
+    TransferTarget resolve_book_chapter(long book_id, long chapter_index, const std::string& username);
+
+    /**
+     * @brief Resolves a request arriving on the streaming port
+     * @param request Parsed request head
+     * @return File or body to send back
+     * 
+     * Runs on TransferEngine worker threads. Serves:
+     * - GET /api/books/{book_id}/download
+     * - GET /api/books/{book_id}/file
+     * - GET /api/books/{book_id}/thumbnail
+     * - GET /api/books/{book_id}/pages/{page}
+     * - GET /api/books/{book_id}/chapters/{chapter}
+     */
+    TransferTarget resolve_stream_request(const TransferRequest& request);
 
     /**
      * @brief Handles requests to cleanup orphaned book records
@@ -172,20 +350,20 @@ private:
 
     /**
      * @brief Handles requests to start library synchronization scan
-     * @param req HTTP request (POST /api/library/sync-scan)
+     * @param req HTTP request (POST /api/library/sync-scan[?root=PATH])
      * @param res HTTP response
      */
     void handle_sync_scan(const httplib::Request& req, httplib::Response& res);
 
     /**
      * @brief Start regular library scan (finds new books only)
-     * @param req HTTP request (POST /api/library/scan)
+     * @param req HTTP request (POST /api/library/scan[?root=PATH])
      * @param res HTTP response
      */
     void handle_library_scan(const httplib::Request& req, httplib::Response& res);
 
     /**
-     * @brief Handles requests to get scan status
+     * @brief Handles requests to get scan status (combined and per library root)
      * @param req HTTP request (GET /api/library/scan-status)
      * @param res HTTP response
      */
@@ -193,7 +371,7 @@ private:
 
     /**
      * @brief Handles requests to stop current scan
-     * @param req HTTP request (POST /api/library/scan-stop)
+     * @param req HTTP request (POST /api/library/scan-stop[?root=PATH])
      * @param res HTTP response
      */
     void handle_stop_scan(const httplib::Request& req, httplib::Response& res);
@@ -232,10 +410,20 @@ public:
      * @param db_connection_string PostgreSQL connection string
      * @param books_directory Directory for storing book files
      * @param server_port Port for the HTTP server
+     * @param streaming_port Port for the event-driven file streaming engine (0 disables it)
+     * @param io_backend File read backend: "auto", "io_uring" or "pread"
+     * @param library_roots Additional directories to scan (books_directory is always scanned)
+     * @param web_directory Built web frontend, loaded into memory at startup
+     * @param db_replica_connection_strings Streaming-replication standbys for reads (see Database)
      */
     HttpServer(const std::string& db_connection_string, 
                const std::string& books_directory,
-               int server_port = 8080);
+               int server_port = 8080,
+               int streaming_port = 0,
+               const std::string& io_backend = "auto",
+               const std::vector<LibraryRoot>& library_roots = {},
+               const std::string& web_directory = "./web",
+               const std::vector<std::string>& db_replica_connection_strings = {});
 
     /**
      * @brief Destructor
@@ -258,6 +446,12 @@ public:
      * @return Server port number
      */
     int get_port() const { return port; }
+
+    /**
+     * @brief Gets the port the streaming engine is running on
+     * @return Streaming port number, 0 if disabled
+     */
+    int get_stream_port() const { return stream_port; }
 };
 
 #endif // HTTP_SERVER_H
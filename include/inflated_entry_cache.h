@@ -0,0 +1,121 @@
+/**
+ * @file inflated_entry_cache.h
+ * @brief Shared cache of inflated EPUB/CBZ archive entries
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef INFLATED_ENTRY_CACHE_H
+#define INFLATED_ENTRY_CACHE_H
+
+#include <string>
+#include <memory>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+/**
+ * @class InflatedEntryCache
+ * @brief Memory-bounded cache of decompressed archive members, shared by all readers
+ *
+ * Entries are keyed by (fingerprint of the book file, entry path), so a book
+ * replaced or rewritten on disk never serves stale pages. The fingerprint is
+ * a SHA-256 over the file's device, inode, size and mtime plus its first and
+ * last 64 KiB. It is memoized per path and recomputed when any of those stat
+ * fields change; the memo keeps at most one path per cached entry plus a
+ * small slack, least recently used first out.
+ *
+ * Eviction is GreedyDual-Size: every entry is ranked by
+ * (clock + inflate_cost / size). Cheap-to-rebuild or huge entries leave first,
+ * recently used entries are protected by the aging clock, which makes this
+ * behave like LRU when costs are equal.
+ *
+ * Concurrent misses on the same entry inflate it once; other callers wait
+ * for that result.
+ */
+class InflatedEntryCache {
+public:
+    using Buffer = std::shared_ptr<const std::string>;
+
+    /**
+     * @brief Constructor
+     * @param budget_bytes Maximum total size of cached entries
+     */
+    explicit InflatedEntryCache(size_t budget_bytes = 256 * 1024 * 1024);
+
+    /**
+     * @brief Returns an entry, inflating and caching it on a miss
+     * @param archive_path Path to the EPUB/CBZ file
+     * @param entry_name Entry path inside the archive
+     * @return Inflated entry content
+     * @throws std::runtime_error if the archive or entry cannot be read
+     */
+    Buffer get_or_inflate(const std::string& archive_path, const std::string& entry_name);
+
+    /**
+     * @brief Checks whether an entry is cached without touching its rank
+     * @param archive_path Path to the EPUB/CBZ file
+     * @param entry_name Entry path inside the archive
+     * @return true if the entry is cached
+     */
+    bool contains(const std::string& archive_path, const std::string& entry_name);
+
+    /**
+     * @brief Gets hit/miss counters and memory usage
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats();
+
+private:
+    struct Entry {
+        Buffer data;
+        double priority = 0;
+        uint64_t cost_us = 0;     ///< Time it took to inflate
+    };
+
+    struct Fingerprint {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+        std::string hash;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    size_t budget;
+    size_t used_bytes = 0;
+    double clock = 0;             ///< GreedyDual aging value (priority of the last victim)
+
+    std::mutex cache_mutex;
+    std::condition_variable inflight_cv;
+    std::unordered_map<std::string, Entry> entries;
+    std::set<std::pair<double, std::string>> eviction_order;
+    std::unordered_set<std::string> inflight;    ///< Keys being inflated right now
+
+    // Guarded by cache_mutex as well
+    std::unordered_map<std::string, Fingerprint> fingerprints;
+    std::list<std::string> fingerprint_lru;      ///< Paths, most recently used first
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+
+    /**
+     * @brief Gets the content fingerprint of a book file
+     * @throws std::runtime_error if the file cannot be read
+     */
+    std::string fingerprint(const std::string& archive_path);
+
+    void touch(const std::string& key, Entry& entry);
+    void trim_fingerprints();
+    void insert(const std::string& key, Buffer data, uint64_t cost_us);
+};
+
+#endif // INFLATED_ENTRY_CACHE_H
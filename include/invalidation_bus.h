@@ -0,0 +1,115 @@
+/**
+ * @file invalidation_bus.h
+ * @brief Cross-instance cache invalidation over PostgreSQL LISTEN/NOTIFY
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-18
+ */
+
+#ifndef INVALIDATION_BUS_H
+#define INVALIDATION_BUS_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <nlohmann/json.hpp>
+
+struct pg_conn;
+
+/**
+ * @class InvalidationBus
+ * @brief Tells every server instance on the same database what changed
+ *
+ * Write paths add a NOTIFY to their own transaction (see payload()), so
+ * the event goes out exactly when the change commits and never for a
+ * rolled back one. A listener thread on its own connection receives the
+ * events of all instances and hands each one to the subscribers, which
+ * evict or reload the affected cache entries.
+ *
+ * Events are JSON objects with an "origin" (the sending instance) and a
+ * "kind":
+ * - "book" {id}: a book was added or changed
+ * - "books_removed" {ids}: books were deleted
+ * - "library": too much changed to list, reload everything
+ * - "book_tags" {id}: the tags of a book changed
+ * - "progress" {user_id, book_id, percent}: reading progress was saved
+ * - "collection" {id}: a collection, its books or its permissions changed
+ * - "collection_books" {book_id}: smart collection membership of a book changed
+ *
+ * An instance's own events are dropped, its write paths update its caches
+ * directly. Notifications sent while the listener was not listening are
+ * lost, so every time LISTEN succeeds (the first connect included)
+ * subscribers get a "resync" event instead.
+ */
+class InvalidationBus {
+public:
+    static constexpr const char* CHANNEL = "mylibrary_invalidate";
+
+    using Handler = std::function<void(const nlohmann::json& event)>;
+
+    /**
+     * @brief Starts the listener thread
+     * @param connection_string libpq connection string of the primary
+     *
+     * The listener connects in the background and keeps reconnecting, so
+     * this never fails.
+     */
+    explicit InvalidationBus(const std::string& connection_string);
+
+    /**
+     * @brief Destructor - stops the listener
+     */
+    ~InvalidationBus();
+
+    InvalidationBus(const InvalidationBus&) = delete;
+    InvalidationBus& operator=(const InvalidationBus&) = delete;
+
+    /**
+     * @brief Random identifier of this instance
+     */
+    const std::string& origin() const { return origin_id; }
+
+    /**
+     * @brief Builds the NOTIFY payload of an event
+     * @param kind Event kind
+     * @param fields Event fields
+     * @return Payload for pg_notify(CHANNEL, payload)
+     */
+    std::string payload(const std::string& kind, nlohmann::json fields = nlohmann::json::object()) const;
+
+    /**
+     * @brief Registers a handler, called on the listener thread
+     * @param handler Receives every event from other instances
+     */
+    void subscribe(Handler handler);
+
+    /**
+     * @brief Gets listener statistics
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats() const;
+
+private:
+    std::string connection_string;
+    std::string origin_id;
+
+    mutable std::mutex handlers_mutex;
+    std::vector<Handler> handlers;
+
+    std::thread listener;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> connected{false};
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> own{0};
+    std::atomic<uint64_t> malformed{0};
+    std::atomic<uint64_t> reconnects{0};
+
+    void listen_loop();
+    pg_conn* connect(std::string& error);
+    void dispatch(const nlohmann::json& event);
+};
+
+#endif // INVALIDATION_BUS_H
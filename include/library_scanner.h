@@ -16,10 +16,23 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <functional>
+#include <condition_variable>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
 
 class Database;
 class BookManager;
 
+/**
+ * @struct ScanLimits
+ * @brief Per-root scanning resources
+ */
+struct ScanLimits {
+    int concurrency = 1;          ///< Files processed in parallel (1-64)
+    int files_per_second = 100;   ///< Max files processed per second, 0 for unlimited
+};
+
 /**
  * @struct ScanStatus
  * @brief Current scanning operation status with orphaned cleanup info
@@ -32,6 +45,7 @@ struct ScanStatus {
     int processed_books = 0;
     int orphaned_cleaned = 0;  // 정리된 고아 레코드 수
     int books_found = 0;       // NEW: 새로 발견된 도서 수
+    bool resumed = false;      ///< Continued from a saved checkpoint
     std::vector<std::string> errors;
     std::chrono::system_clock::time_point start_time;
 };
@@ -42,21 +56,93 @@ struct ScanStatus {
  */
 class LibraryScanner {
 private:
+    /**
+     * @struct ScanFrame
+     * @brief One directory on the path from the scan root to the current directory
+     */
+    struct ScanFrame {
+        std::string dir;                ///< Directory path
+        std::string identity;           ///< "device:inode", to detect symlinks back into an ancestor
+        bool files_done = false;        ///< All book files of dir processed
+        std::string last_file;          ///< Last processed file of dir, empty if none
+        std::string last_subdir;        ///< Last subdirectory entered, empty if none
+    };
+    
+    /**
+     * @struct ScanCursor
+     * @brief Resumable position of a scan, persisted as a checkpoint
+     *
+     * The tree is walked depth first in sorted order: a directory's files,
+     * then its subdirectories. The stack of directories from the root down,
+     * each with the last file and subdirectory done, identifies everything
+     * already scanned, so a checkpoint grows with the depth of the tree, not
+     * its size. Names are compared rather than positions, so files added or
+     * removed while the scan was stopped don't shift the resume point.
+     */
+    struct ScanCursor {
+        static constexpr int VERSION = 3;
+        
+        bool cleanup_orphaned = false;
+        bool orphans_cleaned = false;
+        std::vector<ScanFrame> stack;   ///< Root first, directory being scanned last
+        int discovered = 0;
+        int processed = 0;
+        int books_found = 0;
+        int orphaned_cleaned = 0;
+        std::vector<std::string> errors;
+        
+        nlohmann::json to_json() const;
+        static ScanCursor from_json(const nlohmann::json& state);
+    };
+    
+    static constexpr int CHECKPOINT_EVERY_FILES = 100;
+    static constexpr std::chrono::seconds CHECKPOINT_INTERVAL{10};
+    static constexpr size_t MAX_CHECKPOINT_ERRORS = 100;
+    
     std::thread worker_thread;
     std::atomic<bool> is_scanning{false};
     std::atomic<bool> should_stop{false};
+    std::atomic<bool> discard_on_stop{false};
     std::atomic<int> current_progress{0};
     std::atomic<int> total_books{0};
     std::atomic<int> processed_books{0};
     std::atomic<int> orphaned_cleaned{0};  // 정리된 고아 레코드 카운터
     std::atomic<int> books_found{0};       // NEW: 새로 발견된 도서 카운터
+    std::atomic<bool> resumed{false};
     std::string current_book_name;
     std::vector<std::string> error_log;
     mutable std::mutex progress_mutex;
     std::chrono::system_clock::time_point scan_start_time;
+    std::chrono::steady_clock::time_point last_checkpoint_time;
+    int files_since_checkpoint = 0;
     
     Database* database;
     BookManager* book_manager;
+    ScanLimits limits;
+    std::unordered_set<std::string> known_paths;  ///< Books already in the database under this root
+    bool known_paths_loaded = false;              ///< Otherwise each file is looked up on its own
+    std::function<void(long)> on_book_added;  ///< Called with the ID of every newly added book
+    std::function<void()> on_books_removed;   ///< Called after orphaned records were deleted
+    
+    // File workers: concurrency - 1 threads kept for the scanner's lifetime,
+    // sharing each chunk with the scan thread
+    std::vector<std::thread> file_workers;
+    std::mutex chunk_mutex;
+    std::condition_variable chunk_cv;         ///< New chunk or shutdown
+    std::condition_variable chunk_done_cv;    ///< Last file of a chunk finished
+    const std::vector<std::string>* chunk_files = nullptr;
+    size_t chunk_next = 0;                    ///< Next unclaimed file of the chunk
+    size_t chunk_limit = 0;                   ///< One past the last file of the chunk
+    size_t chunk_active = 0;                  ///< Files claimed by workers and not finished yet
+    bool workers_stopping = false;
+    
+    void file_worker_loop();
+    
+    /**
+     * @brief Processes book_files[begin, end) on the scan thread and the file workers
+     * @return once every file of the range is done
+     */
+    void run_chunk(const std::vector<std::string>& book_files, size_t begin, size_t end);
     
     /**
      * @brief Worker thread function for scanning
@@ -65,6 +151,34 @@ private:
      */
     void scan_worker(const std::string& books_directory, bool cleanup_orphaned);
     
+    /**
+     * @brief Processes the remaining files of the directory on top of the cursor's stack
+     * @param books_directory Scan root (checkpoint key)
+     * @param book_files Sorted book files of that directory
+     * @param cursor Scan position, advanced per file
+     * @return false if the scan was asked to stop
+     */
+    bool process_directory(const std::string& books_directory,
+                           const std::vector<std::string>& book_files, ScanCursor& cursor);
+    
+    /**
+     * @brief Adds one book file to the database if it is new (errors go to the scan log)
+     * @param book_path Path to the book file
+     */
+    void process_book_file(const std::string& book_path);
+    
+    /**
+     * @brief Persists the cursor and counters for this scan root
+     * @param books_directory Scan root (checkpoint key)
+     * @param cursor Scan position
+     */
+    void save_checkpoint(const std::string& books_directory, ScanCursor& cursor);
+    
+    /**
+     * @brief Frees the known path set once a scan ends
+     */
+    void release_known_paths();
+    
     /**
      * @brief Update scanning progress (thread-safe)
      * @param current Current book index
@@ -78,8 +192,9 @@ public:
      * @brief Constructor
      * @param db Database instance
      * @param bm BookManager instance
+     * @param scan_limits Concurrency and throttle for this scanner
      */
-    LibraryScanner(Database* db, BookManager* bm);
+    LibraryScanner(Database* db, BookManager* bm, ScanLimits scan_limits = {});
     
     /**
      * @brief Destructor - ensures proper cleanup
@@ -95,16 +210,28 @@ public:
     
     /**
      * @brief Start scanning with file system synchronization
+     *
+     * If an earlier scan of the same directory was stopped or interrupted,
+     * it continues from its checkpoint instead of starting over.
      * @param books_directory Directory containing book files
      * @param cleanup_orphaned Whether to cleanup orphaned records (default: true)
+     * @param restart Discard any checkpoint and walk the whole tree again
      * @return true if scan started successfully, false if already scanning
      */
-    bool start_sync_scan(const std::string& books_directory, bool cleanup_orphaned = true);
+    bool start_sync_scan(const std::string& books_directory, bool cleanup_orphaned = true, bool restart = false);
+    
+    /**
+     * @brief Resumes a scan of this directory that was interrupted by a restart
+     * @param books_directory Directory containing book files
+     * @return true if a checkpoint was found and the scan restarted
+     */
+    bool resume_interrupted_scan(const std::string& books_directory);
     
     /**
      * @brief Request scan operation to stop
+     * @param discard_checkpoint Drop the progress instead of keeping it as a checkpoint
      */
-    void stop_scan();
+    void stop_scan(bool discard_checkpoint = false);
     
     /**
      * @brief Get current scanning status (thread-safe)
@@ -118,6 +245,18 @@ public:
      */
     bool is_scan_active() const { return is_scanning.load(); }
     
+    /**
+     * @brief Registers a callback for books added by a scan (runs on the scan thread)
+     * @param callback Receives the new book ID
+     */
+    void set_book_added_callback(std::function<void(long)> callback) { on_book_added = std::move(callback); }
+    
+    /**
+     * @brief Registers a callback for scans that deleted orphaned records (runs on the scan thread)
+     * @param callback Called once per scan that removed at least one book
+     */
+    void set_books_removed_callback(std::function<void()> callback) { on_books_removed = std::move(callback); }
+    
     /**
      * @brief Cleanup orphaned records only (no file scanning)
      * @return Number of orphaned records cleaned
@@ -0,0 +1,173 @@
+/**
+ * @file page_transcoder.h
+ * @brief Downscaling and re-encoding of comic pages for small screens
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef PAGE_TRANSCODER_H
+#define PAGE_TRANSCODER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_set>
+#include <unordered_map>
+#include <list>
+#include <cstdint>
+
+/**
+ * @class PageTranscoder
+ * @brief Produces resized JPEG/WebP versions of CBZ pages and keeps them in a disk cache
+ *
+ * Scanned comic pages are often multi-megabyte PNGs; a phone needs a fraction
+ * of that. Requested widths are snapped to a few buckets so the cache stays
+ * small, pages are never upscaled, and results are stored as
+ * `<cache_dir>/<book_id>/<page>_<width>.<ext>`. A cached file older than the
+ * book file is regenerated. Cover thumbnails are resized the same way into
+ * `<cache_dir>/<book_id>/cover_<width>.<ext>`.
+ *
+ * The directory is bounded: past the size cap the least recently served
+ * files are deleted. After a restart, files start out ordered by when they
+ * were written. Removed books take their files with them (remove_book()).
+ * Sources larger than a fixed pixel budget are refused before decoding.
+ *
+ * Pipeline: decode (libjpeg with DCT prescaling / libpng) -> separable
+ * triangle-filter resample (SSE2 vertical pass) -> encode (libjpeg, or
+ * libwebp when built with it).
+ */
+class PageTranscoder {
+public:
+    using SourceLoader = std::function<std::shared_ptr<const std::string>()>;
+
+    /**
+     * @struct Output
+     * @brief A transcoded page on disk
+     */
+    struct Output {
+        std::string file_path;      ///< Cached file to serve
+        std::string content_type;   ///< image/jpeg or image/webp
+    };
+
+    /**
+     * @brief Constructor
+     * @param cache_dir Directory for transcoded pages (created if missing)
+     * @param max_cache_bytes Size cap of the directory
+     */
+    explicit PageTranscoder(const std::string& cache_dir, uint64_t max_cache_bytes = 2ull * 1024 * 1024 * 1024);
+
+    /**
+     * @brief Gets (transcoding on a miss) a resized page
+     * @param book_id ID of the book
+     * @param page_index Zero-based page index
+     * @param archive_path Path to the CBZ file (used to detect stale cache files)
+     * @param width Requested width in pixels (snapped to a bucket)
+     * @param format "jpeg" or "webp" (already negotiated)
+     * @param load_source Returns the original page bytes; only called on a miss
+     * @return Cached output file
+     * @throws std::runtime_error if the page cannot be decoded or encoded
+     */
+    Output get_page(long book_id, long page_index, const std::string& archive_path,
+                    int width, const std::string& format, const SourceLoader& load_source);
+
+    /**
+     * @brief Gets (resizing on a miss) a cover thumbnail at another size
+     * @param book_id ID of the book
+     * @param thumbnail_path Stored full-size thumbnail
+     * @param width Requested width in pixels (snapped to a thumbnail bucket)
+     * @param format "jpeg" or "webp" (already negotiated)
+     * @param load_source Returns the stored thumbnail bytes; only called on a miss
+     * @return Cached output file
+     * @throws std::runtime_error if the thumbnail cannot be decoded or encoded
+     */
+    Output get_thumbnail(long book_id, const std::string& thumbnail_path,
+                         int width, const std::string& format, const SourceLoader& load_source);
+
+    /**
+     * @brief Deletes every cached file of a book
+     * @param book_id ID of the removed book
+     */
+    void remove_book(long book_id);
+
+    /**
+     * @brief Snaps a requested width to the nearest cached size at or above it
+     * @param requested Requested width in pixels
+     * @return Bucket width
+     */
+    static int snap_width(int requested);
+
+    /**
+     * @brief Snaps a requested thumbnail width to a cached thumbnail size
+     * @param requested Requested width in pixels
+     * @return Bucket width
+     */
+    static int snap_thumbnail_width(int requested);
+
+    /**
+     * @brief Gets all thumbnail sizes that are cached
+     * @return Bucket widths, ascending
+     */
+    static std::vector<int> thumbnail_widths();
+
+    /**
+     * @brief Picks the output format from the request
+     * @param requested Value of ?format= ("jpeg", "webp", "auto" or empty)
+     * @param accept Accept header of the request
+     * @return "webp" or "jpeg"
+     */
+    static std::string negotiate_format(const std::string& requested, const std::string& accept);
+
+    /**
+     * @brief Checks whether WebP encoding was compiled in
+     * @return true if libwebp is available
+     */
+    static bool webp_available();
+
+private:
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> pixels;   ///< Packed RGB, 3 bytes per pixel
+    };
+
+    struct CachedFile {
+        uint64_t size = 0;
+        std::list<std::string>::iterator position;
+    };
+
+    std::string cache_directory;
+    uint64_t max_bytes;
+
+    std::mutex index_mutex;
+    std::list<std::string> recency;                        ///< Cached paths, least recently served first
+    std::unordered_map<std::string, CachedFile> index;
+    uint64_t used_bytes = 0;
+
+    std::mutex inflight_mutex;
+    std::condition_variable inflight_cv;
+    std::unordered_set<std::string> inflight;   ///< Output paths being generated
+
+    /**
+     * @brief Shared miss path: decode, resize, encode, write `<cache_dir>/<name>.<ext>`
+     */
+    Output render(const std::string& name, const std::string& source_path,
+                  int width, const std::string& format, const SourceLoader& load_source);
+
+    void load_index();
+    void note_file(const std::string& path, uint64_t size);
+    void note_hit(const std::string& path);
+    void trim_locked();
+
+    static Image decode(const std::string& data, int target_width);
+    static void decode_jpeg(const std::string& data, int target_width, Image& image);
+    static Image decode_png(const std::string& data);
+    static Image resize(const Image& source, int target_width);
+    static std::string encode_jpeg(const Image& image, int quality);
+    static std::string encode_webp(const Image& image, float quality);
+};
+
+#endif // PAGE_TRANSCODER_H
@@ -0,0 +1,102 @@
+/**
+ * @file pg_pipeline.h
+ * @brief Batches of SQL statements sent in one round trip with libpq pipeline mode
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef PG_PIPELINE_H
+#define PG_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <mutex>
+
+struct pg_conn;
+
+/**
+ * @class PgPipeline
+ * @brief Runs a batch of parameterized statements with a single network round trip
+ *
+ * libpqxx has no pipeline mode, so this owns a plain libpq connection.
+ * All statements of a batch are queued with PQsendQueryParams, followed by
+ * one PQpipelineSync, and the results are read back in order. Everything up
+ * to the sync runs in one implicit transaction: if a statement fails, the
+ * statements after it are skipped and the earlier ones are rolled back.
+ * That lets a check and the write it guards go out together, as long as
+ * the write carries the condition itself (e.g. INSERT ... WHERE NOT EXISTS).
+ *
+ * Built against a libpq older than 14 (no LIBPQ_HAS_PIPELINING), the
+ * statements are run one by one inside BEGIN/COMMIT with the same results.
+ *
+ * Batches are meant to be small (a handful of statements, small results);
+ * the connection is used in blocking mode.
+ */
+class PgPipeline {
+public:
+    /**
+     * @struct Statement
+     * @brief One statement of a batch
+     */
+    struct Statement {
+        std::string sql;                                  ///< SQL text with $1.. placeholders
+        std::vector<std::optional<std::string>> params;   ///< Text values, nullopt for NULL
+    };
+
+    /**
+     * @struct Result
+     * @brief Outcome of one statement
+     */
+    struct Result {
+        bool ok = false;
+        std::string error;                               ///< Error message if !ok
+        std::vector<std::string> columns;
+        std::vector<std::vector<std::optional<std::string>>> rows;   ///< Text values, nullopt for NULL
+        long affected_rows = 0;
+
+        /**
+         * @brief Gets a value by column name
+         * @throws std::out_of_range for unknown columns or rows
+         */
+        const std::optional<std::string>& get(size_t row, const std::string& column) const;
+    };
+
+    /**
+     * @brief Opens the connection
+     * @param connection_string libpq connection string
+     * @throws std::runtime_error if the connection fails
+     */
+    explicit PgPipeline(const std::string& connection_string);
+
+    /**
+     * @brief Destructor - closes the connection
+     */
+    ~PgPipeline();
+
+    PgPipeline(const PgPipeline&) = delete;
+    PgPipeline& operator=(const PgPipeline&) = delete;
+
+    /**
+     * @brief Runs a batch
+     * @param statements Statements, sent in order
+     * @return One result per statement, in the same order
+     */
+    std::vector<Result> run(const std::vector<Statement>& statements);
+
+    /**
+     * @brief Whether batches really are pipelined (libpq 14 or later)
+     */
+    static bool pipelined();
+
+private:
+    pg_conn* conn = nullptr;
+    std::mutex conn_mutex;
+
+    bool ensure_connected();
+    void run_pipelined(const std::vector<Statement>& statements, std::vector<Result>& results);
+    void run_sequential(const std::vector<Statement>& statements, std::vector<Result>& results);
+};
+
+#endif // PG_PIPELINE_H
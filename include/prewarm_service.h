@@ -0,0 +1,147 @@
+/**
+ * @file prewarm_service.h
+ * @brief Low-priority background warming of derived artifacts after ingest
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef PREWARM_SERVICE_H
+#define PREWARM_SERVICE_H
+
+#include <string>
+#include <deque>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+class Database;
+class BookManager;
+class FileIoBackend;
+class InflatedEntryCache;
+class PageTranscoder;
+
+/**
+ * @class PrewarmService
+ * @brief Builds thumbnails, page transcodes and archive indexes for newly added books
+ *
+ * Books are queued by the upload handler and the library scanner. A single
+ * worker thread (nice 19, idle I/O class) then prepares, per book:
+ * - A cover thumbnail if the book has none (scanned books), taken from
+ *   the EPUB cover or the first CBZ page
+ * - Cover thumbnails at every cached thumbnail size
+ * - The first few CBZ pages at the common reader widths
+ * - The archive index and spine of EPUBs, plus their first chapter
+ *
+ * The worker only runs when the server has been quiet for a short while,
+ * and is held to a CPU duty cycle and a read bandwidth budget so that a
+ * large import never competes with readers.
+ */
+class PrewarmService {
+public:
+    /**
+     * @struct Budget
+     * @brief Limits for background work
+     */
+    struct Budget {
+        double cpu_duty_cycle = 0.25;                   ///< Max fraction of wall time spent working
+        size_t bytes_per_second = 32 * 1024 * 1024;     ///< Max source bytes read per second
+        std::chrono::milliseconds quiet_period{500};    ///< Foreground idle time required before working
+        size_t first_pages = 4;                         ///< CBZ pages warmed per book
+    };
+
+    /**
+     * @brief Constructor - starts the worker thread
+     * @param db Database for book lookups and new thumbnails
+     * @param books Book manager, for the thumbnail directory
+     * @param io File reads for thumbnails
+     * @param entry_cache Cache of inflated archive entries
+     * @param transcoder Page/thumbnail transcoder
+     * @param budget Resource limits
+     */
+    PrewarmService(Database* db, BookManager* books, FileIoBackend* io, InflatedEntryCache* entry_cache,
+                   PageTranscoder* transcoder, Budget budget);
+
+    /**
+     * @brief Destructor - stops the worker thread
+     */
+    ~PrewarmService();
+
+    /**
+     * @brief Queues a newly ingested book for warming
+     * @param book_id ID of the book
+     */
+    void enqueue(long book_id);
+
+    /**
+     * @brief Records foreground traffic; warming pauses until things are quiet again
+     */
+    void note_foreground_activity();
+
+    /**
+     * @brief Stops the worker (queued books are dropped)
+     */
+    void stop();
+
+    /**
+     * @brief Gets queue and progress counters
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats();
+
+private:
+    Database* database;
+    BookManager* book_manager;
+    FileIoBackend* file_io;
+    InflatedEntryCache* entry_cache;
+    PageTranscoder* transcoder;
+    Budget budget;
+
+    std::thread worker;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<long> queue;
+    std::unordered_set<long> queued;
+    std::atomic<bool> stopping{false};
+
+    std::atomic<int64_t> last_foreground_ms{0};
+    double byte_tokens = 0;                                  ///< Read budget available right now
+    std::chrono::steady_clock::time_point last_refill;
+
+    std::atomic<uint64_t> books_warmed{0};
+    std::atomic<uint64_t> artifacts_built{0};
+    std::atomic<uint64_t> failures{0};
+
+    void worker_loop();
+    void warm_book(long book_id);
+
+    /**
+     * @brief Blocks until foreground traffic has been quiet for the quiet period
+     * @return false if the service is stopping
+     */
+    bool wait_for_quiet();
+
+    /**
+     * @brief Charges a unit of work against the budget, sleeping as needed
+     * @param elapsed Wall time the work took
+     * @param bytes_read Source bytes the work read
+     * @return false if the service is stopping
+     */
+    bool charge(std::chrono::steady_clock::duration elapsed, size_t bytes_read);
+
+    /**
+     * @brief Sleeps, waking early on stop
+     * @return false if the service is stopping
+     */
+    bool sleep_for(std::chrono::steady_clock::duration duration);
+
+    static int64_t now_ms();
+    static void lower_thread_priority();
+};
+
+#endif // PREWARM_SERVICE_H
@@ -0,0 +1,58 @@
+/**
+ * @file progress_json.h
+ * @brief Single-pass validator and field extractor for progress update bodies
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef PROGRESS_JSON_H
+#define PROGRESS_JSON_H
+
+#include <string>
+
+/**
+ * @class ProgressJson
+ * @brief Checks a PUT /api/books/{id}/progress body without building a DOM
+ *
+ * The body is walked once: the full JSON grammar is checked (including
+ * what PostgreSQL's jsonb rejects, such as \u0000 and unpaired
+ * surrogates) and the known top-level progress fields are picked up on
+ * the way. Nothing is allocated, so a validated body can be stored as is
+ * instead of being parsed into nlohmann::json and dumped again.
+ *
+ * String contents are skipped 16 bytes at a time with SSE2, looking only
+ * for quotes, backslashes and control characters; UTF-8 is checked up
+ * front by TextNormalizer, whose ASCII path is vectorized the same way.
+ */
+class ProgressJson {
+public:
+    static constexpr size_t MAX_BODY_BYTES = 64 * 1024;
+    static constexpr int MAX_DEPTH = 32;
+
+    /**
+     * @struct Fields
+     * @brief Known progress fields found at the top level of the body
+     *
+     * A field missing from the body or carrying another type stays unset.
+     */
+    struct Fields {
+        bool has_percent = false;
+        double progress_percent = 0.0;
+        bool has_page = false;
+        long page = 0;
+        bool has_chapter = false;
+        long chapter = 0;
+    };
+
+    /**
+     * @brief Validates a body and extracts the known fields
+     * @param body Request body, which must be a JSON object
+     * @param fields Receives the known fields
+     * @param error Receives a short description if the body is rejected
+     * @return true if the body is valid JSON that jsonb will accept
+     */
+    static bool scan(const std::string& body, Fields& fields, std::string& error);
+};
+
+#endif // PROGRESS_JSON_H
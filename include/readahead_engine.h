@@ -0,0 +1,100 @@
+/**
+ * @file readahead_engine.h
+ * @brief Per-session readahead for sequential page/chapter reading
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef READAHEAD_ENGINE_H
+#define READAHEAD_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "inflated_entry_cache.h"
+
+/**
+ * @class ReadaheadEngine
+ * @brief Warms the next pages/chapters of a book while the reader is on the current one
+ *
+ * Each (user, book) pair is a reading session. When a session reads entry N
+ * of an archive, the engine schedules N+1..N+window in the background:
+ * 1. posix_fadvise(WILLNEED) on the byte ranges of those entries so the
+ *    kernel (or NAS client) starts fetching them from cold storage
+ * 2. The entries are inflated into the shared InflatedEntryCache so the
+ *    next page turn is served without touching the archive at all
+ *
+ * The window grows while the session keeps reading forward and collapses
+ * to one entry on random access (e.g. jumping via the table of contents).
+ */
+class ReadaheadEngine {
+public:
+    /**
+     * @brief Constructor
+     * @param entry_cache Cache that receives pre-inflated entries
+     * @param max_window Maximum number of entries to read ahead
+     */
+    explicit ReadaheadEngine(InflatedEntryCache& entry_cache, size_t max_window = 4);
+
+    /**
+     * @brief Destructor - stops the background worker
+     */
+    ~ReadaheadEngine();
+
+    /**
+     * @brief Records that a session read an entry and schedules readahead
+     * @param session_key Identifies the reader and book (e.g. "username:book_id")
+     * @param archive_path Path to the EPUB/CBZ file
+     * @param entries All entries in reading order (pages or spine items)
+     * @param index Index of the entry that was just served
+     */
+    void on_access(const std::string& session_key, const std::string& archive_path,
+                   const std::vector<std::string>& entries, size_t index);
+
+    /**
+     * @brief Stops the background worker (pending readahead is dropped)
+     */
+    void stop();
+
+private:
+    struct Session {
+        std::string archive_path;
+        size_t last_index = 0;
+        size_t window = 1;
+        std::chrono::steady_clock::time_point last_seen;
+    };
+
+    struct Job {
+        std::string archive_path;
+        std::vector<std::string> entries;   ///< Entries to warm, in order
+    };
+
+    InflatedEntryCache& cache;
+    size_t max_window;
+
+    std::mutex sessions_mutex;
+    std::unordered_map<std::string, Session> sessions;
+    std::chrono::steady_clock::time_point last_session_sweep;
+
+    std::thread worker;
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_cv;
+    std::deque<Job> jobs;
+    std::unordered_set<std::string> queued_keys;  ///< Entries already queued, to avoid duplicate work
+    std::atomic<bool> stopping{false};
+
+    void worker_loop();
+    void run_job(const Job& job);
+
+    static std::string queue_key(const std::string& archive_path, const std::string& entry_name);
+};
+
+#endif // READAHEAD_ENGINE_H
@@ -0,0 +1,115 @@
+/**
+ * @file replica_set.h
+ * @brief Read-only standby connections with health and lag tracking
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-18
+ */
+
+#ifndef REPLICA_SET_H
+#define REPLICA_SET_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <nlohmann/json.hpp>
+#include "pg_pipeline.h"
+
+/**
+ * @class ReplicaSet
+ * @brief Routes read-only batches to streaming-replication standbys
+ *
+ * A background thread checks every standby once per check interval:
+ * it reads the primary's current WAL position, then asks each standby
+ * whether it is in recovery, how far its replayed WAL is behind that
+ * position and how old its last replayed transaction is. A standby that
+ * has replayed everything is 0 seconds behind, otherwise it is as stale
+ * as its last replayed commit. Since the check itself ages, the staleness
+ * used for routing is that lag plus the time since the check.
+ *
+ * A standby is skipped while it is unreachable, not in recovery (a
+ * promoted or unrelated server) or staler than the caller's bound, and
+ * a failed read marks it unhealthy until the next check. Callers fall
+ * back to the primary when run() returns false.
+ */
+class ReplicaSet {
+public:
+    /**
+     * @brief Connects to the standbys and starts the health checks
+     * @param connection_strings libpq connection strings of the standbys
+     * @param primary Connection to the primary, used for its WAL position
+     * @param check_interval Time between health checks
+     *
+     * Each standby gets a few connections, opened by the first health check;
+ * standbys that can't be reached yet are retried by the following ones.
+     */
+    ReplicaSet(const std::vector<std::string>& connection_strings, PgPipeline* primary,
+               std::chrono::milliseconds check_interval = std::chrono::milliseconds(1000));
+
+    /**
+     * @brief Destructor - stops the health checks
+     */
+    ~ReplicaSet();
+
+    ReplicaSet(const ReplicaSet&) = delete;
+    ReplicaSet& operator=(const ReplicaSet&) = delete;
+
+    /**
+     * @brief Runs a read-only batch on a fresh enough standby
+     * @param statements Read-only statements
+     * @param max_staleness_seconds Largest acceptable staleness
+     * @param results Receives the results on success
+     * @return true if a standby answered every statement, false if the caller should use the primary
+     */
+    bool run(const std::vector<PgPipeline::Statement>& statements, double max_staleness_seconds,
+             std::vector<PgPipeline::Result>& results);
+
+    /**
+     * @brief Number of configured standbys
+     */
+    size_t size() const { return replicas.size(); }
+
+    /**
+     * @brief Gets health, lag and routing statistics
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats();
+
+private:
+    /**
+     * @struct Replica
+     * @brief State of one standby, guarded by state_mutex
+     */
+    struct Replica {
+        std::string connection_string;
+        std::vector<std::shared_ptr<PgPipeline>> connections;   ///< Empty until connected, shared round-robin
+        bool healthy = false;
+        std::string state = "connecting";
+        double lag_seconds = 0.0;
+        std::chrono::steady_clock::time_point checked_at;
+        uint64_t reads = 0;
+        uint64_t failures = 0;
+    };
+
+    PgPipeline* primary;
+    std::chrono::milliseconds interval;
+    std::vector<Replica> replicas;
+    std::mutex state_mutex;
+    std::atomic<uint64_t> next{0};
+    std::atomic<uint64_t> fallbacks{0};
+
+    std::thread checker;
+    std::mutex stop_mutex;
+    std::condition_variable stop_signal;
+    bool stopping = false;
+
+    void check_loop();
+    void check_all();
+};
+
+#endif // REPLICA_SET_H
@@ -0,0 +1,122 @@
+/**
+ * @file roaring_bitmap.h
+ * @brief Compressed bitmap of 32-bit integers (roaring layout)
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class RoaringBitmap
+ * @brief Set of uint32 values split into 2^16-wide chunks
+ *
+ * Each chunk keyed by the high 16 bits stores its low 16 bits either as a
+ * sorted array (up to 4096 values, 8 KiB at most) or as a 65536-bit bitmap
+ * (also 8 KiB), whichever is smaller. Sparse facets stay tiny, dense ones
+ * intersect a word at a time, and counting an intersection never
+ * materializes it.
+ */
+class RoaringBitmap {
+public:
+    /**
+     * @brief Adds a value
+     * @param value Value to add
+     */
+    void add(uint32_t value);
+
+    /**
+     * @brief Removes a value
+     * @param value Value to remove
+     */
+    void remove(uint32_t value);
+
+    /**
+     * @brief Checks membership
+     * @param value Value to look up
+     * @return true if present
+     */
+    bool contains(uint32_t value) const;
+
+    /**
+     * @brief Gets the number of values
+     * @return Cardinality
+     */
+    uint64_t cardinality() const;
+
+    /**
+     * @brief Checks whether the set is empty
+     * @return true if there are no values
+     */
+    bool empty() const { return keys.empty(); }
+
+    /**
+     * @brief Removes all values
+     */
+    void clear();
+
+    /**
+     * @brief Intersection
+     */
+    RoaringBitmap operator&(const RoaringBitmap& other) const;
+
+    /**
+     * @brief Union
+     */
+    RoaringBitmap operator|(const RoaringBitmap& other) const;
+
+    /**
+     * @brief Difference (values in this set but not in other)
+     */
+    RoaringBitmap and_not(const RoaringBitmap& other) const;
+
+    /**
+     * @brief Size of the intersection, without building it
+     * @param other Set to intersect with
+     * @return Number of common values
+     */
+    uint64_t and_cardinality(const RoaringBitmap& other) const;
+
+    /**
+     * @brief Gets all values in ascending order
+     * @return Sorted values
+     */
+    std::vector<uint32_t> to_vector() const;
+
+    /**
+     * @brief Gets the approximate heap usage
+     * @return Bytes
+     */
+    size_t memory_bytes() const;
+
+private:
+    static constexpr size_t ARRAY_MAX = 4096;     ///< Larger chunks switch to a bitmap
+    static constexpr size_t BITMAP_WORDS = 1024;  ///< 65536 bits
+
+    struct Container {
+        std::vector<uint16_t> array;   ///< Sorted low bits while small
+        std::vector<uint64_t> bits;    ///< BITMAP_WORDS words once large
+        uint32_t cardinality = 0;
+
+        bool is_bitmap() const { return !bits.empty(); }
+    };
+
+    std::vector<uint16_t> keys;          ///< Sorted high 16 bits
+    std::vector<Container> containers;   ///< Parallel to keys
+
+    static void to_bitmap(Container& container);
+    static void to_array(Container& container);
+    static void normalize(Container& container);
+    static Container intersect(const Container& a, const Container& b);
+    static Container unite(const Container& a, const Container& b);
+    static Container subtract(const Container& a, const Container& b);
+    static uint64_t intersect_count(const Container& a, const Container& b);
+};
+
+#endif // ROARING_BITMAP_H
@@ -0,0 +1,95 @@
+/**
+ * @file router.h
+ * @brief Segment trie for dispatching API requests without std::regex
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef ROUTER_H
+#define ROUTER_H
+
+#include <httplib.h>
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct RouteParams
+ * @brief Integer path parameters of a matched route, in path order
+ */
+struct RouteParams {
+    static constexpr size_t MAX_PARAMS = 4;
+
+    std::array<long, MAX_PARAMS> values{};
+    size_t count = 0;
+
+    long operator[](size_t index) const { return values[index]; }
+};
+
+/**
+ * @class Router
+ * @brief Matches request paths segment by segment against a prefix trie
+ *
+ * Patterns are literal segments plus "{name}" placeholders, which only
+ * match a run of 1-18 decimal digits and arrive in the handler already
+ * parsed (no std::stol, no exceptions). Literal segments win over
+ * placeholders. A lookup walks one trie level per path segment and
+ * compares a handful of short strings, instead of running every
+ * registered std::regex in turn.
+ *
+ * Request bodies are read by cpp-httplib after its pre-routing handler,
+ * so the server dispatches body-less methods (GET, HEAD, DELETE) from the
+ * pre-routing handler and POST/PUT from a single catch-all route.
+ */
+class Router {
+public:
+    using Handler = std::function<void(const httplib::Request&, httplib::Response&, const RouteParams&)>;
+
+    /**
+     * @brief Registers a route
+     * @param method HTTP method (GET, POST, PUT, DELETE; HEAD uses GET routes)
+     * @param pattern Path such as "/api/books/{id}/pages/{page}"
+     * @param handler Handler called with the parsed parameters
+     * @throws std::invalid_argument for unknown methods, duplicate routes or too many parameters
+     */
+    void add(const std::string& method, const std::string& pattern, Handler handler);
+
+    /**
+     * @brief Finds the handler for a request
+     * @param method HTTP method
+     * @param path Request path without query string
+     * @param params Receives the path parameters
+     * @return Handler, or nullptr if no route matches
+     */
+    const Handler* match(const std::string& method, std::string_view path, RouteParams& params) const;
+
+    /**
+     * @brief Runs the matching handler
+     * @param req HTTP request
+     * @param res HTTP response
+     * @return false if no route matches
+     */
+    bool dispatch(const httplib::Request& req, httplib::Response& res) const;
+
+private:
+    static constexpr size_t METHOD_COUNT = 4;
+
+    struct Node {
+        std::vector<std::pair<std::string, std::unique_ptr<Node>>> literals;
+        std::unique_ptr<Node> number;   ///< "{name}" child
+        std::array<Handler, METHOD_COUNT> handlers;
+    };
+
+    Node root;
+
+    static int method_index(const std::string& method);
+    static bool parse_number(std::string_view segment, long& value);
+    static const Node* find(const Node* node, std::string_view rest, RouteParams& params);
+};
+
+#endif // ROUTER_H
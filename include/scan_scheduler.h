@@ -0,0 +1,140 @@
+/**
+ * @file scan_scheduler.h
+ * @brief Parallel, independently scheduled scanning of several library roots
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef SCAN_SCHEDULER_H
+#define SCAN_SCHEDULER_H
+
+#include "library_scanner.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+class Database;
+class BookManager;
+
+/**
+ * @struct LibraryRoot
+ * @brief A directory tree that holds books, with its own scan settings
+ */
+struct LibraryRoot {
+    std::string path;
+    ScanLimits limits;
+    std::chrono::minutes interval{0};   ///< Time between scheduled scans, 0 for on-demand only
+
+    /**
+     * @brief Parses a root from the command line
+     * @param spec "PATH[:CONCURRENCY[:FILES_PER_SECOND[:INTERVAL_MINUTES]]]"
+     * @return Parsed root
+     * @throws std::invalid_argument if a numeric field is malformed
+     */
+    static LibraryRoot parse(const std::string& spec);
+};
+
+/**
+ * @class ScanScheduler
+ * @brief Owns one LibraryScanner per library root
+ *
+ * Every root scans on its own thread with its own concurrency and file
+ * rate, so a slow network mount never holds back a local disk. Roots with
+ * an interval are rescanned that long after their previous scan finished.
+ */
+class ScanScheduler {
+public:
+    /**
+     * @brief Constructor - starts the schedule thread
+     * @param db Database instance
+     * @param bm BookManager instance
+     * @param roots Library roots; duplicate paths are ignored
+     * @param on_book_added Called with the ID of every newly added book (optional)
+     * @param on_books_removed Called after a scan deleted orphaned records (optional)
+     */
+    ScanScheduler(Database* db, BookManager* bm, const std::vector<LibraryRoot>& roots,
+                  std::function<void(long)> on_book_added = nullptr,
+                  std::function<void()> on_books_removed = nullptr);
+
+    /**
+     * @brief Destructor - stops the schedule thread and all scans
+     */
+    ~ScanScheduler();
+
+    /**
+     * @brief Starts a scan of one root, or of every idle root
+     * @param root Root path, or empty for all roots
+     * @param cleanup_orphaned Whether to remove records of missing files
+     * @param restart Discard checkpoints and scan from the beginning
+     * @return Paths of the roots whose scan started
+     */
+    std::vector<std::string> start(const std::string& root, bool cleanup_orphaned, bool restart = false);
+
+    /**
+     * @brief Stops the scan of one root, or of every root
+     * @param root Root path, or empty for all roots
+     * @param discard_checkpoint Drop the progress instead of keeping a checkpoint
+     */
+    void stop_scan(const std::string& root, bool discard_checkpoint = false);
+
+    /**
+     * @brief Resumes scans that were interrupted by a restart
+     */
+    void resume_interrupted();
+
+    /**
+     * @brief Stops the schedule thread and all scans
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether a root with this path is configured
+     * @param root Root path
+     * @return true if configured
+     */
+    bool has_root(const std::string& root) const;
+
+    /**
+     * @brief Gets the status of every root
+     * @return Each root with its scan status
+     */
+    std::vector<std::pair<LibraryRoot, ScanStatus>> get_status() const;
+
+    /**
+     * @brief Combines per-root statuses into one
+     * @param statuses Per-root status list
+     * @return Combined status
+     */
+    static ScanStatus combine(const std::vector<std::pair<LibraryRoot, ScanStatus>>& statuses);
+
+    /**
+     * @brief Gets when a root is next scanned by the schedule
+     * @param root Root path
+     * @return Time of the next scheduled scan, or epoch if unscheduled
+     */
+    std::chrono::system_clock::time_point next_scheduled_scan(const std::string& root) const;
+
+private:
+    struct Entry {
+        LibraryRoot root;
+        std::unique_ptr<LibraryScanner> scanner;
+        std::chrono::steady_clock::time_point next_run;
+    };
+
+    std::vector<Entry> entries;
+    mutable std::mutex schedule_mutex;
+    std::condition_variable schedule_cv;
+    std::thread schedule_thread;
+    std::atomic<bool> stopping{false};
+
+    void schedule_loop();
+};
+
+#endif // SCAN_SCHEDULER_H
@@ -0,0 +1,85 @@
+/**
+ * @file schema_migrator.h
+ * @brief Versioned, checksummed schema migrations compiled into the server
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-18
+ */
+
+#ifndef SCHEMA_MIGRATOR_H
+#define SCHEMA_MIGRATOR_H
+
+#include <pqxx/pqxx>
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+
+/**
+ * @class SchemaMigrator
+ * @brief Brings the database schema up to the version this binary expects
+ *
+ * Migrations are numbered and applied in order. Each applied migration is
+ * recorded in schema_migrations with a SHA-256 of its SQL. On a current
+ * database, startup costs one query: the recorded versions and checksums
+ * are read and compared with the compiled-in list. A checksum mismatch
+ * means a migration was edited after it ran somewhere; that is refused
+ * rather than silently diverging.
+ *
+ * Otherwise the pending migrations run under an advisory lock, so several
+ * instances starting together apply each one once. Waiting instances poll
+ * for the lock without holding a snapshot (which would stall the holder's
+ * concurrent index builds) and re-read the history once they get it:
+ * - ordinary migrations run in one transaction together with their
+ *   schema_migrations row, with a lock timeout so a migration waiting
+ *   behind long queries doesn't queue all traffic behind it
+ * - indexes on tables that grow with the library are built with
+ *   CREATE INDEX CONCURRENTLY, outside a transaction, so reads and writes
+ *   continue while they build. An invalid index left by an interrupted
+ *   build is dropped and built again
+ *
+ * The first migrations use IF NOT EXISTS throughout, so databases set up
+ * by the table-creating setup_db.sql of earlier releases or by earlier
+ * versions of the server are adopted as is.
+ */
+class SchemaMigrator {
+public:
+    /**
+     * @struct Migration
+     * @brief One schema change
+     */
+    struct Migration {
+        int version;
+        const char* name;
+        const char* sql;
+        const char* concurrent_index;   ///< Index built by sql with CREATE INDEX CONCURRENTLY, nullptr otherwise
+    };
+
+    /**
+     * @brief Constructor
+     * @param conn Connection to migrate, not used by anything else meanwhile
+     */
+    explicit SchemaMigrator(pqxx::connection& conn);
+
+    /**
+     * @brief Applies all pending migrations
+     * @return Schema version after migrating
+     * @throws std::runtime_error if a migration fails or an applied one was changed
+     */
+    int migrate();
+
+    /**
+     * @brief The compiled-in migrations, in order
+     */
+    static const std::vector<Migration>& migrations();
+
+private:
+    pqxx::connection& conn;
+
+    std::optional<std::map<int, std::string>> load_applied();
+    bool verify(const std::map<int, std::string>& applied);
+    void apply(const Migration& migration);
+    static std::string checksum(const char* sql);
+};
+
+#endif // SCHEMA_MIGRATOR_H
@@ -0,0 +1,104 @@
+/**
+ * @file static_bundle.h
+ * @brief In-memory, precompressed copy of the built web frontend
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef STATIC_BUNDLE_H
+#define STATIC_BUNDLE_H
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+class FileIoBackend;
+
+/**
+ * @class StaticBundle
+ * @brief Serves the frontend-vite build output from memory
+ *
+ * Every file under the web directory is read once at startup. For each
+ * file the bundle keeps:
+ * - the content and, for text-like types, gzip and (when built with
+ *   brotli) brotli variants. Sibling .gz/.br files produced by the build
+ *   are used as is, otherwise the variant is compressed at load time and
+ *   kept only if it is actually smaller
+ * - an ETag per variant, derived from a SHA-256 of the content
+ * - a Cache-Control value: Vite's hashed asset names
+ *   (assets/name-XXXXXXXX.js) never change content and are cached as
+ *   immutable for a year, everything else is revalidated with the ETag
+ *
+ * Paths that don't name a file and don't look like one (no extension in
+ * the last segment, not under /api/) get index.html, so client-side routes
+ * survive a reload. After loading, the bundle is read-only and lookups
+ * need no locking.
+ */
+class StaticBundle {
+public:
+    /**
+     * @struct Variant
+     * @brief One encoding of a file
+     */
+    struct Variant {
+        std::shared_ptr<const std::string> data;   ///< nullptr if this encoding isn't available
+        std::string etag;                          ///< Quoted strong ETag
+    };
+
+    /**
+     * @struct Asset
+     * @brief A file of the bundle with all its encodings
+     */
+    struct Asset {
+        std::string content_type;
+        std::string cache_control;
+        Variant identity;
+        Variant gzip;
+        Variant brotli;
+    };
+
+    /**
+     * @brief Loads every file under a directory
+     * @param file_io Backend used to read the files
+     * @param root Web directory (the frontend-vite dist output)
+     */
+    StaticBundle(FileIoBackend* file_io, const std::string& root);
+
+    /**
+     * @brief Finds the asset for a request path, falling back to index.html
+     * @param path Decoded request path
+     * @return Asset, or nullptr if nothing should be served
+     */
+    const Asset* find(const std::string& path) const;
+
+    /**
+     * @brief Picks the smallest encoding the client accepts
+     * @param asset Asset to send
+     * @param accept_encoding Accept-Encoding header value
+     * @param encoding Receives the Content-Encoding value ("" for identity)
+     * @return Variant to send
+     */
+    static const Variant& select(const Asset& asset, const std::string& accept_encoding, std::string& encoding);
+
+    /**
+     * @brief Gets bundle size statistics
+     * @return JSON object with statistics
+     */
+    nlohmann::json get_stats() const;
+
+private:
+    std::unordered_map<std::string, Asset> assets;   ///< Keyed by "/relative/path"
+    size_t identity_bytes = 0;
+    size_t compressed_bytes = 0;
+
+    static std::string content_type_for(const std::string& path);
+    static bool is_compressible(const std::string& content_type);
+    static bool is_hashed_name(const std::string& path);
+    static std::string etag_for(const std::string& data, const char* suffix);
+    static std::shared_ptr<const std::string> gzip(const std::string& data);
+    static std::shared_ptr<const std::string> brotli(const std::string& data);
+};
+
+#endif // STATIC_BUNDLE_H
@@ -0,0 +1,207 @@
+/**
+ * @file transfer_engine.h
+ * @brief Event-driven file transfer engine for book, thumbnail and page streaming
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#ifndef TRANSFER_ENGINE_H
+#define TRANSFER_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <unordered_map>
+#include <chrono>
+#include <sys/types.h>
+
+/**
+ * @struct TransferRequest
+ * @brief Parsed HTTP request head handed to the route resolver
+ */
+struct TransferRequest {
+    std::string method;                          ///< HTTP method (GET, HEAD, ...)
+    std::string path;                            ///< Request path without query string
+    std::string query;                           ///< Raw query string (without '?')
+    std::string version;                         ///< "HTTP/1.1", "HTTP/1.0", ...
+    std::map<std::string, std::string> headers;  ///< Request headers, keys lower-cased
+
+    /**
+     * @brief Gets a header value by name
+     * @param name Header name (case-insensitive)
+     * @return Header value, empty string if not present
+     */
+    std::string header(const std::string& name) const;
+
+    /**
+     * @brief Gets a decoded query parameter by name
+     * @param name Parameter name
+     * @return Parameter value, empty string if not present
+     */
+    std::string query_param(const std::string& name) const;
+};
+
+/**
+ * @struct TransferTarget
+ * @brief What the resolver wants sent back for a request
+ *
+ * Either file_path is set and the file is streamed with sendfile(2),
+ * or an in-memory body is sent as-is: shared_body for buffers owned by a
+ * cache (archive pages, chapters), which are written without copying, or
+ * body for everything else (error payloads).
+ */
+struct TransferTarget {
+    int status = 404;                            ///< HTTP status code
+    std::string file_path;                       ///< File to stream (takes precedence over body)
+    std::string body;                            ///< In-memory response body
+    std::shared_ptr<const std::string> shared_body; ///< Cached body (takes precedence over body)
+    std::string content_type = "application/json"; ///< Content-Type header value
+    std::vector<std::pair<std::string, std::string>> headers; ///< Extra response headers
+};
+
+/**
+ * @class TransferEngine
+ * @brief Serves file downloads from a single epoll loop using non-blocking sockets and sendfile
+ *
+ * cpp-httplib dedicates a thread to every connection for its whole lifetime,
+ * so a slow client downloading a large book pins a thread for minutes. The
+ * transfer engine keeps every connection on one event loop instead:
+ * - Request heads are read and parsed on the loop thread
+ * - Route resolution (session check, database lookup, opening the file) runs
+ *   on a small worker pool so the loop never blocks on Postgres or disk
+ * - Response bodies are pushed with sendfile(2) in bounded slices whenever
+ *   the socket becomes writable
+ *
+ * Keep-alive and single-range requests (Range: bytes=a-b) are supported.
+ */
+class TransferEngine {
+public:
+    using Resolver = std::function<TransferTarget(const TransferRequest&)>;
+
+    /**
+     * @brief Constructor
+     * @param listen_port TCP port to listen on
+     * @param resolver Callback mapping a request to a file or body (runs on worker threads)
+     * @param worker_count Number of resolver worker threads
+     */
+    TransferEngine(int listen_port, Resolver resolver, size_t worker_count = 4);
+
+    /**
+     * @brief Destructor - stops the loop and closes all connections
+     */
+    ~TransferEngine();
+
+    /**
+     * @brief Binds the listening socket and starts the event loop and workers
+     * @return true if the engine started, false if the socket could not be bound
+     */
+    bool start();
+
+    /**
+     * @brief Stops the event loop and joins all threads
+     */
+    void stop();
+
+    /**
+     * @brief Gets the port the engine listens on
+     * @return Listening port
+     */
+    int get_port() const { return port; }
+
+    /**
+     * @brief Gets the number of open client connections
+     * @return Connection count
+     */
+    size_t get_connection_count() const { return connection_count.load(); }
+
+private:
+    enum class ConnectionState {
+        READING_HEAD,   ///< Waiting for a complete request head
+        RESOLVING,      ///< Request handed to the worker pool
+        SENDING,        ///< Writing response head/body
+    };
+
+    struct Connection {
+        uint64_t id = 0;
+        int fd = -1;
+        ConnectionState state = ConnectionState::READING_HEAD;
+        std::string in;             ///< Bytes read but not yet consumed
+        std::string out;            ///< Response head (and in-memory body) still to write
+        size_t out_offset = 0;
+        std::shared_ptr<const std::string> shared_body;   ///< Cached body, written after out
+        size_t shared_offset = 0;
+        int file_fd = -1;           ///< File being streamed, -1 if none
+        off_t file_offset = 0;
+        off_t file_end = 0;
+        bool keep_alive = true;
+        bool peer_closed = false;   ///< Client shut down its sending side; answer what it sent, then close
+        std::chrono::steady_clock::time_point last_activity;
+    };
+
+    struct Completion {
+        uint64_t connection_id;
+        std::string head;           ///< Serialized status line and headers
+        std::string body;           ///< In-memory body (empty when streaming a file)
+        std::shared_ptr<const std::string> shared_body;   ///< Cached body, if any
+        int file_fd;
+        off_t file_offset;
+        off_t file_end;
+        bool keep_alive;
+    };
+
+    int port;
+    Resolver resolver;
+    size_t worker_count;
+
+    int listen_fd = -1;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::atomic<bool> running{false};
+    std::atomic<size_t> connection_count{0};
+    std::thread loop_thread;
+
+    // Owned by the loop thread only
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections;
+    uint64_t next_connection_id = 1;
+
+    // Resolver worker pool
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_cv;
+
+    // Results travelling back from workers to the loop
+    std::vector<Completion> completions;
+    std::mutex completions_mutex;
+
+    void event_loop();
+    void worker_loop();
+    void accept_connections();
+    void handle_readable(Connection& conn);
+    void handle_writable(Connection& conn);
+    void dispatch_request(Connection& conn, TransferRequest request, bool keep_alive);
+    void reject_request(Connection& conn, int status);
+    void drain_completions();
+    void close_connection(uint64_t id);
+    void update_interest(const Connection& conn, uint32_t events);
+    void sweep_idle_connections();
+
+    /**
+     * @brief Runs the resolver and turns its answer into a Completion
+     *
+     * Executed on a worker thread: opens and stats the file, applies Range.
+     */
+    Completion build_completion(uint64_t connection_id, const TransferRequest& request, bool keep_alive);
+
+    static bool parse_request_head(const std::string& head, TransferRequest& request);
+};
+
+#endif // TRANSFER_ENGINE_H
@@ -74,7 +74,7 @@ if sudo -u postgres psql -lqt | cut -d \| -f 1 | grep -qw mylibrary_db; then
         sudo -u postgres psql -c "DROP DATABASE IF EXISTS mylibrary_db;"
         log_success "기존 데이터베이스가 삭제되었습니다."
     else
-        log_info "기존 데이터베이스를 유지하고 테이블만 업데이트합니다."
+        log_info "기존 데이터베이스를 유지합니다. 스키마는 서버가 시작할 때 업데이트합니다."
     fi
 fi
 
@@ -119,14 +119,14 @@ else
     exit 1
 fi
 
-# 4단계: 스키마 적용
-log_info "4단계: 데이터베이스 스키마 적용 중..."
+# 4단계: 스키마 권한 설정 (테이블은 서버가 시작할 때 직접 생성)
+log_info "4단계: 데이터베이스 스키마 권한 설정 중..."
 if [ -f "setup_db.sql" ]; then
     sudo -u postgres psql -d mylibrary_db -f setup_db.sql
     if [ $? -eq 0 ]; then
-        log_success "데이터베이스 스키마가 성공적으로 적용되었습니다."
+        log_success "데이터베이스 스키마 권한이 설정되었습니다."
     else
-        log_error "스키마 적용 중 오류가 발생했습니다."
+        log_error "스키마 권한 설정 중 오류가 발생했습니다."
         exit 1
     fi
 else
@@ -134,10 +134,8 @@ else
     exit 1
 fi
 
-# 5단계: 테이블 생성 확인
-log_info "5단계: 생성된 테이블 확인 중..."
-echo "생성된 테이블 목록:"
-sudo -u postgres psql -d mylibrary_db -c "\dt" | grep -E "users|books|collections|user_book_progress|collection_books|collection_permissions"
+# 5단계: 테이블 안내
+log_info "5단계: 테이블은 서버를 처음 시작할 때 자동으로 생성됩니다."
 
 # 6단계: 연결 테스트
 log_info "6단계: 데이터베이스 연결 테스트 중..."
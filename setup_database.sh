@@ -49,8 +49,8 @@ else
     echo "ℹ️  Database already exists."
 fi
 
-# Create tables
-echo "📋 Creating tables..."
+# Let the server's user create tables (the server builds the schema at startup)
+echo "📋 Granting schema privileges..."
 sudo -u postgres psql -d mylibrary_db -f "$(dirname "$0")/setup_db.sql"
 
 echo "✅ Database setup completed!"
@@ -0,0 +1,214 @@
+/**
+ * @file archive_handle_pool.cpp
+ * @brief Implementation of ArchiveHandlePool
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "archive_handle_pool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+const ArchiveIndex::Entry* ArchiveIndex::find(const std::string& name) const {
+    auto it = by_name.find(name);
+    return it == by_name.end() ? nullptr : &entries[it->second];
+}
+
+ArchiveHandlePool::Lease::Lease(ArchiveHandlePool* pool, std::shared_ptr<File> file, unzFile zip)
+    : pool(pool), file(std::move(file)), zip(zip) {
+}
+
+ArchiveHandlePool::Lease::Lease(Lease&& other) noexcept
+    : pool(other.pool), file(std::move(other.file)), zip(other.zip) {
+    other.pool = nullptr;
+    other.zip = nullptr;
+}
+
+ArchiveHandlePool::Lease::~Lease() {
+    if (pool && zip) {
+        pool->release(file, zip);
+    }
+}
+
+const ArchiveIndex& ArchiveHandlePool::Lease::index() const {
+    return *file->index;
+}
+
+bool ArchiveHandlePool::Lease::seek(const std::string& entry_name) {
+    const ArchiveIndex::Entry* entry = file->index->find(entry_name);
+    return entry != nullptr && unzGoToFilePos64(zip, &entry->position) == UNZ_OK;
+}
+
+ArchiveHandlePool::ArchiveHandlePool(size_t max_open_handles, size_t max_files)
+    : max_open(std::max<size_t>(max_open_handles, 1)), max_files(std::max<size_t>(max_files, 1)) {
+}
+
+ArchiveHandlePool::~ArchiveHandlePool() {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    for (auto& [path, file] : files) {
+        for (unzFile zip : file->idle) {
+            unzClose(zip);
+        }
+        file->idle.clear();
+        file->retired = true;
+    }
+}
+
+ArchiveHandlePool& ArchiveHandlePool::shared() {
+    static ArchiveHandlePool pool([] {
+        // Leave most descriptors to sockets and the streaming engine
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+            return std::clamp<size_t>(static_cast<size_t>(limit.rlim_cur) / 8, 8, 256);
+        }
+        return static_cast<size_t>(64);
+    }());
+    return pool;
+}
+
+ArchiveHandlePool::Lease ArchiveHandlePool::acquire(const std::string& file_path) {
+    struct stat st;
+    if (stat(file_path.c_str(), &st) != 0) {
+        throw std::runtime_error("Cannot open archive: " + file_path);
+    }
+    std::string identity = std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" +
+                           std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec);
+    
+    std::shared_ptr<File> file;
+    unzFile zip = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        auto it = files.find(file_path);
+        if (it != files.end() && it->second->identity != identity) {
+            // File was replaced on disk: its index and handles are stale
+            retire_locked(it->second);
+            it = files.end();
+        }
+        
+        if (it == files.end()) {
+            file = std::make_shared<File>();
+            file->path = file_path;
+            file->identity = identity;
+            lru.push_front(file_path);
+            file->lru_position = lru.begin();
+            files[file_path] = file;
+        } else {
+            file = it->second;
+            lru.splice(lru.begin(), lru, file->lru_position);
+        }
+        
+        if (!file->idle.empty()) {
+            zip = file->idle.back();
+            file->idle.pop_back();
+            handle_hits++;
+        } else {
+            // Reserve the slot now so concurrent acquires see the real count
+            open_handles++;
+        }
+        enforce_limits_locked();
+    }
+    
+    if (zip == nullptr) {
+        zip = unzOpen(file_path.c_str());
+        if (zip == nullptr) {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            open_handles--;
+            throw std::runtime_error("Cannot open archive: " + file_path);
+        }
+        handle_opens++;
+    }
+    
+    Lease lease(this, file, zip);
+    
+    std::shared_ptr<const ArchiveIndex> index;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        index = file->index;
+    }
+    if (!index) {
+        // Built outside the lock; if two callers race, both indexes are identical
+        index = build_index(zip);
+        index_builds++;
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (!file->index) {
+            file->index = index;
+        }
+    }
+    return lease;
+}
+
+std::shared_ptr<const ArchiveIndex> ArchiveHandlePool::build_index(unzFile zip) {
+    auto index = std::make_shared<ArchiveIndex>();
+    char name_buffer[1024];
+    unz_file_info64 info;
+    
+    for (int status = unzGoToFirstFile(zip); status == UNZ_OK; status = unzGoToNextFile(zip)) {
+        ArchiveIndex::Entry entry;
+        if (unzGetCurrentFileInfo64(zip, &info, name_buffer, sizeof(name_buffer),
+                                    nullptr, 0, nullptr, 0) != UNZ_OK ||
+            unzGetFilePos64(zip, &entry.position) != UNZ_OK) {
+            continue;
+        }
+        entry.name = name_buffer;
+        entry.compressed_size = info.compressed_size;
+        entry.uncompressed_size = info.uncompressed_size;
+        
+        index->by_name.emplace(entry.name, index->entries.size());
+        index->entries.push_back(std::move(entry));
+    }
+    return index;
+}
+
+void ArchiveHandlePool::release(const std::shared_ptr<File>& file, unzFile zip) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    if (file->retired || open_handles > max_open) {
+        unzClose(zip);
+        open_handles--;
+        return;
+    }
+    file->idle.push_back(zip);
+}
+
+void ArchiveHandlePool::retire_locked(std::shared_ptr<File> file) {
+    for (unzFile zip : file->idle) {
+        unzClose(zip);
+        open_handles--;
+    }
+    file->idle.clear();
+    file->retired = true;
+    lru.erase(file->lru_position);
+    files.erase(file->path);
+}
+
+void ArchiveHandlePool::enforce_limits_locked() {
+    // Close idle handles of the least recently used archives first
+    for (auto it = lru.rbegin(); it != lru.rend() && open_handles > max_open; ++it) {
+        File& file = *files[*it];
+        while (!file.idle.empty() && open_handles > max_open) {
+            unzClose(file.idle.back());
+            file.idle.pop_back();
+            open_handles--;
+        }
+    }
+    
+    while (files.size() > max_files) {
+        retire_locked(files[lru.back()]);
+    }
+}
+
+nlohmann::json ArchiveHandlePool::get_stats() {
+    nlohmann::json stats;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stats["open_handles"] = open_handles;
+        stats["indexed_files"] = files.size();
+    }
+    stats["max_open_handles"] = max_open;
+    stats["handle_hits"] = handle_hits.load();
+    stats["handle_opens"] = handle_opens.load();
+    stats["index_builds"] = index_builds.load();
+    return stats;
+}
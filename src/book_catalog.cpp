@@ -0,0 +1,382 @@
+/**
+ * @file book_catalog.cpp
+ * @brief Implementation of BookCatalog
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "book_catalog.h"
+#include "database.h"
+#include "collation.h"
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+const std::vector<std::string> FORMAT_NAMES = {"other", "epub", "pdf", "cbz", "cbr"};
+constexpr int NO_FORMAT = -2;   ///< Filter value that no format code equals
+
+} // namespace
+
+uint32_t BookCatalog::StringPool::intern(const std::string& value) {
+    auto it = lookup.find(value);
+    if (it != lookup.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(values.size());
+    values.push_back(value);
+    keys.push_back(Collation::primary_key(value));
+    lookup.emplace(value, id);
+    return id;
+}
+
+void BookCatalog::StringPool::compute_ranks() {
+    std::vector<uint32_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    // Spellings that differ only in case share a rank
+    ranks.assign(values.size(), 0);
+    uint32_t rank = 0;
+    for (size_t position = 0; position < order.size(); position++) {
+        if (position > 0 && keys[order[position]] != keys[order[position - 1]]) {
+            rank++;
+        }
+        ranks[order[position]] = rank;
+    }
+}
+
+size_t BookCatalog::StringPool::memory_bytes() const {
+    size_t bytes = ranks.capacity() * sizeof(uint32_t) + lookup.size() * (sizeof(std::string) + sizeof(uint32_t));
+    for (size_t i = 0; i < values.size(); i++) {
+        bytes += values[i].capacity() + keys[i].capacity() + 2 * sizeof(std::string);
+    }
+    return bytes;
+}
+
+BookCatalog::BookCatalog(Database* db) : database(db) {
+    if (!database) {
+        throw std::invalid_argument("BookCatalog requires a valid Database instance");
+    }
+}
+
+bool BookCatalog::rebuild() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<CatalogRow> loaded;
+    if (!database->load_catalog_rows(loaded)) {
+        std::cerr << "BookCatalog: rebuild failed, keeping the previous catalog" << std::endl;
+        return false;
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(catalog_mutex);
+        generation.fetch_add(1);
+        rows.clear();
+        for (auto* column : {&author_ids, &publisher_ids, &language_ids}) {
+            column->clear();
+        }
+        ids.clear();
+        titles.clear();
+        title_keys.clear();
+        title_prefixes.clear();
+        format_codes.clear();
+        sizes.clear();
+        added.clear();
+        authors = StringPool{};
+        publishers = StringPool{};
+        languages = StringPool{};
+
+        rows.reserve(loaded.size());
+        for (auto* column : {&author_ids, &publisher_ids, &language_ids}) {
+            column->reserve(loaded.size());
+        }
+        ids.reserve(loaded.size());
+        titles.reserve(loaded.size());
+        title_keys.reserve(loaded.size());
+        title_prefixes.reserve(loaded.size());
+        format_codes.reserve(loaded.size());
+        sizes.reserve(loaded.size());
+        added.reserve(loaded.size());
+
+        for (const auto& row : loaded) {
+            apply_locked(row);
+        }
+        ranks_dirty.store(true);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "BookCatalog: loaded " << loaded.size() << " books in " << elapsed.count() << " ms" << std::endl;
+    return true;
+}
+
+bool BookCatalog::upsert(long book_id) {
+    std::vector<CatalogRow> loaded;
+    if (!database->load_catalog_rows(loaded, book_id)) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(catalog_mutex);
+    if (loaded.empty()) {
+        remove_locked(book_id);
+        return false;
+    }
+    apply_locked(loaded.front());
+    ranks_dirty.store(true);
+    return true;
+}
+
+void BookCatalog::remove(long book_id) {
+    std::unique_lock<std::shared_mutex> lock(catalog_mutex);
+    remove_locked(book_id);
+}
+
+void BookCatalog::apply_locked(const CatalogRow& row) {
+    generation.fetch_add(1);
+    std::string key = Collation::sort_key(row.title);
+    uint64_t prefix = key_prefix(key);
+    uint32_t author = authors.intern(row.author);
+    uint32_t publisher = publishers.intern(row.publisher);
+    uint32_t language = languages.intern(row.language);
+
+    auto it = rows.find(row.id);
+    if (it != rows.end()) {
+        uint32_t index = it->second;
+        titles[index] = row.title;
+        title_keys[index] = std::move(key);
+        title_prefixes[index] = prefix;
+        author_ids[index] = author;
+        publisher_ids[index] = publisher;
+        language_ids[index] = language;
+        format_codes[index] = format_code(row.file_type);
+        sizes[index] = row.file_size;
+        added[index] = row.uploaded_at;
+        return;
+    }
+
+    rows.emplace(row.id, static_cast<uint32_t>(ids.size()));
+    ids.push_back(row.id);
+    titles.push_back(row.title);
+    title_keys.push_back(std::move(key));
+    title_prefixes.push_back(prefix);
+    author_ids.push_back(author);
+    publisher_ids.push_back(publisher);
+    language_ids.push_back(language);
+    format_codes.push_back(format_code(row.file_type));
+    sizes.push_back(row.file_size);
+    added.push_back(row.uploaded_at);
+}
+
+void BookCatalog::remove_locked(long book_id) {
+    generation.fetch_add(1);
+    auto it = rows.find(book_id);
+    if (it == rows.end()) {
+        return;
+    }
+
+    // Move the last row into the hole so the columns stay dense
+    uint32_t index = it->second;
+    uint32_t last = static_cast<uint32_t>(ids.size() - 1);
+    rows.erase(it);
+    if (index != last) {
+        ids[index] = ids[last];
+        titles[index] = std::move(titles[last]);
+        title_keys[index] = std::move(title_keys[last]);
+        title_prefixes[index] = title_prefixes[last];
+        author_ids[index] = author_ids[last];
+        publisher_ids[index] = publisher_ids[last];
+        language_ids[index] = language_ids[last];
+        format_codes[index] = format_codes[last];
+        sizes[index] = sizes[last];
+        added[index] = added[last];
+        rows[ids[index]] = index;
+    }
+    ids.pop_back();
+    titles.pop_back();
+    title_keys.pop_back();
+    title_prefixes.pop_back();
+    author_ids.pop_back();
+    publisher_ids.pop_back();
+    language_ids.pop_back();
+    format_codes.pop_back();
+    sizes.pop_back();
+    added.pop_back();
+}
+
+void BookCatalog::ensure_ranks() const {
+    if (!ranks_dirty.load()) {
+        return;
+    }
+    std::unique_lock<std::shared_mutex> lock(catalog_mutex);
+    if (ranks_dirty.load()) {
+        authors.compute_ranks();
+        publishers.compute_ranks();
+        ranks_dirty.store(false);
+    }
+}
+
+BookCatalog::Page BookCatalog::query(const Query& query) const {
+    // Ranks are only marked dirty under the exclusive lock, so a clean flag
+    // seen under the shared lock stays clean until the query is done
+    std::shared_lock<std::shared_mutex> lock(catalog_mutex, std::defer_lock);
+    while (true) {
+        ensure_ranks();
+        lock.lock();
+        if (!ranks_dirty.load()) {
+            break;
+        }
+        lock.unlock();
+    }
+
+    // Resolve string filters to pool IDs once, then compare integers per row
+    auto matching_ids = [](const StringPool& pool, const std::string& value) {
+        std::vector<bool> accepted(pool.values.size(), false);
+        std::string key = Collation::primary_key(value);
+        for (size_t i = 0; i < pool.keys.size(); i++) {
+            accepted[i] = pool.keys[i] == key;
+        }
+        return accepted;
+    };
+    std::vector<bool> accepted_authors = query.author.empty() ? std::vector<bool>{} : matching_ids(authors, query.author);
+    std::vector<bool> accepted_languages = query.language.empty() ? std::vector<bool>{} : matching_ids(languages, query.language);
+    // An unknown format matches no book instead of every "other" one
+    int format = -1;
+    if (!query.format.empty()) {
+        auto it = std::find(FORMAT_NAMES.begin(), FORMAT_NAMES.end(), query.format);
+        format = it == FORMAT_NAMES.end() ? NO_FORMAT : static_cast<int>(it - FORMAT_NAMES.begin());
+    }
+
+    std::vector<uint32_t> matches;
+    matches.reserve(ids.size());
+    for (uint32_t row = 0; row < ids.size(); row++) {
+        if (format != -1 && format_codes[row] != format) continue;
+        if (sizes[row] < query.min_size) continue;
+        if (query.max_size >= 0 && sizes[row] > query.max_size) continue;
+        if (!accepted_authors.empty() && !accepted_authors[author_ids[row]]) continue;
+        if (!accepted_languages.empty() && !accepted_languages[language_ids[row]]) continue;
+        matches.push_back(row);
+    }
+
+    Page page;
+    page.total = matches.size();
+    page.books = nlohmann::json::array();
+    if (query.offset >= matches.size() || query.limit == 0) {
+        return page;
+    }
+
+    // Primary key in the requested direction, newest book first on ties
+    auto compare_primary = [&](uint32_t a, uint32_t b) -> int {
+        switch (query.sort) {
+        case SortKey::Title:
+            if (title_prefixes[a] != title_prefixes[b]) return title_prefixes[a] < title_prefixes[b] ? -1 : 1;
+            return title_keys[a].compare(title_keys[b]);
+        case SortKey::Author: {
+            uint32_t rank_a = authors.ranks[author_ids[a]];
+            uint32_t rank_b = authors.ranks[author_ids[b]];
+            return rank_a == rank_b ? 0 : (rank_a < rank_b ? -1 : 1);
+        }
+        case SortKey::Size:
+            return sizes[a] == sizes[b] ? 0 : (sizes[a] < sizes[b] ? -1 : 1);
+        case SortKey::Date:
+            return added[a] == added[b] ? 0 : (added[a] < added[b] ? -1 : 1);
+        }
+        return 0;
+    };
+    auto before = [&](uint32_t a, uint32_t b) {
+        int order = compare_primary(a, b);
+        if (order != 0) {
+            return query.descending ? order > 0 : order < 0;
+        }
+        return ids[a] > ids[b];
+    };
+
+    size_t end = std::min(matches.size(), query.offset + query.limit);
+    if (end < matches.size()) {
+        std::partial_sort(matches.begin(), matches.begin() + static_cast<long>(end), matches.end(), before);
+    } else {
+        std::sort(matches.begin(), matches.end(), before);
+    }
+
+    for (size_t i = query.offset; i < end; i++) {
+        uint32_t row = matches[i];
+        nlohmann::json book;
+        book["id"] = ids[row];
+        book["title"] = titles[row];
+        book["author"] = authors.values[author_ids[row]];
+        book["publisher"] = publishers.values[publisher_ids[row]];
+        book["language"] = languages.values[language_ids[row]];
+        book["file_type"] = FORMAT_NAMES[format_codes[row]];
+        book["file_size"] = sizes[row];
+        book["uploaded_at"] = format_timestamp(added[row]);
+        page.books.push_back(std::move(book));
+    }
+    return page;
+}
+
+bool BookCatalog::parse_sort_key(const std::string& name, SortKey& key) {
+    if (name == "title") {
+        key = SortKey::Title;
+    } else if (name == "author") {
+        key = SortKey::Author;
+    } else if (name == "size") {
+        key = SortKey::Size;
+    } else if (name == "date") {
+        key = SortKey::Date;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+nlohmann::json BookCatalog::get_stats() const {
+    std::shared_lock<std::shared_mutex> lock(catalog_mutex);
+
+    size_t bytes = ids.capacity() * sizeof(long)
+                 + title_prefixes.capacity() * sizeof(uint64_t)
+                 + (author_ids.capacity() + publisher_ids.capacity() + language_ids.capacity()) * sizeof(uint32_t)
+                 + format_codes.capacity()
+                 + (sizes.capacity() + added.capacity()) * sizeof(int64_t)
+                 + rows.size() * (sizeof(long) + sizeof(uint32_t));
+    for (size_t i = 0; i < titles.size(); i++) {
+        bytes += titles[i].capacity() + title_keys[i].capacity() + 2 * sizeof(std::string);
+    }
+    bytes += authors.memory_bytes() + publishers.memory_bytes() + languages.memory_bytes();
+
+    nlohmann::json stats;
+    stats["books"] = ids.size();
+    stats["authors"] = authors.values.size();
+    stats["publishers"] = publishers.values.size();
+    stats["memory_bytes"] = bytes;
+    return stats;
+}
+
+uint64_t BookCatalog::key_prefix(const std::string& key) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; i++) {
+        prefix <<= 8;
+        if (i < key.size()) {
+            prefix |= static_cast<unsigned char>(key[i]);
+        }
+    }
+    return prefix;
+}
+
+uint8_t BookCatalog::format_code(const std::string& file_type) {
+    auto it = std::find(FORMAT_NAMES.begin() + 1, FORMAT_NAMES.end(), file_type);
+    return it == FORMAT_NAMES.end() ? 0 : static_cast<uint8_t>(it - FORMAT_NAMES.begin());
+}
+
+std::string BookCatalog::format_timestamp(int64_t seconds) {
+    std::time_t time = static_cast<std::time_t>(seconds);
+    std::tm parts{};
+    gmtime_r(&time, &parts);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &parts);
+    return buffer;
+}
@@ -7,6 +7,8 @@
  */
 
 #include "book_manager.h"
+#include "archive_handle_pool.h"
+#include "text_normalizer.h"
 #include <filesystem>
 #include <fstream>
 #include <regex>
@@ -15,6 +17,7 @@
 #include <algorithm>
 #include <cctype>
 #include <iostream>
+#include <unordered_map>
 #include <minizip/unzip.h>
 #include <tinyxml2.h>
 
@@ -27,8 +30,11 @@ BookManager::BookManager(const std::string& books_dir) : books_directory(books_d
 }
 
 BookInfo BookManager::save_uploaded_book(const std::string& file_content, 
-                                        const std::string& original_filename,
+                                        const std::string& uploaded_filename,
                                         const std::string& content_type) {
+    // macOS clients send NFD filenames; metadata derived from the name is stored composed
+    const std::string original_filename = TextNormalizer::normalize(uploaded_filename);
+    
     // Validate file type
     std::string file_type = get_file_type(original_filename);
     if (!is_supported_format("." + file_type)) {
@@ -40,8 +46,8 @@ BookInfo BookManager::save_uploaded_book(const std::string& file_content,
         throw std::runtime_error("File content does not match declared type");
     }
     
-    // Generate unique filename
-    std::string unique_filename = generate_unique_filename(original_filename);
+    // Generate unique filename (the file on disk keeps the name as uploaded)
+    std::string unique_filename = generate_unique_filename(uploaded_filename);
     std::string file_path = get_book_file_path(unique_filename);
     
     // Save file to disk
@@ -106,22 +112,9 @@ BookInfo BookManager::save_uploaded_book(const std::string& file_content,
         book_info.author = book_info.metadata.author;
         
         // Generate thumbnail from extracted cover or create placeholder
-        std::string thumbnail_extension;
-        if (!book_info.metadata.cover_image.empty()) {
-            // Use appropriate extension based on cover format
-            if (book_info.metadata.cover_format.find("jpeg") != std::string::npos || 
-                book_info.metadata.cover_format.find("jpg") != std::string::npos) {
-                thumbnail_extension = ".jpg";
-            } else if (book_info.metadata.cover_format.find("png") != std::string::npos) {
-                thumbnail_extension = ".png";
-            } else {
-                thumbnail_extension = ".jpg"; // Default to JPEG
-            }
-        } else {
-            thumbnail_extension = ".svg"; // SVG placeholder
-        }
-        
-        std::string thumbnail_filename = "thumb_" + unique_filename + thumbnail_extension;
+        std::string extension = thumbnail_extension(
+            book_info.metadata.cover_image.empty() ? "" : book_info.metadata.cover_format);
+        std::string thumbnail_filename = "thumb_" + unique_filename + extension;
         std::string thumbnail_path = get_thumbnails_directory() + "/" + thumbnail_filename;
         
         if (generate_thumbnail(file_path, file_type, book_info.metadata.cover_image, thumbnail_path)) {
@@ -148,6 +141,14 @@ BookInfo BookManager::save_uploaded_book(const std::string& file_content,
         }
     }
     
+    // Repair invalid UTF-8 from broken metadata and compose NFD text before it reaches the database
+    for (std::string* field : {&book_info.title, &book_info.author, &book_info.extraction_error,
+                               &book_info.metadata.title, &book_info.metadata.author,
+                               &book_info.metadata.description, &book_info.metadata.publisher,
+                               &book_info.metadata.isbn, &book_info.metadata.language}) {
+        *field = TextNormalizer::normalize(*field);
+    }
+    
     // Trim whitespace
     book_info.title.erase(0, book_info.title.find_first_not_of(" \t"));
     book_info.title.erase(book_info.title.find_last_not_of(" \t") + 1);
@@ -176,6 +177,7 @@ nlohmann::json BookManager::extract_metadata(const std::string& file_path,
             
             metadata["file_size"] = file_size;
             metadata["file_type"] = file_type;
+            metadata["title"] = TextNormalizer::normalize(fs::path(file_path).stem().string());
             metadata["last_modified"] = std::chrono::duration_cast<std::chrono::seconds>(
                 last_write_time.time_since_epoch()).count();
         }
@@ -450,6 +452,16 @@ BookMetadata BookManager::extract_comic_metadata(const std::string& file_path) {
     return metadata;
 }
 
+std::string BookManager::thumbnail_extension(const std::string& cover_format) {
+    if (cover_format.empty()) {
+        return ".svg"; // SVG placeholder
+    }
+    if (cover_format.find("png") != std::string::npos) {
+        return ".png";
+    }
+    return ".jpg"; // JPEG, and the default for anything else
+}
+
 bool BookManager::generate_thumbnail(const std::string& file_path,
                                    const std::string& file_type,
                                    const std::vector<unsigned char>& cover_image,
@@ -709,6 +721,173 @@ void BookManager::extract_cover_image_from_epub(unzFile epub_file, const std::st
     }
 }
 
+namespace {
+
+// Natural ordering so that "page2.jpg" sorts before "page10.jpg"
+bool natural_less(const std::string& a, const std::string& b) {
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (std::isdigit(static_cast<unsigned char>(a[i])) && std::isdigit(static_cast<unsigned char>(b[j]))) {
+            size_t i_end = i, j_end = j;
+            while (i_end < a.size() && std::isdigit(static_cast<unsigned char>(a[i_end]))) i_end++;
+            while (j_end < b.size() && std::isdigit(static_cast<unsigned char>(b[j_end]))) j_end++;
+            
+            // Compare numerically: strip leading zeros, then longer means bigger
+            size_t i_nz = a.find_first_not_of('0', i), j_nz = b.find_first_not_of('0', j);
+            i_nz = std::min(i_nz, i_end);
+            j_nz = std::min(j_nz, j_end);
+            size_t a_len = i_end - i_nz, b_len = j_end - j_nz;
+            if (a_len != b_len) return a_len < b_len;
+            int cmp = a.compare(i_nz, a_len, b, j_nz, b_len);
+            if (cmp != 0) return cmp < 0;
+            
+            i = i_end;
+            j = j_end;
+        } else {
+            char ca = static_cast<char>(std::tolower(static_cast<unsigned char>(a[i])));
+            char cb = static_cast<char>(std::tolower(static_cast<unsigned char>(b[j])));
+            if (ca != cb) return ca < cb;
+            i++;
+            j++;
+        }
+    }
+    return (a.size() - i) < (b.size() - j);
+}
+
+} // namespace
+
+std::vector<std::string> BookManager::list_archive_pages(const std::string& file_path) {
+    ArchiveHandlePool::Lease archive = ArchiveHandlePool::shared().acquire(file_path);
+    
+    std::vector<std::string> pages;
+    for (const auto& entry : archive.index().entries) {
+        const std::string& name = entry.name;
+        if (name.empty() || name.back() == '/' || name.find("__MACOSX/") != std::string::npos) {
+            continue;
+        }
+        if (get_image_content_type(name) != "application/octet-stream") {
+            pages.push_back(name);
+        }
+    }
+    
+    std::sort(pages.begin(), pages.end(), natural_less);
+    return pages;
+}
+
+std::string BookManager::read_archive_entry(const std::string& file_path, const std::string& entry_name) {
+    ArchiveHandlePool::Lease archive = ArchiveHandlePool::shared().acquire(file_path);
+    
+    if (!archive.seek(entry_name) || unzOpenCurrentFile(archive.handle()) != UNZ_OK) {
+        throw std::runtime_error("Entry not found in archive: " + entry_name);
+    }
+    
+    std::string content;
+    content.reserve(static_cast<size_t>(archive.index().find(entry_name)->uncompressed_size));
+    
+    char buffer[65536];
+    int bytes_read;
+    while ((bytes_read = unzReadCurrentFile(archive.handle(), buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, bytes_read);
+    }
+    
+    unzCloseCurrentFile(archive.handle());
+    
+    if (bytes_read < 0) {
+        throw std::runtime_error("Failed to inflate archive entry: " + entry_name);
+    }
+    return content;
+}
+
+std::string BookManager::get_image_content_type(const std::string& entry_name) {
+    std::string ext = fs::path(entry_name).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    
+    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
+    if (ext == ".png") return "image/png";
+    if (ext == ".gif") return "image/gif";
+    if (ext == ".webp") return "image/webp";
+    if (ext == ".avif") return "image/avif";
+    if (ext == ".svg") return "image/svg+xml";
+    
+    return "application/octet-stream";
+}
+
+std::vector<std::string> BookManager::list_epub_chapters(const std::string& file_path) {
+    std::string opf_path;
+    {
+        ArchiveHandlePool::Lease archive = ArchiveHandlePool::shared().acquire(file_path);
+        opf_path = extract_opf_path_from_container(archive.handle());
+    }
+    if (opf_path.empty()) {
+        throw std::runtime_error("Cannot read OPF package of: " + file_path);
+    }
+    
+    std::string content = read_archive_entry(file_path, opf_path);
+    
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(content.c_str(), content.size()) != tinyxml2::XML_SUCCESS) {
+        throw std::runtime_error("Invalid OPF package in: " + file_path);
+    }
+    
+    tinyxml2::XMLElement* package = doc.FirstChildElement("package");
+    tinyxml2::XMLElement* manifest = package ? package->FirstChildElement("manifest") : nullptr;
+    tinyxml2::XMLElement* spine = package ? package->FirstChildElement("spine") : nullptr;
+    if (!manifest || !spine) {
+        throw std::runtime_error("OPF package has no manifest/spine: " + file_path);
+    }
+    
+    // Map manifest ids to hrefs, then walk the spine in order
+    std::unordered_map<std::string, std::string> hrefs;
+    for (tinyxml2::XMLElement* item = manifest->FirstChildElement("item");
+         item; item = item->NextSiblingElement("item")) {
+        if (item->Attribute("id") && item->Attribute("href")) {
+            hrefs[item->Attribute("id")] = item->Attribute("href");
+        }
+    }
+    
+    fs::path opf_dir = fs::path(opf_path).parent_path();
+    std::vector<std::string> chapters;
+    for (tinyxml2::XMLElement* itemref = spine->FirstChildElement("itemref");
+         itemref; itemref = itemref->NextSiblingElement("itemref")) {
+        const char* idref = itemref->Attribute("idref");
+        if (!idref) continue;
+        
+        auto it = hrefs.find(idref);
+        if (it != hrefs.end()) {
+            chapters.push_back((opf_dir / it->second).lexically_normal().generic_string());
+        }
+    }
+    
+    return chapters;
+}
+
+std::vector<ArchiveEntryRange> BookManager::locate_archive_entries(const std::string& file_path,
+                                                                   const std::vector<std::string>& entry_names) {
+    std::vector<ArchiveEntryRange> ranges;
+    try {
+        ArchiveHandlePool::Lease archive = ArchiveHandlePool::shared().acquire(file_path);
+        
+        for (const auto& name : entry_names) {
+            // Opening the entry parses its local header, after which minizip
+            // knows where the compressed stream starts
+            if (!archive.seek(name) || unzOpenCurrentFile(archive.handle()) != UNZ_OK) {
+                continue;
+            }
+            ArchiveEntryRange range;
+            range.name = name;
+            range.offset = unzGetCurrentFileZStreamPos64(archive.handle());
+            range.length = archive.index().find(name)->compressed_size;
+            unzCloseCurrentFile(archive.handle());
+            
+            ranges.push_back(std::move(range));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "BookManager: Cannot locate entries in " << file_path << ": " << e.what() << std::endl;
+    }
+    
+    return ranges;
+}
+
 const std::string& BookManager::get_books_directory() const {
     return books_directory;
 }
@@ -0,0 +1,212 @@
+/**
+ * @file collation.cpp
+ * @brief Implementation of Collation
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "collation.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Key elements. Each starts with a lead byte; the separator that
+// sort_key() puts after the primary key (0x00) is below all of them.
+constexpr char SPACE = 0x01;
+constexpr char NUMBER = 0x10;        // + digit count + digits
+constexpr char LETTER_BASE = 0x20;   // 'a'..'z' -> 0x20..0x39
+constexpr char HANGUL = static_cast<char>(0x80);   // + initial + medial + final
+constexpr char OTHER = static_cast<char>(0xF0);    // + 3-byte code point
+
+constexpr size_t MAX_PRIMARY_BYTES = 1024;
+constexpr size_t MAX_TIEBREAK_BYTES = 512;
+
+// Latin-1 letters U+00C0..U+00FF folded to ASCII ("" = skipped symbol)
+const char* const LATIN1_FOLD[64] = {
+    "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+    "d", "n", "o", "o", "o", "o", "o", "", "o", "u", "u", "u", "u", "y", "th", "ss",
+    "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+    "d", "n", "o", "o", "o", "o", "o", "", "o", "u", "u", "u", "u", "y", "th", "y"};
+
+// Compatibility jamo U+3131..U+314E -> initial consonant index (-1 = cluster)
+const int COMPAT_INITIAL[30] = {
+    0, 1, -1, 2, -1, -1, 3, 4, 5, -1, -1, -1, -1, -1, -1, -1,
+    6, 7, 8, -1, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18};
+
+std::vector<char32_t> decode_utf8(const std::string& text) {
+    std::vector<char32_t> code_points;
+    code_points.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size()) {
+            code_points.push_back(0xFFFD);
+            i++;
+            continue;
+        }
+        char32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+        bool valid = true;
+        for (size_t k = 1; k < length; k++) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        if (!valid) {
+            code_points.push_back(0xFFFD);
+            i++;
+            continue;
+        }
+        code_points.push_back(cp);
+        i += length;
+    }
+    return code_points;
+}
+
+bool is_space(char32_t cp) {
+    return cp == ' ' || cp == '\t' || cp == '\r' || cp == '\n' || cp == 0xA0 ||
+           (cp >= 0x2000 && cp <= 0x200A) || cp == 0x3000;
+}
+
+bool is_ignorable(char32_t cp) {
+    return (cp < 0x80 && !(cp >= '0' && cp <= '9') && !(cp >= 'a' && cp <= 'z') && !(cp >= 'A' && cp <= 'Z')) ||
+           (cp >= 0x80 && cp <= 0xBF) ||       // Latin-1 controls and punctuation
+           (cp >= 0x0300 && cp <= 0x036F) ||   // combining accents
+           (cp >= 0x200B && cp <= 0x206F) ||   // general punctuation
+           (cp >= 0x3001 && cp <= 0x303F) ||   // CJK punctuation and brackets
+           (cp >= 0xFE30 && cp <= 0xFE4F) ||   // CJK compatibility forms
+           cp == 0xFEFF || cp == 0xFFFD;
+}
+
+void append_other(std::string& key, char32_t cp) {
+    key.push_back(OTHER);
+    key.push_back(static_cast<char>((cp >> 16) & 0xFF));
+    key.push_back(static_cast<char>((cp >> 8) & 0xFF));
+    key.push_back(static_cast<char>(cp & 0xFF));
+}
+
+void append_hangul(std::string& key, int initial, int medial, int final) {
+    key.push_back(HANGUL);
+    key.push_back(static_cast<char>(initial + 1));
+    key.push_back(static_cast<char>(medial));
+    key.push_back(static_cast<char>(final));
+}
+
+} // namespace
+
+std::string Collation::primary_key(const std::string& text) {
+    std::vector<char32_t> code_points = decode_utf8(text);
+    std::string key;
+    key.reserve(code_points.size() * 2);
+
+    bool pending_space = false;
+    std::string digits;
+    auto flush_digits = [&]() {
+        if (digits.empty()) {
+            return;
+        }
+        size_t first = digits.find_first_not_of('0');
+        std::string value = first == std::string::npos ? "0" : digits.substr(first);
+        if (value.size() > 255) {
+            value.resize(255);
+        }
+        key.push_back(NUMBER);
+        key.push_back(static_cast<char>(value.size()));
+        key += value;
+        digits.clear();
+    };
+    auto start_element = [&]() {
+        if (pending_space && !key.empty()) {
+            key.push_back(SPACE);
+        }
+        pending_space = false;
+    };
+
+    for (char32_t cp : code_points) {
+        // Fullwidth ASCII behaves like ASCII
+        if (cp >= 0xFF01 && cp <= 0xFF5E) {
+            cp = cp - 0xFF01 + 0x21;
+        }
+
+        if (cp >= '0' && cp <= '9') {
+            if (digits.empty()) {
+                start_element();
+            }
+            digits.push_back(static_cast<char>(cp));
+            continue;
+        }
+        flush_digits();
+
+        if (is_space(cp)) {
+            pending_space = true;
+        } else if (is_ignorable(cp)) {
+            continue;
+        } else if ((cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z')) {
+            start_element();
+            key.push_back(static_cast<char>(LETTER_BASE + ((cp | 0x20) - 'a')));
+        } else if (cp >= 0xC0 && cp <= 0xFF) {
+            start_element();
+            for (const char* folded = LATIN1_FOLD[cp - 0xC0]; *folded; folded++) {
+                key.push_back(static_cast<char>(LETTER_BASE + (*folded - 'a')));
+            }
+        } else if (cp >= 0xAC00 && cp <= 0xD7A3) {
+            start_element();
+            int index = static_cast<int>(cp - 0xAC00);
+            append_hangul(key, index / (21 * 28), index % (21 * 28) / 28 + 1, index % 28);
+        } else if (cp >= 0x3131 && cp <= 0x314E && COMPAT_INITIAL[cp - 0x3131] >= 0) {
+            start_element();
+            append_hangul(key, COMPAT_INITIAL[cp - 0x3131], 0, 0);
+        } else if (cp >= 0x1100 && cp <= 0x1112) {
+            start_element();
+            append_hangul(key, static_cast<int>(cp - 0x1100), 0, 0);
+        } else {
+            start_element();
+            append_other(key, cp);
+        }
+
+        if (key.size() >= MAX_PRIMARY_BYTES) {
+            break;
+        }
+    }
+    flush_digits();
+    if (key.size() > MAX_PRIMARY_BYTES) {
+        key.resize(MAX_PRIMARY_BYTES);
+    }
+
+    // Drop a leading article when something follows it
+    static const std::string ARTICLES[] = {
+        {LETTER_BASE + ('t' - 'a'), LETTER_BASE + ('h' - 'a'), LETTER_BASE + ('e' - 'a'), SPACE},
+        {LETTER_BASE + ('a' - 'a'), LETTER_BASE + ('n' - 'a'), SPACE},
+        {LETTER_BASE + ('a' - 'a'), SPACE}};
+    for (const auto& article : ARTICLES) {
+        if (key.size() > article.size() && key.compare(0, article.size(), article) == 0) {
+            key.erase(0, article.size());
+            break;
+        }
+    }
+    return key;
+}
+
+std::string Collation::sort_key(const std::string& text) {
+    std::string key(1, static_cast<char>(VERSION));
+    key += primary_key(text);
+    key.push_back('\0');
+    key.append(text, 0, std::min(text.size(), MAX_TIEBREAK_BYTES));
+    return key;
+}
+
+std::string Collation::to_hex(const std::string& key) {
+    static const char HEX[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(key.size() * 2);
+    for (unsigned char c : key) {
+        hex.push_back(HEX[c >> 4]);
+        hex.push_back(HEX[c & 0x0F]);
+    }
+    return hex;
+}
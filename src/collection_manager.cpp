@@ -14,20 +14,30 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <iomanip>
+#include <numeric>
 
 // ========== Constructor and Destructor ==========
 
 /**
  * @brief Constructor - Initialize collection manager with database connection
  * @param connection Shared pointer to PostgreSQL connection
+ * @param batch_connection Connection for pipelined batches
+ * @param invalidation_bus Bus to announce collection changes on
  */
-CollectionManager::CollectionManager(std::shared_ptr<pqxx::connection> connection)
-    : db_connection(connection) {
+CollectionManager::CollectionManager(std::shared_ptr<pqxx::connection> connection,
+                                     std::shared_ptr<PgPipeline> batch_connection,
+                                     InvalidationBus* invalidation_bus)
+    : db_connection(connection), pipeline(batch_connection), invalidations(invalidation_bus) {
     // Verify connection is valid
     if (!db_connection || !db_connection->is_open()) {
         throw std::runtime_error("Invalid database connection provided to CollectionManager");
     }
+    if (!pipeline) {
+        throw std::runtime_error("No batch connection provided to CollectionManager");
+    }
 }
 
 // ========== Collection CRUD Operations ==========
@@ -43,35 +53,27 @@ CollectionManager::CollectionManager(std::shared_ptr<pqxx::connection> connectio
 int CollectionManager::createCollection(int owner_id, const std::string& name, 
                                        const std::string& description, bool is_public) {
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
-        // Check if user already has a collection with this name
-        std::string check_query = R"(
-            SELECT COUNT(*) FROM collections 
-            WHERE owner_id = $1 AND name = $2
-        )";
-        
-        pqxx::result check_result = txn.exec_params(check_query, owner_id, name);
-        if (check_result[0][0].as<int>() > 0) {
-            std::cerr << "Collection with name '" << name << "' already exists for user " << owner_id << std::endl;
-            return -1;
-        }
-        
-        // Insert new collection
+        // Insert unless the user already has a collection with this name; the
+        // check is part of the statement, so it costs no extra round trip
         std::string insert_query = R"(
             INSERT INTO collections (name, description, owner_id, is_public, created_at, updated_at)
-            VALUES ($1, $2, $3, $4, CURRENT_TIMESTAMP, CURRENT_TIMESTAMP)
+            SELECT $1, $2, $3::integer, $4::boolean, CURRENT_TIMESTAMP, CURRENT_TIMESTAMP
+            WHERE NOT EXISTS (SELECT 1 FROM collections WHERE owner_id = $3 AND name = $1)
             RETURNING id
         )";
         
         pqxx::result result = txn.exec_params(insert_query, name, description, owner_id, is_public);
         
         if (result.empty()) {
-            std::cerr << "Failed to create collection" << std::endl;
+            std::cerr << "Collection with name '" << name << "' already exists for user " << owner_id << std::endl;
             return -1;
         }
         
         int collection_id = result[0][0].as<int>();
+        notifyChange(txn, "collection", {{"id", collection_id}});
         txn.commit();
         
         std::cout << "Created collection '" << name << "' with ID " << collection_id 
@@ -91,36 +93,28 @@ int CollectionManager::createCollection(int owner_id, const std::string& name,
  * @return Collection object if accessible, nullopt otherwise
  */
 std::optional<Collection> CollectionManager::getCollection(int collection_id, int requesting_user_id) {
+    std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
     try {
-        pqxx::work txn(*db_connection);
-        
-        // Get collection with owner username and book count
-        std::string query = R"(
-            SELECT c.id, c.name, c.description, c.owner_id, u.username, 
-                   c.is_public, c.created_at, c.updated_at,
-                   COALESCE(book_count.count, 0) as book_count
-            FROM collections c
-            JOIN users u ON c.owner_id = u.id
-            LEFT JOIN (
-                SELECT collection_id, COUNT(*) as count 
-                FROM collection_books 
-                GROUP BY collection_id
-            ) book_count ON c.id = book_count.collection_id
-            WHERE c.id = $1
-        )";
-        
-        pqxx::result result = txn.exec_params(query, collection_id);
-        
-        if (result.empty()) {
-            return std::nullopt;
+        std::optional<Collection> collection;
+        {
+            pqxx::work txn(*db_connection);
+            
+            // Smart collections with an added-within rule drop aged-out books first
+            expireSmartMembership(txn, collection_id);
+            
+            // Get collection with owner username, book count and book IDs
+            std::string query = collectionListQuery(0) + "WHERE c.id = $1";
+            pqxx::result result = txn.exec_params(query, collection_id);
+            txn.commit();
+            
+            if (result.empty()) {
+                return std::nullopt;
+            }
+            collection = collectionFromRow(result[0]);
         }
         
-        auto row = result[0];
-        bool is_public = row["is_public"].as<bool>();
-        int owner_id = row["owner_id"].as<int>();
-        
         // Check if user has access
-        if (!is_public && owner_id != requesting_user_id) {
+        if (!collection->is_public && collection->owner_id != requesting_user_id) {
             // Check if user has explicit permission
             auto permission = getUserPermission(collection_id, requesting_user_id);
             if (!permission.has_value()) {
@@ -128,32 +122,6 @@ std::optional<Collection> CollectionManager::getCollection(int collection_id, in
             }
         }
         
-        // Get book IDs in this collection
-        std::string books_query = R"(
-            SELECT book_id FROM collection_books 
-            WHERE collection_id = $1 
-            ORDER BY added_at DESC
-        )";
-        
-        pqxx::result books_result = txn.exec_params(books_query, collection_id);
-        std::vector<int> book_ids;
-        for (const auto& book_row : books_result) {
-            book_ids.push_back(book_row["book_id"].as<int>());
-        }
-        
-        Collection collection{
-            .id = row["id"].as<int>(),
-            .name = row["name"].as<std::string>(),
-            .description = row["description"].is_null() ? "" : row["description"].as<std::string>(),
-            .owner_id = owner_id,
-            .owner_username = row["username"].as<std::string>(),
-            .is_public = is_public,
-            .created_at = row["created_at"].as<std::string>(),
-            .updated_at = row["updated_at"].as<std::string>(),
-            .book_ids = book_ids,
-            .book_count = row["book_count"].as<int>()
-        };
-        
         return collection;
         
     } catch (const std::exception& e) {
@@ -176,73 +144,85 @@ bool CollectionManager::updateCollection(int collection_id, int user_id,
                                         const std::string& description, 
                                         std::optional<bool> is_public) {
     try {
-        // Check if user has EDIT permission
-        if (!hasPermission(collection_id, user_id, CollectionPermission::EDIT)) {
-            std::cerr << "User " << user_id << " does not have EDIT permission for collection " 
-                      << collection_id << std::endl;
-            return false;
-        }
-        
-        pqxx::work txn(*db_connection);
-        
-        // Build dynamic update query
+        // $1 = collection, $2 = user, then the new values
+        std::vector<std::optional<std::string>> params = {std::to_string(collection_id), std::to_string(user_id)};
         std::vector<std::string> updates;
-        std::vector<std::string> params;
-        int param_count = 1;
         
         if (!name.empty()) {
-            // Check for name uniqueness within user's collections
-            std::string check_query = R"(
-                SELECT COUNT(*) FROM collections 
-                WHERE owner_id = (SELECT owner_id FROM collections WHERE id = $1) 
-                AND name = $2 AND id != $1
-            )";
-            
-            pqxx::result check_result = txn.exec_params(check_query, collection_id, name);
-            if (check_result[0][0].as<int>() > 0) {
-                std::cerr << "Collection name '" << name << "' already exists for this user" << std::endl;
-                return false;
-            }
-            
-            updates.push_back("name = $" + std::to_string(++param_count));
             params.push_back(name);
+            updates.push_back("name = $" + std::to_string(params.size()));
         }
         
         if (!description.empty()) {
-            updates.push_back("description = $" + std::to_string(++param_count));
             params.push_back(description);
+            updates.push_back("description = $" + std::to_string(params.size()));
         }
         
         if (is_public.has_value()) {
-            updates.push_back("is_public = $" + std::to_string(++param_count));
             params.push_back(is_public.value() ? "true" : "false");
+            updates.push_back("is_public = $" + std::to_string(params.size()));
         }
         
         if (updates.empty()) {
-            return true; // Nothing to update
+            return hasPermission(collection_id, user_id, CollectionPermission::EDIT); // Nothing to update
         }
         
         updates.push_back("updated_at = CURRENT_TIMESTAMP");
         
-        std::string update_query = "UPDATE collections SET " + 
+        // EDIT permission, and the new name must be unique within the owner's collections
+        std::string can_edit = R"((c.owner_id = $2 OR EXISTS (
+                SELECT 1 FROM collection_permissions cp
+                WHERE cp.collection_id = c.id AND cp.user_id = $2 AND cp.permission_type IN ('edit', 'admin'))))";
+        std::string name_taken = name.empty() ? "false" : R"(EXISTS (
+                SELECT 1 FROM collections other
+                WHERE other.owner_id = c.owner_id AND other.name = $3 AND other.id <> c.id))";
+        
+        std::string update_query = "UPDATE collections c SET " + 
                                  std::accumulate(updates.begin(), updates.end(), std::string{},
                                                [](const std::string& a, const std::string& b) {
                                                    return a.empty() ? b : a + ", " + b;
                                                }) +
-                                 " WHERE id = $1";
-        
-        // Execute update with parameters
-        if (params.empty()) {
-            txn.exec_params(update_query, collection_id);
-        } else if (params.size() == 1) {
-            txn.exec_params(update_query, collection_id, params[0]);
-        } else if (params.size() == 2) {
-            txn.exec_params(update_query, collection_id, params[0], params[1]);
-        } else if (params.size() == 3) {
-            txn.exec_params(update_query, collection_id, params[0], params[1], params[2]);
+                                 " WHERE c.id = $1 AND " + can_edit + " AND NOT " + name_taken +
+                                 " RETURNING c.id";
+        
+        // Other instances are only told about an update that happened: the
+        // notify reads the updated row, so a refused update sends nothing
+        std::vector<std::optional<std::string>> update_params = params;
+        std::string notify = "id";
+        if (invalidations) {
+            update_params.push_back(std::string(InvalidationBus::CHANNEL));
+            update_params.push_back(invalidations->payload("collection", {{"id", collection_id}}));
+            notify = "pg_notify($" + std::to_string(update_params.size() - 1) + ", $" +
+                     std::to_string(update_params.size()) + ")";
+        }
+        
+        // The checks and the guarded update go out in one round trip; the
+        // checks only tell us why nothing was updated
+        std::vector<std::optional<std::string>> check_params(params.begin(), params.begin() + (name.empty() ? 2 : 3));
+        std::vector<PgPipeline::Statement> statements = {
+            {"SELECT " + can_edit + ", " + name_taken + " FROM collections c WHERE c.id = $1", check_params},
+            {"WITH updated AS (" + update_query + ") SELECT " + notify + " FROM updated", update_params}};
+        std::vector<PgPipeline::Result> results = pipeline->run(statements);
+        for (const auto& result : results) {
+            if (!result.ok) {
+                throw std::runtime_error(result.error);
+            }
+        }
+        
+        const PgPipeline::Result& checks = results[0];
+        if (checks.rows.empty() || checks.rows[0][0] != "t") {
+            std::cerr << "User " << user_id << " does not have EDIT permission for collection " 
+                      << collection_id << std::endl;
+            return false;
+        }
+        if (checks.rows[0][1] == "t") {
+            std::cerr << "Collection name '" << name << "' already exists for this user" << std::endl;
+            return false;
+        }
+        if (results[1].rows.empty()) {
+            return false;
         }
         
-        txn.commit();
         std::cout << "Updated collection " << collection_id << std::endl;
         return true;
         
@@ -268,6 +248,7 @@ bool CollectionManager::deleteCollection(int collection_id, int user_id) {
             return false;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         // Delete collection (CASCADE will handle related records)
@@ -279,6 +260,7 @@ bool CollectionManager::deleteCollection(int collection_id, int user_id) {
             return false;
         }
         
+        notifyChange(txn, "collection", {{"id", collection_id}});
         txn.commit();
         std::cout << "Deleted collection " << collection_id << std::endl;
         return true;
@@ -289,6 +271,265 @@ bool CollectionManager::deleteCollection(int collection_id, int user_id) {
     }
 }
 
+// ========== Smart Collections ==========
+
+namespace {
+
+/**
+ * @brief SQL condition: book b satisfies the smart_rules of collection c
+ * 
+ * Shared by every statement that maintains smart membership so that
+ * ingest-time, rebuild and expiry evaluation can never disagree.
+ */
+const char* const SMART_RULES_MATCH = R"(
+    (NOT (c.smart_rules ? 'authors')
+        OR lower(b.author) IN (SELECT lower(value) FROM jsonb_array_elements_text(c.smart_rules->'authors')))
+    AND (NOT (c.smart_rules ? 'languages')
+        OR b.language IN (SELECT value FROM jsonb_array_elements_text(c.smart_rules->'languages')))
+    AND (NOT (c.smart_rules ? 'file_types')
+        OR b.file_type IN (SELECT value FROM jsonb_array_elements_text(c.smart_rules->'file_types')))
+    AND (NOT (c.smart_rules ? 'added_within_days')
+        OR b.uploaded_at >= CURRENT_TIMESTAMP - make_interval(days => (c.smart_rules->>'added_within_days')::int))
+    AND (NOT COALESCE((c.smart_rules->>'unread')::boolean, false)
+        OR NOT EXISTS (SELECT 1 FROM user_book_progress p WHERE p.user_id = c.owner_id AND p.book_id = b.id))
+)";
+
+} // namespace
+
+/**
+ * @brief Serialize smart rules, leaving out rules that are not set
+ * @return JSON object for the smart_rules column
+ */
+nlohmann::json SmartRules::toJson() const {
+    nlohmann::json json = nlohmann::json::object();
+    if (!authors.empty()) {
+        json["authors"] = authors;
+    }
+    if (!languages.empty()) {
+        json["languages"] = languages;
+    }
+    if (!file_types.empty()) {
+        json["file_types"] = file_types;
+    }
+    if (added_within_days > 0) {
+        json["added_within_days"] = added_within_days;
+    }
+    if (unread) {
+        json["unread"] = true;
+    }
+    return json;
+}
+
+/**
+ * @brief Parse smart rules from JSON
+ * @param json JSON object as produced by toJson()
+ * @return Parsed rules
+ */
+SmartRules SmartRules::fromJson(const nlohmann::json& json) {
+    SmartRules rules;
+    rules.authors = json.value("authors", std::vector<std::string>{});
+    rules.languages = json.value("languages", std::vector<std::string>{});
+    rules.file_types = json.value("file_types", std::vector<std::string>{});
+    rules.added_within_days = std::max(0, json.value("added_within_days", 0));
+    rules.unread = json.value("unread", false);
+    return rules;
+}
+
+/**
+ * @brief Create a rule-based collection and materialize its membership
+ * @param owner_id User ID of the collection owner
+ * @param name Collection name (must be unique per user)
+ * @param rules Membership rules
+ * @param description Optional description
+ * @param is_public Whether collection should be publicly visible
+ * @return Collection ID on success, -1 on failure
+ */
+int CollectionManager::createSmartCollection(int owner_id, const std::string& name, const SmartRules& rules,
+                                            const std::string& description, bool is_public) {
+    std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
+    int collection_id = createCollection(owner_id, name, description, is_public);
+    if (collection_id == -1) {
+        return -1;
+    }
+    
+    try {
+        pqxx::work txn(*db_connection);
+        txn.exec_params("UPDATE collections SET smart_rules = $2::jsonb WHERE id = $1",
+                        collection_id, rules.toJson().dump());
+        materializeSmartCollection(txn, collection_id);
+        notifyChange(txn, "collection", {{"id", collection_id}});
+        txn.commit();
+        
+        std::cout << "Created smart collection '" << name << "' with ID " << collection_id << std::endl;
+        return collection_id;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error creating smart collection: " << e.what() << std::endl;
+        // Don't leave a half-created collection behind as a manual one
+        try {
+            pqxx::work cleanup(*db_connection);
+            cleanup.exec_params("DELETE FROM collections WHERE id = $1", collection_id);
+            cleanup.commit();
+        } catch (const std::exception&) {
+        }
+        return -1;
+    }
+}
+
+/**
+ * @brief Replace the rules of a smart collection and rebuild its membership
+ * @param collection_id Smart collection to update
+ * @param user_id User performing the update
+ * @param rules New membership rules
+ * @return true on success, false on failure
+ */
+bool CollectionManager::updateSmartRules(int collection_id, int user_id, const SmartRules& rules) {
+    std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
+    try {
+        // Check if user has EDIT permission
+        if (!hasPermission(collection_id, user_id, CollectionPermission::EDIT)) {
+            std::cerr << "User " << user_id << " does not have EDIT permission for collection " 
+                      << collection_id << std::endl;
+            return false;
+        }
+        
+        pqxx::work txn(*db_connection);
+        if (!isSmartCollection(txn, collection_id)) {
+            std::cerr << "Collection " << collection_id << " is not a smart collection" << std::endl;
+            return false;
+        }
+        
+        txn.exec_params("UPDATE collections SET smart_rules = $2::jsonb, updated_at = CURRENT_TIMESTAMP WHERE id = $1",
+                        collection_id, rules.toJson().dump());
+        materializeSmartCollection(txn, collection_id);
+        notifyChange(txn, "collection", {{"id", collection_id}});
+        txn.commit();
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error updating smart rules: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Get the rules of a smart collection
+ * @param collection_id Collection identifier
+ * @return Rules, or nullopt if the collection is not smart
+ */
+std::optional<SmartRules> CollectionManager::getSmartRules(int collection_id) {
+    std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
+    try {
+        pqxx::work txn(*db_connection);
+        pqxx::result result = txn.exec_params(
+            "SELECT smart_rules FROM collections WHERE id = $1 AND smart_rules IS NOT NULL", collection_id);
+        if (result.empty()) {
+            return std::nullopt;
+        }
+        return SmartRules::fromJson(nlohmann::json::parse(result[0][0].as<std::string>()));
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error getting smart rules: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Re-evaluate one book against every smart collection
+ * @param book_id Book that was added, changed or opened
+ */
+void CollectionManager::refreshSmartMembership(int book_id) {
+    std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
+    try {
+        pqxx::work txn(*db_connection);
+        
+        // Leave smart collections whose rules the book no longer satisfies
+        pqxx::result left = txn.exec_params(std::string(R"(
+            DELETE FROM collection_books cb
+            USING collections c, books b
+            WHERE cb.book_id = $1
+              AND c.id = cb.collection_id AND c.smart_rules IS NOT NULL
+              AND b.id = cb.book_id
+              AND NOT )") + SMART_RULES_MATCH, book_id);
+        
+        // Join those it now satisfies
+        pqxx::result joined = txn.exec_params(std::string(R"(
+            INSERT INTO collection_books (collection_id, book_id, added_at)
+            SELECT c.id, b.id, CURRENT_TIMESTAMP
+            FROM collections c
+            JOIN books b ON b.id = $1
+            WHERE c.smart_rules IS NOT NULL
+              AND )") + SMART_RULES_MATCH + R"(
+            ON CONFLICT (collection_id, book_id) DO NOTHING
+        )", book_id);
+        
+        // Runs on every ingest and on a book's first progress save, which
+        // mostly change nothing; only announce actual changes
+        if (left.affected_rows() + joined.affected_rows() > 0) {
+            notifyChange(txn, "collection_books", {{"book_id", book_id}});
+        }
+        txn.commit();
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error refreshing smart collections for book " << book_id << ": " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Rebuild the membership of one smart collection from its rules
+ * @param txn Open transaction
+ * @param collection_id Smart collection
+ */
+void CollectionManager::materializeSmartCollection(pqxx::work& txn, int collection_id) {
+    txn.exec_params(std::string(R"(
+        DELETE FROM collection_books cb
+        USING collections c, books b
+        WHERE cb.collection_id = $1
+          AND c.id = cb.collection_id
+          AND b.id = cb.book_id
+          AND NOT )") + SMART_RULES_MATCH, collection_id);
+    
+    txn.exec_params(std::string(R"(
+        INSERT INTO collection_books (collection_id, book_id, added_at)
+        SELECT c.id, b.id, CURRENT_TIMESTAMP
+        FROM collections c
+        CROSS JOIN books b
+        WHERE c.id = $1 AND c.smart_rules IS NOT NULL
+          AND )") + SMART_RULES_MATCH + R"(
+        ON CONFLICT (collection_id, book_id) DO NOTHING
+    )", collection_id);
+}
+
+/**
+ * @brief Drop books that aged out of an added-within rule
+ * @param txn Open transaction
+ * @param collection_id Collection about to be read
+ */
+void CollectionManager::expireSmartMembership(pqxx::work& txn, int collection_id) {
+    // Time is the only rule input that changes without an event, so this is
+    // the only part of smart membership that is checked on read
+    txn.exec_params(R"(
+        DELETE FROM collection_books cb
+        USING collections c, books b
+        WHERE cb.collection_id = $1
+          AND c.id = cb.collection_id AND c.smart_rules ? 'added_within_days'
+          AND b.id = cb.book_id
+          AND b.uploaded_at < CURRENT_TIMESTAMP - make_interval(days => (c.smart_rules->>'added_within_days')::int)
+    )", collection_id);
+}
+
+/**
+ * @brief Check whether a collection is rule-based
+ * @param txn Open transaction
+ * @param collection_id Collection identifier
+ * @return true if the collection has smart rules
+ */
+bool CollectionManager::isSmartCollection(pqxx::work& txn, int collection_id) {
+    pqxx::result result = txn.exec_params(
+        "SELECT 1 FROM collections WHERE id = $1 AND smart_rules IS NOT NULL", collection_id);
+    return !result.empty();
+}
+
 // ========== Collection Discovery ==========
 
 /**
@@ -300,19 +541,10 @@ std::vector<Collection> CollectionManager::getUserCollections(int user_id) {
     std::vector<Collection> collections;
     
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
-        std::string query = R"(
-            SELECT c.id, c.name, c.description, c.owner_id, u.username, 
-                   c.is_public, c.created_at, c.updated_at,
-                   COALESCE(book_count.count, 0) as book_count
-            FROM collections c
-            JOIN users u ON c.owner_id = u.id
-            LEFT JOIN (
-                SELECT collection_id, COUNT(*) as count 
-                FROM collection_books 
-                GROUP BY collection_id
-            ) book_count ON c.id = book_count.collection_id
+        std::string query = collectionListQuery(0) + R"(
             WHERE c.owner_id = $1
             ORDER BY c.updated_at DESC
         )";
@@ -320,33 +552,7 @@ std::vector<Collection> CollectionManager::getUserCollections(int user_id) {
         pqxx::result result = txn.exec_params(query, user_id);
         
         for (const auto& row : result) {
-            // Get book IDs for each collection
-            std::string books_query = R"(
-                SELECT book_id FROM collection_books 
-                WHERE collection_id = $1 
-                ORDER BY added_at DESC
-            )";
-            
-            pqxx::result books_result = txn.exec_params(books_query, row["id"].as<int>());
-            std::vector<int> book_ids;
-            for (const auto& book_row : books_result) {
-                book_ids.push_back(book_row["book_id"].as<int>());
-            }
-            
-            Collection collection{
-                .id = row["id"].as<int>(),
-                .name = row["name"].as<std::string>(),
-                .description = row["description"].is_null() ? "" : row["description"].as<std::string>(),
-                .owner_id = row["owner_id"].as<int>(),
-                .owner_username = row["username"].as<std::string>(),
-                .is_public = row["is_public"].as<bool>(),
-                .created_at = row["created_at"].as<std::string>(),
-                .updated_at = row["updated_at"].as<std::string>(),
-                .book_ids = book_ids,
-                .book_count = row["book_count"].as<int>()
-            };
-            
-            collections.push_back(collection);
+            collections.push_back(collectionFromRow(row));
         }
         
     } catch (const std::exception& e) {
@@ -365,23 +571,16 @@ std::vector<Collection> CollectionManager::getAccessibleCollections(int user_id)
     std::vector<Collection> collections;
     
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
-        std::string query = R"(
-            SELECT DISTINCT c.id, c.name, c.description, c.owner_id, u.username, 
-                   c.is_public, c.created_at, c.updated_at,
-                   COALESCE(book_count.count, 0) as book_count
-            FROM collections c
-            JOIN users u ON c.owner_id = u.id
-            LEFT JOIN (
-                SELECT collection_id, COUNT(*) as count 
-                FROM collection_books 
-                GROUP BY collection_id
-            ) book_count ON c.id = book_count.collection_id
-            LEFT JOIN collection_permissions cp ON c.id = cp.collection_id AND cp.user_id = $1
+        std::string query = collectionListQuery(10) + R"(
             WHERE c.owner_id = $1 
                OR c.is_public = true 
-               OR cp.user_id = $1
+               OR EXISTS (
+                   SELECT 1 FROM collection_permissions cp 
+                   WHERE cp.collection_id = c.id AND cp.user_id = $1
+               )
             ORDER BY 
                 CASE WHEN c.owner_id = $1 THEN 0 ELSE 1 END,
                 c.updated_at DESC
@@ -390,34 +589,7 @@ std::vector<Collection> CollectionManager::getAccessibleCollections(int user_id)
         pqxx::result result = txn.exec_params(query, user_id);
         
         for (const auto& row : result) {
-            // Get book IDs for each collection
-            std::string books_query = R"(
-                SELECT book_id FROM collection_books 
-                WHERE collection_id = $1 
-                ORDER BY added_at DESC
-                LIMIT 10
-            )";
-            
-            pqxx::result books_result = txn.exec_params(books_query, row["id"].as<int>());
-            std::vector<int> book_ids;
-            for (const auto& book_row : books_result) {
-                book_ids.push_back(book_row["book_id"].as<int>());
-            }
-            
-            Collection collection{
-                .id = row["id"].as<int>(),
-                .name = row["name"].as<std::string>(),
-                .description = row["description"].is_null() ? "" : row["description"].as<std::string>(),
-                .owner_id = row["owner_id"].as<int>(),
-                .owner_username = row["username"].as<std::string>(),
-                .is_public = row["is_public"].as<bool>(),
-                .created_at = row["created_at"].as<std::string>(),
-                .updated_at = row["updated_at"].as<std::string>(),
-                .book_ids = book_ids,
-                .book_count = row["book_count"].as<int>()
-            };
-            
-            collections.push_back(collection);
+            collections.push_back(collectionFromRow(row));
         }
         
     } catch (const std::exception& e) {
@@ -437,55 +609,19 @@ std::vector<Collection> CollectionManager::getPublicCollections(int limit, int o
     std::vector<Collection> collections;
     
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
-        std::string query = R"(
-            SELECT c.id, c.name, c.description, c.owner_id, u.username, 
-                   c.is_public, c.created_at, c.updated_at,
-                   COALESCE(book_count.count, 0) as book_count
-            FROM collections c
-            JOIN users u ON c.owner_id = u.id
-            LEFT JOIN (
-                SELECT collection_id, COUNT(*) as count 
-                FROM collection_books 
-                GROUP BY collection_id
-            ) book_count ON c.id = book_count.collection_id
+        std::string query = collectionListQuery(5) + R"(
             WHERE c.is_public = true
-            ORDER BY c.created_at DESC
+            ORDER BY c.created_at DESC, c.id DESC
             LIMIT $1 OFFSET $2
         )";
         
         pqxx::result result = txn.exec_params(query, limit, offset);
         
         for (const auto& row : result) {
-            // Get first few book IDs for preview
-            std::string books_query = R"(
-                SELECT book_id FROM collection_books 
-                WHERE collection_id = $1 
-                ORDER BY added_at DESC
-                LIMIT 5
-            )";
-            
-            pqxx::result books_result = txn.exec_params(books_query, row["id"].as<int>());
-            std::vector<int> book_ids;
-            for (const auto& book_row : books_result) {
-                book_ids.push_back(book_row["book_id"].as<int>());
-            }
-            
-            Collection collection{
-                .id = row["id"].as<int>(),
-                .name = row["name"].as<std::string>(),
-                .description = row["description"].is_null() ? "" : row["description"].as<std::string>(),
-                .owner_id = row["owner_id"].as<int>(),
-                .owner_username = row["username"].as<std::string>(),
-                .is_public = row["is_public"].as<bool>(),
-                .created_at = row["created_at"].as<std::string>(),
-                .updated_at = row["updated_at"].as<std::string>(),
-                .book_ids = book_ids,
-                .book_count = row["book_count"].as<int>()
-            };
-            
-            collections.push_back(collection);
+            collections.push_back(collectionFromRow(row));
         }
         
     } catch (const std::exception& e) {
@@ -495,6 +631,107 @@ std::vector<Collection> CollectionManager::getPublicCollections(int limit, int o
     return collections;
 }
 
+/**
+ * @brief Splits a page cursor into the position of the last row it points after
+ * @param cursor "<created_at>|<id>", created_at as "YYYY-MM-DD HH:MM:SS[.ffffff]"
+ * @param created_at Receives the timestamp
+ * @param id Receives the collection ID
+ * @return true if the cursor is well formed
+ */
+bool CollectionManager::parsePageCursor(const std::string& cursor, std::string& created_at, int& id) {
+    size_t separator = cursor.rfind('|');
+    if (separator == std::string::npos) {
+        return false;
+    }
+    
+    std::string id_str = cursor.substr(separator + 1);
+    if (id_str.empty() || id_str.size() > 9 || id_str.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    
+    // Fixed layout, digits everywhere but the separators, fields within their ranges
+    std::string timestamp = cursor.substr(0, separator);
+    static const std::string layout = "dddd-dd-dd dd:dd:dd";
+    if (timestamp.size() < layout.size() || timestamp.size() > layout.size() + 7) {
+        return false;
+    }
+    for (size_t i = 0; i < timestamp.size(); i++) {
+        char expected = i < layout.size() ? layout[i] : (i == layout.size() ? '.' : 'd');
+        bool ok = expected == 'd' ? std::isdigit(static_cast<unsigned char>(timestamp[i])) != 0
+                                  : timestamp[i] == expected;
+        if (!ok || (i == layout.size() && timestamp.size() == layout.size() + 1)) {
+            return false;
+        }
+    }
+    auto field = [&](size_t pos, size_t length) { return std::stoi(timestamp.substr(pos, length)); };
+    std::chrono::year_month_day date{std::chrono::year{field(0, 4)},
+                                     std::chrono::month{static_cast<unsigned>(field(5, 2))},
+                                     std::chrono::day{static_cast<unsigned>(field(8, 2))}};
+    if (!date.ok() || field(11, 2) > 23 || field(14, 2) > 59 || field(17, 2) > 59) {
+        return false;
+    }
+    
+    created_at = timestamp;
+    id = std::stoi(id_str);
+    return true;
+}
+
+/**
+ * @brief Get a page of public collections by cursor
+ * @param limit Maximum number of collections to return
+ * @param cursor next_cursor of the previous page, empty for the first page
+ * @return Collections plus the cursor of the following page
+ */
+CollectionPage CollectionManager::getPublicCollectionsPage(int limit, const std::string& cursor) {
+    CollectionPage page;
+    limit = std::max(limit, 1);
+    
+    try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
+        pqxx::work txn(*db_connection);
+        
+        // Callers validate cursors; one that still doesn't parse restarts at the first page
+        std::string after_created_at;
+        int after_id = 0;
+        if (!cursor.empty() && !parsePageCursor(cursor, after_created_at, after_id)) {
+            after_created_at.clear();
+        }
+        
+        // One extra row tells whether there is a next page
+        pqxx::result result;
+        if (after_created_at.empty()) {
+            std::string query = collectionListQuery(5) + R"(
+                WHERE c.is_public = true
+                ORDER BY c.created_at DESC, c.id DESC
+                LIMIT $1
+            )";
+            result = txn.exec_params(query, limit + 1);
+        } else {
+            std::string query = collectionListQuery(5) + R"(
+                WHERE c.is_public = true
+                  AND (c.created_at, c.id) < ($2::timestamp, $3)
+                ORDER BY c.created_at DESC, c.id DESC
+                LIMIT $1
+            )";
+            result = txn.exec_params(query, limit + 1, after_created_at, after_id);
+        }
+        
+        for (const auto& row : result) {
+            if (static_cast<int>(page.collections.size()) == limit) {
+                const Collection& last = page.collections.back();
+                page.next_cursor = last.created_at + "|" + std::to_string(last.id);
+                break;
+            }
+            page.collections.push_back(collectionFromRow(row));
+        }
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error getting public collections page: " << e.what() << std::endl;
+    }
+    
+    return page;
+}
+
 /**
  * @brief Search collections by name
  * @param query Search term
@@ -507,40 +744,25 @@ std::vector<Collection> CollectionManager::searchCollections(const std::string&
     std::vector<Collection> collections;
     
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         std::string sql_query;
         if (search_public_only) {
-            sql_query = R"(
-                SELECT c.id, c.name, c.description, c.owner_id, u.username, 
-                       c.is_public, c.created_at, c.updated_at,
-                       COALESCE(book_count.count, 0) as book_count
-                FROM collections c
-                JOIN users u ON c.owner_id = u.id
-                LEFT JOIN (
-                    SELECT collection_id, COUNT(*) as count 
-                    FROM collection_books 
-                    GROUP BY collection_id
-                ) book_count ON c.id = book_count.collection_id
+            sql_query = collectionListQuery(5) + R"(
                 WHERE c.is_public = true 
                   AND (LOWER(c.name) LIKE LOWER($1) OR LOWER(c.description) LIKE LOWER($1))
                 ORDER BY c.updated_at DESC
                 LIMIT 50
             )";
         } else {
-            sql_query = R"(
-                SELECT DISTINCT c.id, c.name, c.description, c.owner_id, u.username, 
-                       c.is_public, c.created_at, c.updated_at,
-                       COALESCE(book_count.count, 0) as book_count
-                FROM collections c
-                JOIN users u ON c.owner_id = u.id
-                LEFT JOIN (
-                    SELECT collection_id, COUNT(*) as count 
-                    FROM collection_books 
-                    GROUP BY collection_id
-                ) book_count ON c.id = book_count.collection_id
-                LEFT JOIN collection_permissions cp ON c.id = cp.collection_id AND cp.user_id = $2
-                WHERE (c.owner_id = $2 OR c.is_public = true OR cp.user_id = $2)
+            sql_query = collectionListQuery(5) + R"(
+                WHERE (c.owner_id = $2 
+                       OR c.is_public = true 
+                       OR EXISTS (
+                           SELECT 1 FROM collection_permissions cp 
+                           WHERE cp.collection_id = c.id AND cp.user_id = $2
+                       ))
                   AND (LOWER(c.name) LIKE LOWER($1) OR LOWER(c.description) LIKE LOWER($1))
                 ORDER BY 
                     CASE WHEN c.owner_id = $2 THEN 0 ELSE 1 END,
@@ -559,34 +781,7 @@ std::vector<Collection> CollectionManager::searchCollections(const std::string&
         }
         
         for (const auto& row : result) {
-            // Get first few book IDs for preview
-            std::string books_query = R"(
-                SELECT book_id FROM collection_books 
-                WHERE collection_id = $1 
-                ORDER BY added_at DESC
-                LIMIT 5
-            )";
-            
-            pqxx::result books_result = txn.exec_params(books_query, row["id"].as<int>());
-            std::vector<int> book_ids;
-            for (const auto& book_row : books_result) {
-                book_ids.push_back(book_row["book_id"].as<int>());
-            }
-            
-            Collection collection{
-                .id = row["id"].as<int>(),
-                .name = row["name"].as<std::string>(),
-                .description = row["description"].is_null() ? "" : row["description"].as<std::string>(),
-                .owner_id = row["owner_id"].as<int>(),
-                .owner_username = row["username"].as<std::string>(),
-                .is_public = row["is_public"].as<bool>(),
-                .created_at = row["created_at"].as<std::string>(),
-                .updated_at = row["updated_at"].as<std::string>(),
-                .book_ids = book_ids,
-                .book_count = row["book_count"].as<int>()
-            };
-            
-            collections.push_back(collection);
+            collections.push_back(collectionFromRow(row));
         }
         
     } catch (const std::exception& e) {
@@ -614,8 +809,15 @@ bool CollectionManager::addBookToCollection(int collection_id, int book_id, int
             return false;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
+        // Smart collection membership comes from its rules only
+        if (isSmartCollection(txn, collection_id)) {
+            std::cerr << "Collection " << collection_id << " is a smart collection; books cannot be added manually" << std::endl;
+            return false;
+        }
+        
         // Check if book exists
         std::string book_check_query = "SELECT COUNT(*) FROM books WHERE id = $1";
         pqxx::result book_check = txn.exec_params(book_check_query, book_id);
@@ -645,6 +847,7 @@ bool CollectionManager::addBookToCollection(int collection_id, int book_id, int
         // Update collection timestamp
         updateCollectionTimestamp(collection_id);
         
+        notifyChange(txn, "collection", {{"id", collection_id}});
         txn.commit();
         std::cout << "Added book " << book_id << " to collection " << collection_id 
                   << " by user " << user_id << std::endl;
@@ -665,8 +868,15 @@ bool CollectionManager::addBookToCollection(int collection_id, int book_id, int
  */
 bool CollectionManager::removeBookFromCollection(int collection_id, int book_id, int user_id) {
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
+        // Smart collection membership comes from its rules only
+        if (isSmartCollection(txn, collection_id)) {
+            std::cerr << "Collection " << collection_id << " is a smart collection; books cannot be removed manually" << std::endl;
+            return false;
+        }
+        
         // Check if user has permission (ADD_BOOKS or higher, or user who added the book)
         bool has_permission = hasPermission(collection_id, user_id, CollectionPermission::ADD_BOOKS);
         
@@ -706,6 +916,7 @@ bool CollectionManager::removeBookFromCollection(int collection_id, int book_id,
         // Update collection timestamp
         updateCollectionTimestamp(collection_id);
         
+        notifyChange(txn, "collection", {{"id", collection_id}});
         txn.commit();
         std::cout << "Removed book " << book_id << " from collection " << collection_id 
                   << " by user " << user_id << std::endl;
@@ -734,6 +945,7 @@ std::vector<CollectionBook> CollectionManager::getCollectionBooks(int collection
             return books;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         std::string query = R"(
@@ -783,6 +995,7 @@ bool CollectionManager::isBookInCollection(int collection_id, int book_id, int u
             return false;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         std::string query = R"(
@@ -826,6 +1039,7 @@ bool CollectionManager::grantPermission(int collection_id, int user_id,
             return false;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         // Check if user exists
@@ -850,6 +1064,7 @@ bool CollectionManager::grantPermission(int collection_id, int user_id,
         )";
         
         txn.exec_params(upsert_query, collection_id, user_id, permission_str, granting_user_id);
+        notifyChange(txn, "collection", {{"id", collection_id}, {"user_id", user_id}});
         txn.commit();
         
         std::cout << "Granted " << permission_str << " permission to user " << user_id 
@@ -885,6 +1100,7 @@ bool CollectionManager::revokePermission(int collection_id, int user_id, int rev
             return false;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         std::string delete_query = R"(
@@ -900,6 +1116,7 @@ bool CollectionManager::revokePermission(int collection_id, int user_id, int rev
             return false;
         }
         
+        notifyChange(txn, "collection", {{"id", collection_id}, {"user_id", user_id}});
         txn.commit();
         
         std::cout << "Revoked permission from user " << user_id 
@@ -920,6 +1137,7 @@ bool CollectionManager::revokePermission(int collection_id, int user_id, int rev
  */
 std::optional<CollectionPermission> CollectionManager::getUserPermission(int collection_id, int user_id) {
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         // Check if user is the owner (highest permission)
@@ -980,6 +1198,7 @@ std::vector<CollectionUserPermission> CollectionManager::getCollectionPermission
             return permissions;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         std::string query = R"(
@@ -1063,6 +1282,7 @@ nlohmann::json CollectionManager::getCollectionStatistics(int collection_id, int
             return stats;
         }
         
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         // Basic collection info
@@ -1195,6 +1415,7 @@ bool CollectionManager::hasPermission(int collection_id, int user_id, Collection
  */
 int CollectionManager::getCollectionOwner(int collection_id) {
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         std::string query = "SELECT owner_id FROM collections WHERE id = $1";
@@ -1212,12 +1433,25 @@ int CollectionManager::getCollectionOwner(int collection_id) {
     }
 }
 
+/**
+ * @brief Announce a change to other server instances when txn commits
+ * @param txn Transaction making the change
+ * @param kind Event kind
+ * @param fields Event fields
+ */
+void CollectionManager::notifyChange(pqxx::work& txn, const std::string& kind, const nlohmann::json& fields) {
+    if (invalidations) {
+        txn.exec_params("SELECT pg_notify($1, $2)", InvalidationBus::CHANNEL, invalidations->payload(kind, fields));
+    }
+}
+
 /**
  * @brief Update collection's last modified timestamp
  * @param collection_id Collection to update
  */
 void CollectionManager::updateCollectionTimestamp(int collection_id) {
     try {
+        std::lock_guard<std::recursive_mutex> connection_lock(connection_mutex);
         pqxx::work txn(*db_connection);
         
         std::string query = "UPDATE collections SET updated_at = CURRENT_TIMESTAMP WHERE id = $1";
@@ -1228,3 +1462,64 @@ void CollectionManager::updateCollectionTimestamp(int collection_id) {
         std::cerr << "Error updating collection timestamp: " << e.what() << std::endl;
     }
 }
+
+/**
+ * @brief Build the shared SELECT for collection listings
+ * @param preview_limit Number of most recent book IDs to include, 0 for all
+ * @return Query text to be followed by WHERE/ORDER BY clauses
+ */
+std::string CollectionManager::collectionListQuery(int preview_limit) {
+    std::string book_ids = "array_agg(cb.book_id ORDER BY cb.added_at DESC)";
+    if (preview_limit > 0) {
+        book_ids = "(" + book_ids + ")[1:" + std::to_string(preview_limit) + "]";
+    }
+    
+    // One lateral aggregate per collection replaces a book_ids query per row
+    return R"(
+        SELECT c.id, c.name, c.description, c.owner_id, u.username, 
+               c.is_public, c.created_at, c.updated_at,
+               books.book_count,
+               COALESCE(books.book_ids, '{}') as book_ids,
+               c.smart_rules IS NOT NULL as is_smart
+        FROM collections c
+        JOIN users u ON c.owner_id = u.id
+        LEFT JOIN LATERAL (
+            SELECT COUNT(*) as book_count, )" + book_ids + R"( as book_ids
+            FROM collection_books cb
+            WHERE cb.collection_id = c.id
+        ) books ON true
+    )";
+}
+
+/**
+ * @brief Decode a row of collectionListQuery() into a Collection
+ * @param row Result row
+ * @return Collection with its book ID preview
+ */
+Collection CollectionManager::collectionFromRow(const pqxx::row& row) {
+    // int[] arrives in text form: {1,2,3}
+    std::vector<int> book_ids;
+    std::string array_text = row["book_ids"].c_str();
+    for (size_t pos = 1; pos < array_text.size(); pos++) {
+        size_t end = array_text.find_first_of(",}", pos);
+        if (end == std::string::npos || end == pos) {
+            break;
+        }
+        book_ids.push_back(std::stoi(array_text.substr(pos, end - pos)));
+        pos = end;
+    }
+    
+    return Collection{
+        .id = row["id"].as<int>(),
+        .name = row["name"].as<std::string>(),
+        .description = row["description"].is_null() ? "" : row["description"].as<std::string>(),
+        .owner_id = row["owner_id"].as<int>(),
+        .owner_username = row["username"].as<std::string>(),
+        .is_public = row["is_public"].as<bool>(),
+        .created_at = row["created_at"].as<std::string>(),
+        .updated_at = row["updated_at"].as<std::string>(),
+        .book_ids = book_ids,
+        .book_count = row["book_count"].as<int>(),
+        .is_smart = row["is_smart"].as<bool>()
+    };
+}
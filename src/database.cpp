@@ -7,12 +7,28 @@
  */
 
 #include "database.h"
+#include "collation.h"
 #include "auth.h"
+#include "schema_migrator.h"
 #include <stdexcept>
 #include <iostream>
 #include <filesystem>
 
-Database::Database(const std::string& connection_string) {
+namespace {
+
+// Staleness a standby may have and still serve a read. Listings tolerate
+// more than progress, which a reader expects to follow them across devices
+constexpr double LISTING_MAX_STALENESS_SECONDS = 10.0;
+constexpr double PROGRESS_MAX_STALENESS_SECONDS = 2.0;
+
+// A standby admitted by either bound has every write older than this
+constexpr auto READ_YOUR_WRITES_WINDOW = std::chrono::seconds(10);
+
+} // namespace
+
+Database::Database(const std::string& connection_string,
+                   const std::vector<std::string>& replica_connection_strings,
+                   InvalidationBus* invalidation_bus) : invalidations(invalidation_bus) {
     try {
         conn = std::make_unique<pqxx::connection>(connection_string);
         if (!conn->is_open()) {
@@ -20,71 +36,24 @@ Database::Database(const std::string& connection_string) {
         }
         std::cout << "Connected to database successfully!" << std::endl;
         
-        create_tables_if_not_exists();
+        // One query when the schema is current, see SchemaMigrator
+        schema_version = SchemaMigrator(*conn).migrate();
         prepare_statements();
+        refresh_sort_keys();
+        
+        pipeline = std::make_unique<PgPipeline>(connection_string);
+        if (!replica_connection_strings.empty()) {
+            replicas = std::make_unique<ReplicaSet>(replica_connection_strings, pipeline.get());
+            std::cout << "Routing reads to " << replicas->size() << " standby(s)" << std::endl;
+        }
+        if (invalidations) {
+            invalidations->subscribe([this](const nlohmann::json& event) { on_remote_change(event); });
+        }
     } catch (const std::exception& e) {
         throw std::runtime_error("Database connection failed: " + std::string(e.what()));
     }
 }
 
-void Database::create_tables_if_not_exists() {
-    try {
-        pqxx::work txn(*conn);
-
-        // Create users table
-        txn.exec(R"(
-            CREATE TABLE IF NOT EXISTS users (
-                id SERIAL PRIMARY KEY,
-                username VARCHAR(50) UNIQUE NOT NULL,
-                password_hash VARCHAR(255) NOT NULL,
-                created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
-            )
-        )");
-
-        // Create books table
-        txn.exec(R"(
-            CREATE TABLE IF NOT EXISTS books (
-                id SERIAL PRIMARY KEY,
-                title VARCHAR(255) NOT NULL,
-                author VARCHAR(255),
-                file_path VARCHAR(500) UNIQUE NOT NULL,
-                file_type VARCHAR(10) NOT NULL,
-                file_size BIGINT NOT NULL DEFAULT 0,
-                uploaded_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-                description TEXT,
-                publisher VARCHAR(255),
-                isbn VARCHAR(20),
-                language VARCHAR(10) DEFAULT 'en',
-                thumbnail_path VARCHAR(500),
-                page_count INTEGER,
-                metadata_extracted BOOLEAN DEFAULT FALSE,
-                extraction_error TEXT
-            )
-        )");
-
-        // Create user_book_progress table
-        txn.exec(R"(
-            CREATE TABLE IF NOT EXISTS user_book_progress (
-                user_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,
-                book_id INTEGER NOT NULL REFERENCES books(id) ON DELETE CASCADE,
-                last_accessed_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-                progress_details JSONB,
-                PRIMARY KEY (user_id, book_id)
-            )
-        )");
-
-        // Create indexes for better performance
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_users_username ON users(username)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_books_file_path ON books(file_path)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_progress_user_id ON user_book_progress(user_id)");
-
-        txn.commit();
-        std::cout << "Database tables created or verified successfully." << std::endl;
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Failed to create tables: " + std::string(e.what()));
-    }
-}
-
 void Database::prepare_statements() {
     try {
         // User operations
@@ -99,31 +68,32 @@ void Database::prepare_statements() {
 
         // Book operations
         conn->prepare("insert_book", 
-            "INSERT INTO books (title, author, file_path, file_type, file_size, description, publisher, isbn, language, thumbnail_path, page_count, metadata_extracted, extraction_error) "
-            "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13) RETURNING id");
+            "INSERT INTO books (title, author, file_path, file_type, file_size, description, publisher, isbn, language, thumbnail_path, page_count, metadata_extracted, extraction_error, title_sort, author_sort) "
+            "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, decode($14, 'hex'), decode($15, 'hex')) RETURNING id");
+        conn->prepare("get_books_missing_sort_keys", 
+            "SELECT id, title, COALESCE(author, '') FROM books "
+            "WHERE title_sort IS NULL OR author_sort IS NULL OR get_byte(title_sort, 0) <> $1 "
+            "ORDER BY id LIMIT 1000");
+        conn->prepare("set_book_sort_keys", 
+            "UPDATE books SET title_sort = decode($2, 'hex'), author_sort = decode($3, 'hex') WHERE id = $1");
         conn->prepare("get_book_id_by_path", 
             "SELECT id FROM books WHERE file_path = $1");
-        conn->prepare("get_book_by_id", 
-            "SELECT * FROM books WHERE id = $1");
-        conn->prepare("get_all_books", 
-            "SELECT id, title, author, file_path, file_type, file_size, uploaded_at, thumbnail_path FROM books ORDER BY uploaded_at DESC");
+        conn->prepare("get_book_paths_under", 
+            "SELECT file_path FROM books WHERE substr(file_path, 1, length($1)) = $1");
 
-        // Progress operations
+        // Progress operations (the upsert announces itself, $4 is the origin)
         conn->prepare("upsert_progress", 
+            "WITH saved AS ("
             "INSERT INTO user_book_progress (user_id, book_id, progress_details) "
             "VALUES ($1, $2, $3) "
             "ON CONFLICT (user_id, book_id) DO UPDATE SET "
             "progress_details = EXCLUDED.progress_details, "
-            "last_accessed_at = CURRENT_TIMESTAMP");
-        conn->prepare("get_user_books_with_progress", 
-            "SELECT b.id, b.title, b.author, b.file_type, b.file_size, b.uploaded_at, b.thumbnail_path, "
-            "p.progress_details, p.last_accessed_at "
-            "FROM books b "
-            "LEFT JOIN user_book_progress p ON b.id = p.book_id AND p.user_id = $1 "
-            "ORDER BY p.last_accessed_at DESC NULLS LAST, b.uploaded_at DESC");
-        conn->prepare("get_progress_by_user_book", 
-            "SELECT progress_details, last_accessed_at FROM user_book_progress "
-            "WHERE user_id = $1 AND book_id = $2");
+            "last_accessed_at = CURRENT_TIMESTAMP "
+            "RETURNING user_id, book_id, progress_details, (xmax = 0) AS inserted) "
+            "SELECT inserted, pg_notify('" + std::string(InvalidationBus::CHANNEL) + "', json_build_object("
+            "'origin', $4::text, 'kind', 'progress', 'user_id', user_id, 'book_id', book_id, 'percent', "
+            "CASE WHEN jsonb_typeof(progress_details->'progress_percent') = 'number' "
+            "THEN (progress_details->>'progress_percent')::float8 ELSE 0 END)::text) FROM saved");
 
         // Orphaned records management
         conn->prepare("find_orphaned_books", 
@@ -132,13 +102,86 @@ void Database::prepare_statements() {
         conn->prepare("delete_orphaned_books", 
             "DELETE FROM books WHERE id = ANY($1::int[])");
 
+        // Tags
+        conn->prepare("get_book_tags", 
+            "SELECT t.name FROM book_tags bt JOIN tags t ON t.id = bt.tag_id "
+            "WHERE bt.book_id = $1 ORDER BY t.name");
+        conn->prepare("delete_book_tags", 
+            "DELETE FROM book_tags WHERE book_id = $1");
+        conn->prepare("insert_tag", 
+            "INSERT INTO tags (name) VALUES ($1) ON CONFLICT (name) DO NOTHING");
+        conn->prepare("insert_book_tag", 
+            "INSERT INTO book_tags (book_id, tag_id) SELECT $1, id FROM tags WHERE name = $2 "
+            "ON CONFLICT DO NOTHING");
+
+        // Facet index source
+        conn->prepare("get_facet_books", 
+            "SELECT id, COALESCE(language, '') AS language, file_type FROM books ORDER BY id");
+        conn->prepare("get_catalog_rows", 
+            "SELECT id, title, COALESCE(author, ''), COALESCE(publisher, ''), COALESCE(language, ''), "
+            "file_type, file_size, EXTRACT(EPOCH FROM uploaded_at)::BIGINT FROM books ORDER BY id");
+        conn->prepare("get_catalog_row", 
+            "SELECT id, title, COALESCE(author, ''), COALESCE(publisher, ''), COALESCE(language, ''), "
+            "file_type, file_size, EXTRACT(EPOCH FROM uploaded_at)::BIGINT FROM books WHERE id = $1");
+        conn->prepare("get_facet_tags", 
+            "SELECT bt.book_id, t.name FROM book_tags bt JOIN tags t ON t.id = bt.tag_id");
+        conn->prepare("get_facet_progress", 
+            "SELECT user_id, book_id, "
+            "CASE WHEN jsonb_typeof(progress_details->'progress_percent') = 'number' "
+            "THEN (progress_details->>'progress_percent')::float8 ELSE 0 END AS percent "
+            "FROM user_book_progress");
+
+        // Change events for other instances
+        conn->prepare("notify", 
+            "SELECT pg_notify($1, $2)");
+
+        // Scan checkpoints
+        conn->prepare("upsert_scan_checkpoint", 
+            "INSERT INTO scan_checkpoints (root, state) VALUES ($1, $2::jsonb) "
+            "ON CONFLICT (root) DO UPDATE SET "
+            "state = EXCLUDED.state, "
+            "updated_at = CURRENT_TIMESTAMP");
+        conn->prepare("get_scan_checkpoint", 
+            "SELECT state FROM scan_checkpoints WHERE root = $1");
+        conn->prepare("delete_scan_checkpoint", 
+            "DELETE FROM scan_checkpoints WHERE root = $1");
+
         std::cout << "Database prepared statements created successfully." << std::endl;
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to prepare statements: " + std::string(e.what()));
     }
 }
 
+void Database::refresh_sort_keys() {
+    // Fills keys of books stored before the columns existed, or with an
+    // older key format, in batches so a large library doesn't hold one
+    // long transaction
+    int updated = 0;
+    try {
+        while (true) {
+            pqxx::work txn(*conn);
+            pqxx::result rows = txn.exec_prepared("get_books_missing_sort_keys", static_cast<int>(Collation::VERSION));
+            for (auto row : rows) {
+                txn.exec_prepared("set_book_sort_keys", row[0].as<long>(),
+                                  Collation::to_hex(Collation::sort_key(row[1].as<std::string>())),
+                                  Collation::to_hex(Collation::sort_key(row[2].as<std::string>())));
+            }
+            txn.commit();
+            updated += static_cast<int>(rows.size());
+            if (rows.empty()) {
+                break;
+            }
+        }
+        if (updated > 0) {
+            std::cout << "Computed sort keys for " << updated << " books." << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error computing sort keys: " << e.what() << std::endl;
+    }
+}
+
 void Database::create_user(const std::string& username, const std::string& password_hash) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     try {
         pqxx::work txn(*conn);
         txn.exec_prepared("insert_user", username, password_hash);
@@ -152,6 +195,7 @@ void Database::create_user(const std::string& username, const std::string& passw
 }
 
 bool Database::authenticate_user(const std::string& username, const std::string& password) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     try {
         pqxx::nontransaction txn(*conn);
         // Get the stored password hash for the user
@@ -170,11 +214,15 @@ bool Database::authenticate_user(const std::string& username, const std::string&
 }
 
 long Database::get_user_id(const std::string& username) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     try {
         pqxx::nontransaction txn(*conn);
         pqxx::result result = txn.exec_prepared("get_user_id", username);
         if (!result.empty()) {
-            return result[0][0].as<long>();
+            long user_id = result[0][0].as<long>();
+            std::lock_guard<std::mutex> pin_lock(pin_mutex);
+            user_ids[username] = user_id;
+            return user_id;
         }
         return -1;
     } catch (const std::exception& e) {
@@ -189,14 +237,23 @@ long Database::add_book(const std::string& title, const std::string& author,
                        const std::string& publisher, const std::string& isbn,
                        const std::string& language, const std::string& thumbnail_path,
                        int page_count, bool metadata_extracted,
-                       const std::string& extraction_error) {
+                       const std::string& extraction_error, long uploaded_by) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     try {
         pqxx::work txn(*conn);
         pqxx::result result = txn.exec_prepared("insert_book", 
             title, author, file_path, file_type, static_cast<long>(file_size),
             description, publisher, isbn, language, thumbnail_path, 
-            page_count, metadata_extracted, extraction_error);
+            page_count, metadata_extracted, extraction_error,
+            Collation::to_hex(Collation::sort_key(title)), Collation::to_hex(Collation::sort_key(author)));
+        if (!result.empty()) {
+            if (uploaded_by > 0) {
+                txn.exec_params("UPDATE books SET uploaded_by = $2 WHERE id = $1", result[0][0].as<long>(), uploaded_by);
+            }
+            notify(txn, "book", {{"id", result[0][0].as<long>()}});
+        }
         txn.commit();
+        note_library_write();
         
         if (!result.empty()) {
             long book_id = result[0][0].as<long>();
@@ -212,6 +269,7 @@ long Database::add_book(const std::string& title, const std::string& author,
 }
 
 long Database::get_book_id(const std::string& file_path) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     try {
         pqxx::nontransaction txn(*conn);
         pqxx::result result = txn.exec_prepared("get_book_id_by_path", file_path);
@@ -225,80 +283,265 @@ long Database::get_book_id(const std::string& file_path) {
     }
 }
 
+bool Database::get_known_book_paths(const std::string& root, std::unordered_set<std::string>& paths) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    std::string prefix = root;
+    if (!prefix.empty() && prefix.back() != '/') {
+        prefix += '/';
+    }
+    try {
+        pqxx::nontransaction txn(*conn);
+        pqxx::result result = txn.exec_prepared("get_book_paths_under", prefix);
+        paths.clear();
+        paths.reserve(result.size());
+        for (auto row : result) {
+            paths.emplace(row[0].c_str());
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading known book paths: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 void Database::update_user_book_progress(long user_id, long book_id, 
                                         const nlohmann::json& progress_details) {
+    update_user_book_progress_raw(user_id, book_id, progress_details.dump());
+}
+
+bool Database::update_user_book_progress_raw(long user_id, long book_id, const std::string& progress_json) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     try {
         pqxx::work txn(*conn);
-        txn.exec_prepared("upsert_progress", user_id, book_id, progress_details.dump());
+        // xmax is 0 only on a row version created by the INSERT branch
+        pqxx::result result = txn.exec_prepared("upsert_progress", user_id, book_id, progress_json,
+                                                invalidations ? invalidations->origin() : std::string());
         txn.commit();
+        note_user_write(user_id);
         std::cout << "Progress updated for user " << user_id << " on book " << book_id << std::endl;
+        return !result.empty() && result[0]["inserted"].as<bool>();
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to update progress: " + std::string(e.what()));
     }
 }
 
-nlohmann::json Database::get_user_books_with_progress(long user_id) {
-    try {
-        pqxx::nontransaction txn(*conn);
-        pqxx::result result = txn.exec_prepared("get_user_books_with_progress", user_id);
+nlohmann::json Database::get_user_books_with_progress(const std::string& username, long& user_id,
+                                                      const std::string& order_by) {
+    std::string order = "p.last_accessed_at DESC NULLS LAST, b.uploaded_at DESC";
+    if (order_by == "title") {
+        order = "b.title_sort, b.id";
+    } else if (order_by == "author") {
+        order = "b.author_sort, b.title_sort, b.id";
+    }
+    
+    // Users who saved progress went through get_user_id first, so an
+    // unknown name can't be pinned to the primary
+    bool needs_primary = library_pinned();
+    {
+        std::lock_guard<std::mutex> lock(pin_mutex);
+        auto known = user_ids.find(username);
+        needs_primary = needs_primary || (known != user_ids.end() && user_pinned_locked(known->second));
+    }
+    
+    // The listing finds the user by name itself, so it doesn't wait for the ID lookup
+    std::vector<PgPipeline::Statement> statements = {
+        {"SELECT id FROM users WHERE username = $1", {username}},
+        {"SELECT b.id, b.title, b.author, b.file_type, b.file_size, b.uploaded_at, b.thumbnail_path, "
+         "p.progress_details, p.last_accessed_at "
+         "FROM books b "
+         "LEFT JOIN user_book_progress p ON b.id = p.book_id "
+         "AND p.user_id = (SELECT id FROM users WHERE username = $1) "
+         "ORDER BY " + order, {username}}};
+    std::vector<PgPipeline::Result> results = run_read(statements, LISTING_MAX_STALENESS_SECONDS, needs_primary);
+    if (replicas && results[0].ok && results[0].rows.empty()) {
+        results = run_batch(statements);   // A user registered moments ago may not be on the standby yet
+    }
+    for (const auto& result : results) {
+        if (!result.ok) {
+            throw std::runtime_error("Failed to get user books: " + result.error);
+        }
+    }
+    
+    user_id = results[0].rows.empty() ? -1 : std::stol(*results[0].rows[0][0]);
+    
+    nlohmann::json books = nlohmann::json::array();
+    const PgPipeline::Result& listing = results[1];
+    for (size_t row = 0; row < listing.rows.size(); row++) {
+        auto text = [&](const char* column) { return listing.get(row, column).value_or(""); };
         
-        nlohmann::json books = nlohmann::json::array();
+        nlohmann::json book;
+        book["id"] = std::stol(text("id"));
+        book["title"] = text("title");
+        book["author"] = text("author");
+        book["file_type"] = text("file_type");
+        book["file_size"] = std::stol(text("file_size"));
+        book["uploaded_at"] = text("uploaded_at");
+        book["thumbnail_path"] = text("thumbnail_path");
         
-        for (const auto& row : result) {
-            nlohmann::json book;
-            book["id"] = row["id"].as<long>();
-            book["title"] = row["title"].as<std::string>();
-            book["author"] = row["author"].is_null() ? "" : row["author"].as<std::string>();
-            book["file_type"] = row["file_type"].as<std::string>();
-            book["file_size"] = row["file_size"].as<long>();
-            book["uploaded_at"] = row["uploaded_at"].as<std::string>();
-            book["thumbnail_path"] = row["thumbnail_path"].is_null() ? "" : row["thumbnail_path"].as<std::string>();
-            
-            if (!row["progress_details"].is_null()) {
-                book["progress"] = nlohmann::json::parse(row["progress_details"].as<std::string>());
-                book["last_accessed_at"] = row["last_accessed_at"].as<std::string>();
-            } else {
-                book["progress"] = nullptr;
-                book["last_accessed_at"] = nullptr;
-            }
-            
-            books.push_back(book);
+        const auto& progress = listing.get(row, "progress_details");
+        if (progress) {
+            book["progress"] = nlohmann::json::parse(*progress);
+            book["last_accessed_at"] = text("last_accessed_at");
+        } else {
+            book["progress"] = nullptr;
+            book["last_accessed_at"] = nullptr;
         }
         
-        return books;
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Failed to get user books: " + std::string(e.what()));
+        books.push_back(book);
     }
+    
+    return books;
 }
 
-nlohmann::json Database::get_all_books() {
-    try {
-        pqxx::nontransaction txn(*conn);
-        pqxx::result result = txn.exec_prepared("get_all_books");
+std::vector<PgPipeline::Result> Database::run_batch(const std::vector<PgPipeline::Statement>& statements) {
+    return pipeline->run(statements);
+}
+
+std::vector<PgPipeline::Result> Database::run_read(const std::vector<PgPipeline::Statement>& statements,
+                                                   double max_staleness_seconds, bool needs_primary) {
+    std::vector<PgPipeline::Result> results;
+    if (replicas && !needs_primary && replicas->run(statements, max_staleness_seconds, results)) {
+        return results;
+    }
+    return pipeline->run(statements);
+}
+
+void Database::note_user_write(long user_id) {
+    if (!replicas) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(pin_mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (user_writes.size() >= 4096) {
+        std::erase_if(user_writes, [&](const auto& entry) { return now - entry.second >= READ_YOUR_WRITES_WINDOW; });
+    }
+    user_writes[user_id] = now;
+}
+
+bool Database::user_pinned(long user_id) {
+    std::lock_guard<std::mutex> lock(pin_mutex);
+    return user_pinned_locked(user_id);
+}
+
+bool Database::user_pinned_locked(long user_id) {
+    auto it = user_writes.find(user_id);
+    if (it == user_writes.end()) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() - it->second < READ_YOUR_WRITES_WINDOW) {
+        return true;
+    }
+    user_writes.erase(it);
+    return false;
+}
+
+void Database::note_library_write() {
+    library_written_at.store(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+bool Database::library_pinned() const {
+    auto written_at = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(library_written_at.load()));
+    return replicas && std::chrono::steady_clock::now() - written_at < READ_YOUR_WRITES_WINDOW;
+}
+
+void Database::notify(pqxx::work& txn, const std::string& kind, const nlohmann::json& fields) {
+    if (invalidations) {
+        txn.exec_prepared("notify", InvalidationBus::CHANNEL, invalidations->payload(kind, fields));
+    }
+}
+
+void Database::on_remote_change(const nlohmann::json& event) {
+    // Another instance's write pins our reads the same way our own would
+    std::string kind = event.value("kind", "");
+    if (kind == "progress") {
+        note_user_write(event.value("user_id", -1L));
+    } else if (kind == "book" || kind == "books_removed" || kind == "library" || kind == "resync") {
+        note_library_write();
+    }
+}
+
+int Database::get_schema_version() const {
+    return schema_version;
+}
+
+nlohmann::json Database::get_replica_stats() {
+    return replicas ? replicas->get_stats() : nlohmann::json(nullptr);
+}
+
+nlohmann::json Database::get_all_books(const std::string& order_by) {
+    std::string order = "uploaded_at DESC";
+    if (order_by == "title") {
+        order = "title_sort, id";
+    } else if (order_by == "author") {
+        order = "author_sort, title_sort, id";
+    }
+    
+    std::vector<PgPipeline::Result> results = run_read({
+        {"SELECT id, title, author, file_path, file_type, file_size, uploaded_at, thumbnail_path FROM books "
+         "ORDER BY " + order, {}}}, LISTING_MAX_STALENESS_SECONDS, library_pinned());
+    const PgPipeline::Result& result = results[0];
+    if (!result.ok) {
+        throw std::runtime_error("Failed to get all books: " + result.error);
+    }
+    
+    nlohmann::json books = nlohmann::json::array();
+    for (size_t row = 0; row < result.rows.size(); row++) {
+        auto text = [&](const char* column) { return result.get(row, column).value_or(""); };
         
-        nlohmann::json books = nlohmann::json::array();
+        nlohmann::json book;
+        book["id"] = std::stol(text("id"));
+        book["title"] = text("title");
+        book["author"] = text("author");
+        book["file_path"] = text("file_path");
+        book["file_type"] = text("file_type");
+        book["file_size"] = std::stol(text("file_size"));
+        book["uploaded_at"] = text("uploaded_at");
+        book["thumbnail_path"] = text("thumbnail_path");
         
-        for (const auto& row : result) {
-            nlohmann::json book;
-            book["id"] = row["id"].as<long>();
-            book["title"] = row["title"].as<std::string>();
-            book["author"] = row["author"].is_null() ? "" : row["author"].as<std::string>();
-            book["file_path"] = row["file_path"].as<std::string>();
-            book["file_type"] = row["file_type"].as<std::string>();
-            book["file_size"] = row["file_size"].as<long>();
-            book["uploaded_at"] = row["uploaded_at"].as<std::string>();
-            book["thumbnail_path"] = row["thumbnail_path"].is_null() ? "" : row["thumbnail_path"].as<std::string>();
-            
-            books.push_back(book);
-        }
+        books.push_back(book);
+    }
+    
+    return books;
+}
+
+nlohmann::json Database::get_book_by_id(long book_id) {
+    std::vector<PgPipeline::Result> results = run_read({
+        {"SELECT * FROM books WHERE id = $1", {std::to_string(book_id)}}},
+        LISTING_MAX_STALENESS_SECONDS, library_pinned());
+    const PgPipeline::Result& result = results[0];
+    if (!result.ok) {
+        std::cerr << "Error getting book " << book_id << ": " << result.error << std::endl;
+        return nullptr;
+    }
+    if (result.rows.empty()) {
+        return nullptr;
+    }
+    
+    try {
+        auto text = [&](const char* column) { return result.get(0, column).value_or(""); };
         
-        return books;
+        nlohmann::json book;
+        book["id"] = std::stol(text("id"));
+        book["title"] = text("title");
+        book["author"] = text("author");
+        book["file_path"] = text("file_path");
+        book["file_type"] = text("file_type");
+        book["file_size"] = std::stol(text("file_size"));
+        book["uploaded_at"] = text("uploaded_at");
+        book["thumbnail_path"] = text("thumbnail_path");
+        book["page_count"] = std::stoi(result.get(0, "page_count").value_or("0"));
+        book["language"] = text("language");
+        
+        return book;
     } catch (const std::exception& e) {
-        throw std::runtime_error("Failed to get all books: " + std::string(e.what()));
+        std::cerr << "Error getting book " << book_id << ": " << e.what() << std::endl;
+        return nullptr;
     }
 }
 
 bool Database::is_connected() const {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     return conn && conn->is_open();
 }
 
@@ -313,53 +556,52 @@ bool Database::is_connected() const {
  * @return JSON object with progress data, or null if no progress found
  */
 nlohmann::json Database::get_user_book_progress(long user_id, long book_id) {
+    std::vector<PgPipeline::Result> results = run_read({
+        {"SELECT progress_details, last_accessed_at FROM user_book_progress "
+         "WHERE user_id = $1 AND book_id = $2", {std::to_string(user_id), std::to_string(book_id)}}},
+        PROGRESS_MAX_STALENESS_SECONDS, user_pinned(user_id));
+    const PgPipeline::Result& result = results[0];
+    if (!result.ok) {
+        std::cerr << "Error getting user book progress: " << result.error << std::endl;
+        return nullptr;
+    }
+    if (result.rows.empty()) {
+        return nullptr;
+    }
+    
+    nlohmann::json progress;
     try {
-        pqxx::work txn(*conn);
-        
-        std::string query = R"(
-            SELECT progress_details, last_accessed_at 
-            FROM user_book_progress 
-            WHERE user_id = $1 AND book_id = $2
-        )";
-        
-        pqxx::result result = txn.exec_params(query, user_id, book_id);
-        
-        if (result.empty()) {
-            return nullptr;
-        }
-        
-        auto row = result[0];
-        nlohmann::json progress;
-        
-        try {
-            std::string progress_str = row["progress_details"].as<std::string>();
-            progress = nlohmann::json::parse(progress_str);
-            progress["last_accessed_at"] = row["last_accessed_at"].as<std::string>();
-        } catch (const std::exception& e) {
-            std::cerr << "Invalid progress JSON: " << e.what() << std::endl;
-            return nullptr;
-        }
-        
-        return progress;
-        
+        progress = nlohmann::json::parse(result.get(0, "progress_details").value_or(""));
+        progress["last_accessed_at"] = result.get(0, "last_accessed_at").value_or("");
     } catch (const std::exception& e) {
-        std::cerr << "Error getting user book progress: " << e.what() << std::endl;
+        std::cerr << "Invalid progress JSON: " << e.what() << std::endl;
         return nullptr;
     }
+    
+    return progress;
 }
 
 /**
  * @brief Finds books in database where file doesn't exist on disk
+ * @param root Only consider books under this directory (empty for all)
  * @return Vector of book IDs that are orphaned
  */
-std::vector<int> Database::find_orphaned_book_ids() {
+std::vector<int> Database::find_orphaned_book_ids(const std::string& root) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     std::vector<int> orphaned_ids;
+    std::string prefix = root;
+    if (!prefix.empty() && prefix.back() != '/') {
+        prefix += '/';
+    }
     try {
         pqxx::work txn(*conn);
         pqxx::result result = txn.exec_prepared("find_orphaned_books");
         
         for (auto row : result) {
             std::string file_path = row["file_path"].c_str();
+            if (!file_path.starts_with(prefix)) {
+                continue;
+            }
             if (!std::filesystem::exists(file_path)) {
                 orphaned_ids.push_back(row["id"].as<int>());
             }
@@ -376,11 +618,13 @@ std::vector<int> Database::find_orphaned_book_ids() {
 
 /**
  * @brief Removes orphaned books from database
+ * @param root Only consider books under this directory (empty for all)
  * @return Number of orphaned books removed
  */
-int Database::cleanup_orphaned_books() {
+int Database::cleanup_orphaned_books(const std::string& root) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
     try {
-        auto orphaned_ids = find_orphaned_book_ids();
+        auto orphaned_ids = find_orphaned_book_ids(root);
         if (orphaned_ids.empty()) {
             std::cout << "No orphaned books found" << std::endl;
             return 0;
@@ -395,7 +639,17 @@ int Database::cleanup_orphaned_books() {
         id_array += "}";
         
         txn.exec_params("DELETE FROM books WHERE id = ANY($1::int[])", id_array);
+        // NOTIFY payloads are limited to 8000 bytes
+        if (orphaned_ids.size() <= 500) {
+            notify(txn, "books_removed", {{"ids", orphaned_ids}});
+        } else {
+            notify(txn, "library", nlohmann::json::object());
+        }
         txn.commit();
+        note_library_write();
+        if (books_removed_listener) {
+            books_removed_listener(orphaned_ids);
+        }
         
         std::cout << "Successfully cleaned up " << orphaned_ids.size() << " orphaned books" << std::endl;
         return static_cast<int>(orphaned_ids.size());
@@ -405,3 +659,203 @@ int Database::cleanup_orphaned_books() {
         return 0;
     }
 }
+
+/**
+ * @brief Sets the thumbnail of a book added without one
+ * @param book_id ID of the book
+ * @param thumbnail_path Path to the thumbnail image
+ * @return true on success, false on failure
+ */
+bool Database::set_book_thumbnail(long book_id, const std::string& thumbnail_path) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::work txn(*conn);
+        txn.exec_params("UPDATE books SET thumbnail_path = $2 WHERE id = $1", book_id, thumbnail_path);
+        notify(txn, "book", {{"id", book_id}});
+        txn.commit();
+        note_library_write();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error setting book thumbnail: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Registers a callback for books deleted by cleanup_orphaned_books
+ * @param listener Receives the IDs of the deleted books after the commit
+ */
+void Database::set_books_removed_listener(std::function<void(const std::vector<int>&)> listener) {
+    books_removed_listener = std::move(listener);
+}
+
+/**
+ * @brief Saves (replaces) the checkpoint of a scan root
+ * @param root Scanned directory
+ * @param state Serialized scan cursor
+ * @return true on success
+ */
+bool Database::save_scan_checkpoint(const std::string& root, const nlohmann::json& state) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::work txn(*conn);
+        txn.exec_prepared("upsert_scan_checkpoint", root, state.dump());
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving scan checkpoint: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Loads the checkpoint of a scan root
+ * @param root Scanned directory
+ * @return Serialized scan cursor, or null if there is none
+ */
+nlohmann::json Database::load_scan_checkpoint(const std::string& root) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::nontransaction txn(*conn);
+        pqxx::result result = txn.exec_prepared("get_scan_checkpoint", root);
+        if (result.empty()) {
+            return nullptr;
+        }
+        return nlohmann::json::parse(result[0]["state"].as<std::string>());
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading scan checkpoint: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Removes the checkpoint of a finished scan
+ * @param root Scanned directory
+ */
+void Database::clear_scan_checkpoint(const std::string& root) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::work txn(*conn);
+        txn.exec_prepared("delete_scan_checkpoint", root);
+        txn.commit();
+    } catch (const std::exception& e) {
+        std::cerr << "Error clearing scan checkpoint: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Gets the tags of a book
+ * @param book_id ID of the book
+ * @return Tag names, sorted
+ */
+std::vector<std::string> Database::get_book_tags(long book_id) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    std::vector<std::string> tags;
+    try {
+        pqxx::nontransaction txn(*conn);
+        pqxx::result result = txn.exec_prepared("get_book_tags", book_id);
+        for (auto row : result) {
+            tags.push_back(row[0].as<std::string>());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error getting book tags: " << e.what() << std::endl;
+    }
+    return tags;
+}
+
+/**
+ * @brief Replaces the tags of a book
+ * @param book_id ID of the book
+ * @param tags New tag names (already normalized)
+ * @return true on success
+ */
+bool Database::set_book_tags(long book_id, const std::vector<std::string>& tags) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::work txn(*conn);
+        txn.exec_prepared("delete_book_tags", book_id);
+        for (const auto& tag : tags) {
+            txn.exec_prepared("insert_tag", tag);
+            txn.exec_prepared("insert_book_tag", book_id, tag);
+        }
+        notify(txn, "book_tags", {{"id", book_id}});
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error setting book tags: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool Database::can_edit_book(long book_id, long user_id) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::nontransaction txn(*conn);
+        pqxx::result result = txn.exec_params(
+            "SELECT COALESCE(b.uploaded_by = u.id, FALSE) OR u.is_admin "
+            "FROM books b, users u WHERE b.id = $1 AND u.id = $2",
+            book_id, user_id);
+        return !result.empty() && result[0][0].as<bool>();
+    } catch (const std::exception& e) {
+        std::cerr << "Error checking book permissions: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Loads everything the facet index is built from
+ * @param books Receives (id, language, file_type) of every book, by ID
+ * @param tags Receives every (book, tag) pair
+ * @param progress Receives every (user, book, percent) progress record
+ * @return true on success
+ */
+bool Database::load_facet_rows(std::vector<BookFacetRow>& books, std::vector<BookTagRow>& tags,
+                               std::vector<ProgressFacetRow>& progress) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::work txn(*conn);
+        
+        pqxx::result book_rows = txn.exec_prepared("get_facet_books");
+        books.reserve(book_rows.size());
+        for (auto row : book_rows) {
+            books.push_back({row[0].as<long>(), row[1].as<std::string>(), row[2].as<std::string>()});
+        }
+        
+        pqxx::result tag_rows = txn.exec_prepared("get_facet_tags");
+        tags.reserve(tag_rows.size());
+        for (auto row : tag_rows) {
+            tags.push_back({row[0].as<long>(), row[1].as<std::string>()});
+        }
+        
+        pqxx::result progress_rows = txn.exec_prepared("get_facet_progress");
+        progress.reserve(progress_rows.size());
+        for (auto row : progress_rows) {
+            progress.push_back({row[0].as<long>(), row[1].as<long>(), row[2].as<double>()});
+        }
+        
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading facet rows: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool Database::load_catalog_rows(std::vector<CatalogRow>& rows, long book_id) {
+    std::lock_guard<std::recursive_mutex> lock(conn_mutex);
+    try {
+        pqxx::nontransaction txn(*conn);
+        pqxx::result result = book_id > 0 ? txn.exec_prepared("get_catalog_row", book_id)
+                                          : txn.exec_prepared("get_catalog_rows");
+        rows.reserve(rows.size() + result.size());
+        for (auto row : result) {
+            rows.push_back({row[0].as<long>(), row[1].as<std::string>(), row[2].as<std::string>(),
+                            row[3].as<std::string>(), row[4].as<std::string>(), row[5].as<std::string>(),
+                            row[6].as<long>(), row[7].as<long>()});
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading catalog rows: " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,285 @@
+/**
+ * @file facet_index.cpp
+ * @brief Implementation of FacetIndex
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "facet_index.h"
+#include "database.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+const std::vector<std::string> FACET_NAMES = {"tag", "language", "format", "read_state"};
+
+} // namespace
+
+FacetIndex::FacetIndex(Database* db) : database(db) {
+    if (!database) {
+        throw std::invalid_argument("FacetIndex requires a valid Database instance");
+    }
+}
+
+bool FacetIndex::rebuild() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<BookFacetRow> book_rows;
+    std::vector<BookTagRow> tag_rows;
+    std::vector<ProgressFacetRow> progress_rows;
+    if (!database->load_facet_rows(book_rows, tag_rows, progress_rows)) {
+        std::cerr << "FacetIndex: rebuild failed, keeping the previous index" << std::endl;
+        return false;
+    }
+
+    // Build off to the side, then swap in under the lock
+    std::unordered_map<long, uint32_t> new_ordinals;
+    std::vector<long> new_book_ids;
+    RoaringBitmap new_all;
+    ValueMap new_tags, new_languages, new_formats;
+    std::unordered_map<long, UserState> new_users;
+
+    new_ordinals.reserve(book_rows.size());
+    new_book_ids.reserve(book_rows.size());
+    for (const auto& row : book_rows) {
+        uint32_t ordinal = static_cast<uint32_t>(new_book_ids.size());
+        new_ordinals[row.id] = ordinal;
+        new_book_ids.push_back(row.id);
+        new_all.add(ordinal);
+        new_languages[row.language].add(ordinal);
+        new_formats[row.file_type].add(ordinal);
+    }
+    for (const auto& row : tag_rows) {
+        auto it = new_ordinals.find(row.book_id);
+        if (it != new_ordinals.end()) {
+            new_tags[row.tag].add(it->second);
+        }
+    }
+    for (const auto& row : progress_rows) {
+        auto it = new_ordinals.find(row.book_id);
+        if (it == new_ordinals.end()) {
+            continue;
+        }
+        UserState& state = new_users[row.user_id];
+        state.started.add(it->second);
+        if (row.percent >= 100.0) {
+            state.finished.add(it->second);
+        }
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(index_mutex);
+        ordinals.swap(new_ordinals);
+        book_ids.swap(new_book_ids);
+        all_books = std::move(new_all);
+        tags.swap(new_tags);
+        languages.swap(new_languages);
+        formats.swap(new_formats);
+        users.swap(new_users);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "FacetIndex: indexed " << book_rows.size() << " books, " << tag_rows.size() << " tags, "
+              << progress_rows.size() << " progress records in " << elapsed.count() << " ms" << std::endl;
+    return true;
+}
+
+uint32_t FacetIndex::ordinal_locked(long book_id) {
+    auto it = ordinals.find(book_id);
+    if (it != ordinals.end()) {
+        return it->second;
+    }
+    uint32_t ordinal = static_cast<uint32_t>(book_ids.size());
+    ordinals[book_id] = ordinal;
+    book_ids.push_back(book_id);
+    return ordinal;
+}
+
+void FacetIndex::assign_value(ValueMap& values, const std::string& value, uint32_t ordinal) {
+    // A book has one language and one format: drop it from its old value first
+    for (auto it = values.begin(); it != values.end();) {
+        if (it->first != value) {
+            it->second.remove(ordinal);
+        }
+        it = it->second.empty() && it->first != value ? values.erase(it) : std::next(it);
+    }
+    values[value].add(ordinal);
+}
+
+void FacetIndex::add_book(long book_id, const std::string& language, const std::string& file_type) {
+    std::unique_lock<std::shared_mutex> lock(index_mutex);
+    uint32_t ordinal = ordinal_locked(book_id);
+    all_books.add(ordinal);
+    assign_value(languages, language, ordinal);
+    assign_value(formats, file_type, ordinal);
+}
+
+void FacetIndex::set_tags(long book_id, const std::vector<std::string>& new_tags) {
+    std::unique_lock<std::shared_mutex> lock(index_mutex);
+    auto found = ordinals.find(book_id);
+    if (found == ordinals.end()) {
+        return;
+    }
+    uint32_t ordinal = found->second;
+
+    for (auto it = tags.begin(); it != tags.end();) {
+        it->second.remove(ordinal);
+        it = it->second.empty() ? tags.erase(it) : std::next(it);
+    }
+    for (const auto& tag : new_tags) {
+        tags[tag].add(ordinal);
+    }
+}
+
+void FacetIndex::set_progress(long user_id, long book_id, double percent) {
+    std::unique_lock<std::shared_mutex> lock(index_mutex);
+    auto found = ordinals.find(book_id);
+    if (found == ordinals.end()) {
+        return;
+    }
+
+    UserState& state = users[user_id];
+    state.started.add(found->second);
+    if (percent >= 100.0) {
+        state.finished.add(found->second);
+    } else {
+        state.finished.remove(found->second);
+    }
+}
+
+std::map<std::string, RoaringBitmap> FacetIndex::read_state_bitmaps(long user_id) const {
+    std::map<std::string, RoaringBitmap> states;
+    auto it = users.find(user_id);
+    if (it == users.end()) {
+        states["unread"] = all_books;
+        states["reading"] = RoaringBitmap();
+        states["finished"] = RoaringBitmap();
+        return states;
+    }
+
+    RoaringBitmap started = it->second.started & all_books;
+    RoaringBitmap finished = it->second.finished & all_books;
+    states["unread"] = all_books.and_not(started);
+    states["reading"] = started.and_not(finished);
+    states["finished"] = std::move(finished);
+    return states;
+}
+
+FacetIndex::Result FacetIndex::query(const Query& query) const {
+    std::shared_lock<std::shared_mutex> lock(index_mutex);
+
+    std::map<std::string, RoaringBitmap> read_states = read_state_bitmaps(query.user_id);
+    auto value_bitmap = [&](const std::string& facet, const std::string& value) -> const RoaringBitmap* {
+        if (facet == "read_state") {
+            auto it = read_states.find(value);
+            return it == read_states.end() ? nullptr : &it->second;
+        }
+        const ValueMap& values = facet == "tag" ? tags : facet == "language" ? languages : formats;
+        auto it = values.find(value);
+        return it == values.end() ? nullptr : &it->second;
+    };
+
+    // Values of one facet are ORed; facets without a selection don't filter
+    std::map<std::string, RoaringBitmap> selections;
+    for (const auto& [facet, values] : query.filters) {
+        if (values.empty() || std::find(FACET_NAMES.begin(), FACET_NAMES.end(), facet) == FACET_NAMES.end()) {
+            continue;
+        }
+        RoaringBitmap selection;
+        for (const auto& value : values) {
+            if (const RoaringBitmap* bitmap = value_bitmap(facet, value)) {
+                selection = selection | *bitmap;
+            }
+        }
+        selections[facet] = std::move(selection);
+    }
+
+    Result result;
+    RoaringBitmap matches = all_books;
+    for (const auto& [facet, selection] : selections) {
+        matches = matches & selection;
+    }
+    std::vector<uint32_t> matched = matches.to_vector();
+    result.book_ids.reserve(matched.size());
+    for (auto it = matched.rbegin(); it != matched.rend(); ++it) {
+        result.book_ids.push_back(book_ids[*it]);
+    }
+
+    // Count each facet against the selections of the other facets
+    for (const auto& facet : FACET_NAMES) {
+        RoaringBitmap base = all_books;
+        for (const auto& [other, selection] : selections) {
+            if (other != facet) {
+                base = base & selection;
+            }
+        }
+
+        auto& counts = result.counts[facet];
+        auto add_count = [&](const std::string& value, const RoaringBitmap& bitmap) {
+            uint64_t count = base.and_cardinality(bitmap);
+            if (count > 0) {
+                counts[value] = count;
+            }
+        };
+        if (facet == "read_state") {
+            for (const auto& [value, bitmap] : read_states) {
+                add_count(value, bitmap);
+            }
+        } else {
+            for (const auto& [value, bitmap] : facet == "tag" ? tags : facet == "language" ? languages : formats) {
+                add_count(value, bitmap);
+            }
+        }
+    }
+
+    return result;
+}
+
+nlohmann::json FacetIndex::get_stats() const {
+    std::shared_lock<std::shared_mutex> lock(index_mutex);
+
+    size_t bytes = all_books.memory_bytes();
+    for (const ValueMap* values : {&tags, &languages, &formats}) {
+        for (const auto& [value, bitmap] : *values) {
+            bytes += bitmap.memory_bytes();
+        }
+    }
+    for (const auto& [user_id, state] : users) {
+        bytes += state.started.memory_bytes() + state.finished.memory_bytes();
+    }
+
+    nlohmann::json stats;
+    stats["books"] = all_books.cardinality();
+    stats["tags"] = tags.size();
+    stats["languages"] = languages.size();
+    stats["formats"] = formats.size();
+    stats["users"] = users.size();
+    stats["bitmap_bytes"] = bytes;
+    return stats;
+}
+
+std::vector<std::string> FacetIndex::normalize_tags(const std::vector<std::string>& raw_tags) {
+    std::vector<std::string> normalized;
+    for (const auto& raw : raw_tags) {
+        size_t first = raw.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            continue;
+        }
+        size_t last = raw.find_last_not_of(" \t\r\n");
+        std::string tag = raw.substr(first, last - first + 1);
+        if (tag.size() > 100) {
+            continue;
+        }
+        std::transform(tag.begin(), tag.end(), tag.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        normalized.push_back(std::move(tag));
+    }
+    std::sort(normalized.begin(), normalized.end());
+    normalized.erase(std::unique(normalized.begin(), normalized.end()), normalized.end());
+    return normalized;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file file_buffer_cache.cpp
+ * @brief Implementation of FileBufferCache
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "file_buffer_cache.h"
+#include "file_io.h"
+#include <sys/stat.h>
+
+FileBufferCache::FileBufferCache(FileIoBackend* file_io, size_t budget_bytes, size_t max_file_bytes)
+    : file_io(file_io), budget(budget_bytes), max_file_size(max_file_bytes) {
+}
+
+FileBufferCache::Buffer FileBufferCache::get(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        invalidate(path);
+        return nullptr;
+    }
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    int64_t mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = entries.find(path);
+        if (it != entries.end()) {
+            if (it->second.size == size && it->second.mtime_ns == mtime_ns) {
+                lru.splice(lru.begin(), lru, it->second.lru_position);
+                hits.fetch_add(1);
+                return it->second.data;
+            }
+            erase_locked(it);
+        }
+    }
+
+    // Read outside the lock; two concurrent misses just read the file twice
+    misses.fetch_add(1);
+    FileReadResult file = file_io->read_file(path);
+    if (!file.ok) {
+        return nullptr;
+    }
+    Buffer data = std::make_shared<const std::string>(std::move(file.data));
+    if (data->size() > max_file_size || data->size() != size) {
+        return data;   // Too big, or changed while we read it
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = entries.find(path);
+    if (it != entries.end()) {
+        erase_locked(it);
+    }
+    lru.push_front(path);
+    entries[path] = Entry{data, size, mtime_ns, lru.begin()};
+    used_bytes += data->size();
+
+    while (used_bytes > budget && lru.size() > 1) {
+        erase_locked(entries.find(lru.back()));
+        evictions.fetch_add(1);
+    }
+    return data;
+}
+
+void FileBufferCache::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = entries.find(path);
+    if (it != entries.end()) {
+        erase_locked(it);
+    }
+}
+
+nlohmann::json FileBufferCache::get_stats() {
+    nlohmann::json stats;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        stats["entries"] = entries.size();
+        stats["bytes"] = used_bytes;
+    }
+    stats["budget_bytes"] = budget;
+    stats["hits"] = hits.load();
+    stats["misses"] = misses.load();
+    stats["evictions"] = evictions.load();
+    return stats;
+}
+
+void FileBufferCache::erase_locked(std::unordered_map<std::string, Entry>::iterator it) {
+    used_bytes -= it->second.data->size();
+    lru.erase(it->second.lru_position);
+    entries.erase(it);
+}
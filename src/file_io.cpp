@@ -0,0 +1,502 @@
+/**
+ * @file file_io.cpp
+ * @brief Implementation of the batched file read backends
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "file_io.h"
+#include <iostream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef MYLIBRARY_HAVE_LIBURING
+#include <liburing.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Opens a file and works out how many bytes a request covers
+ * @return File descriptor, or -1 with result.error set
+ */
+int open_for_request(const FileReadRequest& request, size_t& length, FileReadResult& result) {
+    int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        result.error = "Cannot open " + request.path + ": " + std::strerror(errno);
+        return -1;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0) {
+        result.error = "Cannot stat " + request.path + ": " + std::strerror(errno);
+        close(fd);
+        return -1;
+    }
+
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    uint64_t available = request.offset < size ? size - request.offset : 0;
+    length = request.length == 0 ? static_cast<size_t>(available)
+                                 : static_cast<size_t>(std::min<uint64_t>(request.length, available));
+    return fd;
+}
+
+FileReadResult pread_request(const FileReadRequest& request) {
+    FileReadResult result;
+    size_t length = 0;
+    int fd = open_for_request(request, length, result);
+    if (fd < 0) {
+        return result;
+    }
+
+    result.data.resize(length);
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = pread(fd, result.data.data() + done, length - done,
+                          static_cast<off_t>(request.offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            result.error = "Read failed for " + request.path + ": " + std::strerror(errno);
+            close(fd);
+            return result;
+        }
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+    close(fd);
+
+    result.data.resize(done);
+    result.ok = true;
+    return result;
+}
+
+} // namespace
+
+// ========== FileIoBackend ==========
+
+FileReadResult FileIoBackend::read_file(const std::string& path, bool borrow) {
+    FileReadRequest request;
+    request.path = path;
+    request.borrow = borrow;
+    return read_batch({request}).front();
+}
+
+std::unique_ptr<FileIoBackend> FileIoBackend::create(const std::string& backend, size_t threads) {
+#ifdef MYLIBRARY_HAVE_LIBURING
+    if (backend == "auto" || backend == "io_uring") {
+        try {
+            auto uring = std::make_unique<IoUringBackend>();
+            std::cout << "FileIoBackend: using io_uring" << std::endl;
+            return uring;
+        } catch (const std::exception& e) {
+            std::cerr << "FileIoBackend: io_uring unavailable (" << e.what()
+                      << "), falling back to pread pool" << std::endl;
+        }
+    }
+#else
+    if (backend == "io_uring") {
+        std::cerr << "FileIoBackend: built without liburing, falling back to pread pool" << std::endl;
+    }
+#endif
+    std::cout << "FileIoBackend: using pread pool with " << threads << " threads" << std::endl;
+    return std::make_unique<PreadPoolBackend>(threads);
+}
+
+// ========== PreadPoolBackend ==========
+
+PreadPoolBackend::PreadPoolBackend(size_t thread_count) {
+    for (size_t i = 0; i < std::max<size_t>(1, thread_count); i++) {
+        workers.emplace_back(&PreadPoolBackend::worker_loop, this);
+    }
+}
+
+PreadPoolBackend::~PreadPoolBackend() {
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        stopping = true;
+    }
+    tasks_cv.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void PreadPoolBackend::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(tasks_mutex);
+            tasks_cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+std::vector<FileReadResult> PreadPoolBackend::read_batch(const std::vector<FileReadRequest>& requests) {
+    std::vector<FileReadResult> results(requests.size());
+
+    // A single read isn't worth a thread hand-off
+    if (requests.size() == 1) {
+        results[0] = pread_request(requests[0]);
+        return results;
+    }
+
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    size_t remaining = requests.size();
+
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        for (size_t i = 0; i < requests.size(); i++) {
+            tasks.emplace_back([&, i]() {
+                results[i] = pread_request(requests[i]);
+                std::lock_guard<std::mutex> done_lock(done_mutex);
+                if (--remaining == 0) {
+                    done_cv.notify_one();
+                }
+            });
+        }
+    }
+    tasks_cv.notify_all();
+
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_cv.wait(lock, [&] { return remaining == 0; });
+    return results;
+}
+
+#ifdef MYLIBRARY_HAVE_LIBURING
+
+// ========== IoUringBackend ==========
+
+struct IoUringBackend::Batch {
+    const std::vector<FileReadRequest>* requests = nullptr;
+    std::vector<FileReadResult> results;
+    size_t remaining = 0;
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    void finish_one() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--remaining == 0) {
+            cv.notify_one();
+        }
+    }
+};
+
+struct IoUringBackend::Operation {
+    std::shared_ptr<Batch> batch;
+    size_t index = 0;
+    bool reading = false;    ///< Opened and sized, reads in progress
+    int opening = 0;         ///< OPENAT/STATX completions still outstanding
+    int open_error = 0;      ///< errno of a failed OPENAT
+    int stat_error = 0;      ///< errno of a failed STATX
+    struct statx stx{};
+    int fd = -1;
+    uint64_t offset = 0;     ///< File offset of the next byte to read
+    size_t done = 0;         ///< Bytes already read
+    size_t length = 0;       ///< Total bytes wanted
+    int buffer = -1;         ///< Registered buffer slot in use, -1 if none
+};
+
+struct IoUringBackend::BufferPool {
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<int> free;
+    std::mutex mutex;
+
+    int acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free.empty()) {
+            return -1;
+        }
+        int slot = free.back();
+        free.pop_back();
+        return slot;
+    }
+
+    void release(int slot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free.push_back(slot);
+    }
+};
+
+namespace {
+
+// The STATX of an operation is told apart from its OPENAT by the low bit
+constexpr uintptr_t STATX_TAG = 1;
+
+} // namespace
+
+IoUringBackend::IoUringBackend(unsigned queue_depth)
+    : ring(std::make_unique<io_uring>()), depth(queue_depth), buffer_pool(std::make_shared<BufferPool>()) {
+    int rc = io_uring_queue_init(depth, ring.get(), 0);
+    if (rc < 0) {
+        throw std::runtime_error(std::string("io_uring_queue_init failed: ") + std::strerror(-rc));
+    }
+
+    // Opens and stats go through the ring too (Linux 5.6+)
+    io_uring_probe* probe = io_uring_get_probe_ring(ring.get());
+    bool supported = probe && io_uring_opcode_supported(probe, IORING_OP_OPENAT) &&
+                     io_uring_opcode_supported(probe, IORING_OP_STATX);
+    if (probe) {
+        io_uring_free_probe(probe);
+    }
+    if (!supported) {
+        io_uring_queue_exit(ring.get());
+        throw std::runtime_error("kernel lacks IORING_OP_OPENAT/IORING_OP_STATX");
+    }
+
+    // Register a pool of fixed buffers for small borrowed reads
+    unsigned buffer_count = std::min(depth, 64u);
+    std::vector<iovec> iovecs(buffer_count);
+    for (unsigned i = 0; i < buffer_count; i++) {
+        buffer_pool->buffers.emplace_back(new char[FIXED_BUFFER_SIZE]);
+        iovecs[i].iov_base = buffer_pool->buffers.back().get();
+        iovecs[i].iov_len = FIXED_BUFFER_SIZE;
+        buffer_pool->free.push_back(static_cast<int>(i));
+    }
+    rc = io_uring_register_buffers(ring.get(), iovecs.data(), buffer_count);
+    if (rc < 0) {
+        // Still usable, just without READ_FIXED (e.g. RLIMIT_MEMLOCK too low)
+        std::cerr << "IoUringBackend: buffer registration failed: " << std::strerror(-rc) << std::endl;
+        buffer_pool->free.clear();
+    } else {
+        buffers_registered = true;
+    }
+
+    ring_thread = std::thread(&IoUringBackend::ring_loop, this);
+}
+
+IoUringBackend::~IoUringBackend() {
+    stopping.store(true);
+    queue_cv.notify_all();
+    if (ring_thread.joinable()) {
+        ring_thread.join();
+    }
+    // Borrowed slots still out keep the pool's memory alive
+    if (buffers_registered) {
+        io_uring_unregister_buffers(ring.get());
+    }
+    io_uring_queue_exit(ring.get());
+}
+
+std::vector<FileReadResult> IoUringBackend::read_batch(const std::vector<FileReadRequest>& requests) {
+    if (requests.empty()) {
+        return {};
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->requests = &requests;
+    batch->results.resize(requests.size());
+    batch->remaining = requests.size();
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        pending_batches.push_back(batch);
+    }
+    queue_cv.notify_one();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->cv.wait(lock, [&] { return batch->remaining == 0; });
+    return std::move(batch->results);
+}
+
+void IoUringBackend::ring_loop() {
+    std::deque<Operation*> ready;   // Operations waiting for SQEs
+    size_t in_flight = 0;
+
+    auto path_of = [](const Operation* op) -> const std::string& {
+        return (*op->batch->requests)[op->index].path;
+    };
+
+    auto finish = [&](Operation* op, bool ok, const std::string& error) {
+        FileReadResult& result = op->batch->results[op->index];
+        result.ok = ok;
+        result.error = error;
+        if (op->buffer >= 0) {
+            if (ok) {
+                // Hand the slot itself out; it returns to the pool when the caller drops it
+                std::shared_ptr<BufferPool> pool = buffer_pool;
+                int slot = op->buffer;
+                result.buffer = std::shared_ptr<const char>(pool->buffers[slot].get(),
+                                                            [pool, slot](const char*) { pool->release(slot); });
+                result.buffer_size = op->done;
+            } else {
+                buffer_pool->release(op->buffer);
+            }
+            op->buffer = -1;
+        } else if (ok) {
+            result.data.resize(op->done);
+        } else {
+            result.data.clear();
+        }
+        if (op->fd >= 0) {
+            close(op->fd);
+        }
+        op->batch->finish_one();
+        delete op;
+    };
+
+    // Both OPENAT and STATX are back: size the read or fail
+    auto start_reading = [&](Operation* op) {
+        const FileReadRequest& request = (*op->batch->requests)[op->index];
+        if (op->open_error) {
+            finish(op, false, "Cannot open " + request.path + ": " + std::strerror(op->open_error));
+            return;
+        }
+        if (op->stat_error) {
+            finish(op, false, "Cannot stat " + request.path + ": " + std::strerror(op->stat_error));
+            return;
+        }
+
+        uint64_t size = op->stx.stx_size;
+        uint64_t available = request.offset < size ? size - request.offset : 0;
+        op->length = request.length == 0 ? static_cast<size_t>(available)
+                                         : static_cast<size_t>(std::min<uint64_t>(request.length, available));
+        if (op->length == 0) {
+            finish(op, true, "");
+            return;
+        }
+
+        if (request.borrow && buffers_registered && op->length <= FIXED_BUFFER_SIZE) {
+            op->buffer = buffer_pool->acquire();
+        }
+        if (op->buffer < 0) {
+            op->batch->results[op->index].data.resize(op->length);
+        }
+        op->reading = true;
+        ready.push_back(op);
+    };
+
+    while (true) {
+        // 1. Pick up newly queued batches
+        std::deque<std::shared_ptr<Batch>> incoming;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            if (in_flight == 0 && ready.empty()) {
+                queue_cv.wait(lock, [this] { return stopping.load() || !pending_batches.empty(); });
+            }
+            if (stopping.load() && in_flight == 0 && ready.empty() && pending_batches.empty()) {
+                break;
+            }
+            incoming.swap(pending_batches);
+        }
+
+        for (auto& batch : incoming) {
+            for (size_t i = 0; i < batch->requests->size(); i++) {
+                auto* op = new Operation();
+                op->batch = batch;
+                op->index = i;
+                op->offset = (*batch->requests)[i].offset;
+                ready.push_back(op);
+            }
+        }
+
+        // 2. Turn every ready operation into SQEs and submit them together.
+        //    A new operation needs two: OPENAT and STATX run side by side.
+        unsigned prepared = 0;
+        while (!ready.empty()) {
+            Operation* op = ready.front();
+            if (io_uring_sq_space_left(ring.get()) < (op->reading ? 1u : 2u)) break;
+            ready.pop_front();
+
+            if (!op->reading) {
+                io_uring_sqe* sqe = io_uring_get_sqe(ring.get());
+                io_uring_prep_openat(sqe, AT_FDCWD, path_of(op).c_str(), O_RDONLY | O_CLOEXEC, 0);
+                io_uring_sqe_set_data(sqe, op);
+
+                sqe = io_uring_get_sqe(ring.get());
+                io_uring_prep_statx(sqe, AT_FDCWD, path_of(op).c_str(), 0, STATX_SIZE, &op->stx);
+                io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(op) | STATX_TAG));
+
+                op->opening = 2;
+                prepared += 2;
+                continue;
+            }
+
+            io_uring_sqe* sqe = io_uring_get_sqe(ring.get());
+            size_t remaining = op->length - op->done;
+            if (op->buffer >= 0) {
+                io_uring_prep_read_fixed(sqe, op->fd, buffer_pool->buffers[op->buffer].get() + op->done,
+                                         static_cast<unsigned>(remaining), op->offset, op->buffer);
+            } else {
+                char* dest = op->batch->results[op->index].data.data() + op->done;
+                io_uring_prep_read(sqe, op->fd, dest, static_cast<unsigned>(std::min<size_t>(remaining, 1u << 30)),
+                                   op->offset);
+            }
+            io_uring_sqe_set_data(sqe, op);
+            prepared++;
+        }
+        if (prepared > 0) {
+            io_uring_submit(ring.get());
+            in_flight += prepared;
+        }
+
+        if (in_flight == 0) {
+            continue;
+        }
+
+        // 3. Reap completions; short wait so newly queued batches get picked up
+        io_uring_cqe* cqe = nullptr;
+        __kernel_timespec timeout{0, 2 * 1000 * 1000};
+        if (io_uring_wait_cqe_timeout(ring.get(), &cqe, &timeout) < 0) {
+            continue;
+        }
+
+        while (io_uring_peek_cqe(ring.get(), &cqe) == 0) {
+            auto data = reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe));
+            auto* op = reinterpret_cast<Operation*>(data & ~STATX_TAG);
+            int res = cqe->res;
+            io_uring_cqe_seen(ring.get(), cqe);
+            in_flight--;
+
+            if (!op->reading) {
+                if (data & STATX_TAG) {
+                    op->stat_error = res < 0 ? -res : 0;
+                } else if (res < 0) {
+                    op->open_error = -res;
+                } else {
+                    op->fd = res;
+                }
+                if (--op->opening == 0) {
+                    start_reading(op);
+                }
+                continue;
+            }
+
+            if (res == -EINTR || res == -EAGAIN) {
+                ready.push_back(op);
+                continue;
+            }
+            if (res < 0) {
+                finish(op, false, "Read failed for " + path_of(op) + ": " + std::strerror(-res));
+                continue;
+            }
+            if (res == 0) {
+                // EOF before the expected length (file shrank)
+                finish(op, true, "");
+                continue;
+            }
+
+            op->done += static_cast<size_t>(res);
+            op->offset += static_cast<size_t>(res);
+            if (op->done >= op->length) {
+                finish(op, true, "");
+            } else {
+                ready.push_back(op);
+            }
+        }
+    }
+}
+
+#endif // MYLIBRARY_HAVE_LIBURING
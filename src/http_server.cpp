@@ -8,38 +8,264 @@
 
 #include "http_server.h"
 #include "auth.h"
+#include "archive_handle_pool.h"
+#include "text_normalizer.h"
+#include "progress_json.h"
 #include <iostream>
-#include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <charconv>
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// Distinct catalog queries kept serialized until the catalog changes
+constexpr size_t MAX_CATALOG_SNAPSHOTS = 256;
+
+std::string book_content_type(const std::string& file_type) {
+    if (file_type == "epub") return "application/epub+zip";
+    if (file_type == "pdf") return "application/pdf";
+    if (file_type == "cbz") return "application/zip";
+    if (file_type == "cbr") return "application/x-rar-compressed";
+    return "application/octet-stream";
+}
+
+std::string thumbnail_content_type(const std::string& thumbnail_path) {
+    if (thumbnail_path.ends_with(".svg")) return "image/svg+xml";
+    if (thumbnail_path.ends_with(".jpg") || thumbnail_path.ends_with(".jpeg")) return "image/jpeg";
+    if (thumbnail_path.ends_with(".png")) return "image/png";
+    return "application/octet-stream";
+}
+
+/**
+ * @brief Percent-encodes every byte outside alphanumerics and @p safe
+ */
+std::string percent_encode(const std::string& value, std::string_view safe) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string encoded;
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || safe.find(static_cast<char>(c)) != std::string_view::npos) {
+            encoded += static_cast<char>(c);
+        } else {
+            encoded += '%';
+            encoded += HEX[c >> 4];
+            encoded += HEX[c & 0x0F];
+        }
+    }
+    return encoded;
+}
+
+/**
+ * @brief Builds an attachment Content-Disposition for a book download
+ *
+ * Titles come from book metadata, so the quoted filename is reduced to
+ * printable ASCII without quotes or backslashes, and the full UTF-8 name
+ * follows percent-encoded as filename* (RFC 5987) for clients that read it.
+ */
+std::string attachment_disposition(const std::string& filename) {
+    std::string fallback;
+    for (unsigned char c : filename) {
+        fallback += (c >= 0x20 && c < 0x7F && c != '"' && c != '\\') ? static_cast<char>(c) : '_';
+    }
+    return "attachment; filename=\"" + fallback + "\"; filename*=UTF-8''" + percent_encode(filename, "!#$&+-.^_`|~");
+}
+
+TransferTarget error_target(int status, const std::string& message) {
+    nlohmann::json error_response;
+    error_response["success"] = false;
+    error_response["error"] = message;
+
+    TransferTarget target;
+    target.status = status;
+    target.body = error_response.dump();
+    target.content_type = "application/json";
+    return target;
+}
+
+/**
+ * @brief Splits "/api/books/{id}/{action}[/{page}]" into its parts
+ * @return true if the path has that shape
+ */
+bool parse_book_route(const std::string& path, long& book_id, std::string& action, long& page) {
+    static const std::string prefix = "/api/books/";
+    if (path.rfind(prefix, 0) != 0) {
+        return false;
+    }
+
+    size_t id_end = path.find('/', prefix.size());
+    if (id_end == std::string::npos || id_end == prefix.size()) {
+        return false;
+    }
+    std::string id_str = path.substr(prefix.size(), id_end - prefix.size());
+    if (id_str.size() > 18 || id_str.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    book_id = std::stol(id_str);
+
+    size_t action_end = path.find('/', id_end + 1);
+    action = path.substr(id_end + 1, action_end == std::string::npos ? std::string::npos : action_end - id_end - 1);
+    page = -1;
+    if (action_end != std::string::npos) {
+        std::string page_str = path.substr(action_end + 1);
+        if (page_str.empty() || page_str.size() > 9 || page_str.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        page = std::stol(page_str);
+    }
+    return !action.empty();
+}
+
+/**
+ * @brief Parses the ?w= parameter of a page request
+ * @return Width in pixels, 0 if absent or invalid
+ */
+int parse_page_width(const std::string& value) {
+    if (value.empty() || value.size() > 5 || value.find_first_not_of("0123456789") != std::string::npos) {
+        return 0;
+    }
+    return std::stoi(value);
+}
+
+/**
+ * @brief Reads an integer query parameter, leaving @p value as is if absent
+ * @return false if the parameter is present but not a whole number in range
+ */
+bool parse_long_param(const httplib::Request& req, const char* name, long& value) {
+    if (!req.has_param(name)) {
+        return true;
+    }
+    std::string text = req.get_param_value(name);
+    long parsed = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+    if (text.empty() || ec != std::errc() || end != text.data() + text.size()) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+} // namespace
+
 HttpServer::HttpServer(const std::string& db_connection_string, 
                       const std::string& books_directory,
-                      int server_port) : port(server_port) {
+                      int server_port,
+                      int streaming_port,
+                      const std::string& io_backend,
+                      const std::vector<LibraryRoot>& library_roots,
+                      const std::string& web_directory,
+                      const std::vector<std::string>& db_replica_connection_strings)
+    : port(server_port), stream_port(streaming_port) {
+    
+    // Initialize change events shared with other instances on the same database
+    invalidation_bus = std::make_unique<InvalidationBus>(db_connection_string);
     
-    // Initialize database connection
-    database = std::make_unique<Database>(db_connection_string);
+    // Initialize database connection (reads may go to standbys)
+    database = std::make_unique<Database>(db_connection_string, db_replica_connection_strings,
+                                          invalidation_bus.get());
     
     // Initialize book manager
     book_manager = std::make_unique<BookManager>(books_directory);
     
-    // Initialize library scanner
-    library_scanner = std::make_unique<LibraryScanner>(database.get(), book_manager.get());
+    // Initialize page transcoder (resized pages are cached next to thumbnails)
+    page_transcoder = std::make_unique<PageTranscoder>(books_directory + "/transcoded");
+    database->set_books_removed_listener([this](const std::vector<int>& book_ids) {
+        for (int book_id : book_ids) {
+            page_transcoder->remove_book(book_id);
+        }
+    });
+    
+    // Initialize collection manager on its own connection
+    collection_manager = std::make_unique<CollectionManager>(std::make_shared<pqxx::connection>(db_connection_string),
+                                                             std::make_shared<PgPipeline>(db_connection_string),
+                                                             invalidation_bus.get());
+    
+    // Initialize facet index (kept current by the upload, scan, tag and progress handlers)
+    facet_index = std::make_unique<FacetIndex>(database.get());
+    
+    // Initialize in-memory catalog for sorted listings
+    catalog = std::make_unique<BookCatalog>(database.get());
+    
+    // Other instances' writes reach both once the bus is listening; it sends a
+    // "resync" (another rebuild) when LISTEN succeeds, which covers writes
+    // made after these rebuilds but before the listener connected
+    invalidation_bus->subscribe([this](const nlohmann::json& event) { apply_remote_change(event); });
+    facet_index->rebuild();
+    catalog->rebuild();
+    
+    // Initialize file read backend (io_uring when available, pread pool otherwise)
+    file_io = FileIoBackend::create(io_backend);
+    
+    // Initialize inflated entry cache and readahead for sequential page/chapter reads
+    entry_cache = std::make_unique<InflatedEntryCache>();
+    readahead = std::make_unique<ReadaheadEngine>(*entry_cache);
+    file_cache = std::make_unique<FileBufferCache>(file_io.get());
+    
+    // Load the web frontend into memory
+    static_bundle = std::make_unique<StaticBundle>(file_io.get(), web_directory);
+    
+    // Initialize background warming of newly added books
+    prewarm = std::make_unique<PrewarmService>(database.get(), book_manager.get(), file_io.get(), entry_cache.get(),
+                                               page_transcoder.get(), PrewarmService::Budget{});
+    
+    // Initialize library scanners: the upload directory plus any extra roots.
+    // An explicitly configured books directory keeps its own settings.
+    std::vector<LibraryRoot> roots = library_roots;
+    bool books_directory_listed = std::any_of(roots.begin(), roots.end(),
+        [&](const LibraryRoot& root) { return root.path == books_directory; });
+    if (!books_directory_listed) {
+        LibraryRoot upload_root;
+        upload_root.path = books_directory;
+        roots.insert(roots.begin(), upload_root);
+    }
+    scan_scheduler = std::make_unique<ScanScheduler>(database.get(), book_manager.get(), roots,
+                                                     [this](long book_id) {
+                                                         prewarm->enqueue(book_id);
+                                                         collection_manager->refreshSmartMembership(static_cast<int>(book_id));
+                                                         nlohmann::json book = database->get_book_by_id(book_id);
+                                                         if (!book.is_null()) {
+                                                             facet_index->add_book(book_id, book.value("language", ""),
+                                                                                   book.value("file_type", ""));
+                                                         }
+                                                         catalog->upsert(book_id);
+                                                     },
+                                                     [this]() {
+                                                         facet_index->rebuild();
+                                                         catalog->rebuild();
+                                                     });
     
     // Setup server
     setup_cors();
     setup_routes();
     
+    // Initialize streaming engine for file routes
+    if (stream_port > 0) {
+        transfer_engine = std::make_unique<TransferEngine>(stream_port,
+            [this](const TransferRequest& request) { return resolve_stream_request(request); });
+    }
+    
     std::cout << "HTTP Server initialized on port " << port << std::endl;
 }
 
 void HttpServer::setup_cors() {
     // Enable CORS for web client compatibility
-    server.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+    server.set_pre_routing_handler([this](const httplib::Request& req, httplib::Response& res) {
+        // Background warming backs off while requests are coming in
+        prewarm->note_foreground_activity();
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
         res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Session-Token");
+        
+        // API routes without a request body are answered here, skipping httplib's regex routes
+        if ((req.method == "GET" || req.method == "HEAD" || req.method == "DELETE") && router.dispatch(req, res)) {
+            return httplib::Server::HandlerResponse::Handled;
+        }
+        // Everything else a browser GETs is the frontend
+        if ((req.method == "GET" || req.method == "HEAD") && serve_static(req, res)) {
+            return httplib::Server::HandlerResponse::Handled;
+        }
         return httplib::Server::HandlerResponse::Unhandled;
     });
     
@@ -50,75 +276,68 @@ void HttpServer::setup_cors() {
 }
 
 void HttpServer::setup_routes() {
+    // Adapts handlers that take no path parameters
+    auto plain = [this](void (HttpServer::*handler)(const httplib::Request&, httplib::Response&)) {
+        return [this, handler](const httplib::Request& req, httplib::Response& res, const RouteParams&) {
+            (this->*handler)(req, res);
+        };
+    };
+    
     // Health check endpoint
-    server.Get("/api/health", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_health_check(req, res);
-    });
+    router.add("GET", "/api/health", plain(&HttpServer::handle_health_check));
     
     // Authentication endpoints
-    server.Post("/api/register", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_register(req, res);
-    });
-    
-    server.Post("/api/login", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_login(req, res);
-    });
-    
-    server.Post("/api/logout", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_logout(req, res);
-    });
+    router.add("POST", "/api/register", plain(&HttpServer::handle_register));
+    router.add("POST", "/api/login", plain(&HttpServer::handle_login));
+    router.add("POST", "/api/logout", plain(&HttpServer::handle_logout));
     
     // Book management endpoints
-    server.Post("/api/books/upload", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_book_upload(req, res);
-    });
+    router.add("POST", "/api/books/upload", plain(&HttpServer::handle_book_upload));
+    router.add("GET", "/api/books", plain(&HttpServer::handle_list_books));
+    router.add("GET", "/api/books/facets", plain(&HttpServer::handle_book_facets));
+    router.add("GET", "/api/books/catalog", plain(&HttpServer::handle_catalog));
+    router.add("GET", "/api/books/{id}/download", std::bind_front(&HttpServer::handle_book_download, this));
     
-    server.Get("/api/books", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_list_books(req, res);
-    });
-    
-    server.Get(R"(/api/books/(\d+)/download)", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_book_download(req, res);
-    });
+    // Tag endpoints
+    router.add("GET", "/api/books/{id}/tags", std::bind_front(&HttpServer::handle_get_book_tags, this));
+    router.add("PUT", "/api/books/{id}/tags", std::bind_front(&HttpServer::handle_set_book_tags, this));
     
     // File access endpoint (for reading books)
-    server.Get(R"(/api/books/(\d+)/file)", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_book_file_access(req, res);
-    });
+    router.add("GET", "/api/books/{id}/file", std::bind_front(&HttpServer::handle_book_file_access, this));
     
     // Thumbnail access endpoint
-    server.Get(R"(/api/books/(\d+)/thumbnail)", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_book_thumbnail(req, res);
-    });
+    router.add("GET", "/api/books/{id}/thumbnail", std::bind_front(&HttpServer::handle_book_thumbnail, this));
+    
+    // Comic page endpoint
+    router.add("GET", "/api/books/{id}/pages/{page}", std::bind_front(&HttpServer::handle_book_page, this));
+    
+    // EPUB chapter endpoint
+    router.add("GET", "/api/books/{id}/chapters/{chapter}", std::bind_front(&HttpServer::handle_book_chapter, this));
 
     // Library maintenance endpoints
-    server.Post("/api/library/cleanup-orphaned", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_cleanup_orphaned(req, res);
-    });
-    server.Post("/api/library/sync-scan", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_sync_scan(req, res);
-    });
-    server.Post("/api/library/scan", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_library_scan(req, res);
-    });
-    server.Get("/api/library/scan-status", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_scan_status(req, res);
-    });
-    server.Post("/api/library/scan-stop", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_stop_scan(req, res);
-    });
+    router.add("POST", "/api/library/cleanup-orphaned", plain(&HttpServer::handle_cleanup_orphaned));
+    router.add("POST", "/api/library/sync-scan", plain(&HttpServer::handle_sync_scan));
+    router.add("POST", "/api/library/scan", plain(&HttpServer::handle_library_scan));
+    router.add("GET", "/api/library/scan-status", plain(&HttpServer::handle_scan_status));
+    router.add("POST", "/api/library/scan-stop", plain(&HttpServer::handle_stop_scan));
     
-    // Progress tracking endpoints
-    server.Put(R"(/api/books/(\d+)/progress)", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_update_progress(req, res);
-    });
+    // Collection discovery endpoint
+    router.add("GET", "/api/collections/public", plain(&HttpServer::handle_public_collections));
     
-    server.Get(R"(/api/books/(\d+)/progress)", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_get_progress(req, res);
-    });
+    // Progress tracking endpoints
+    router.add("PUT", "/api/books/{id}/progress", std::bind_front(&HttpServer::handle_update_progress, this));
+    router.add("GET", "/api/books/{id}/progress", std::bind_front(&HttpServer::handle_get_progress, this));
     
-    // Serve static files (for web interface)
-    server.set_mount_point("/", "./web");
+    // GET/HEAD/DELETE are dispatched from the pre-routing handler. POST and
+    // PUT bodies are only read after pre-routing, so they come in through
+    // one catch-all per method instead.
+    auto dispatch_with_body = [this](const httplib::Request& req, httplib::Response& res) {
+        if (!router.dispatch(req, res)) {
+            send_error(res, 404, "Not found");
+        }
+    };
+    server.Post(".*", dispatch_with_body);
+    server.Put(".*", dispatch_with_body);
     
     std::cout << "HTTP Server routes configured." << std::endl;
 }
@@ -164,10 +383,89 @@ void HttpServer::send_success(httplib::Response& res, const nlohmann::json& data
     res.set_content(success_response.dump(), "application/json");
 }
 
+void HttpServer::send_buffer(httplib::Response& res, std::shared_ptr<const std::string> buffer,
+                             const std::string& content_type) {
+    size_t size = buffer->size();
+    res.set_content_provider(size, content_type,
+        [buffer = std::move(buffer)](size_t offset, size_t length, httplib::DataSink& sink) {
+            return sink.write(buffer->data() + offset, length);
+        });
+}
+
+bool HttpServer::serve_static(const httplib::Request& req, httplib::Response& res) {
+    const StaticBundle::Asset* asset = static_bundle->find(req.path);
+    if (!asset) {
+        return false;
+    }
+    
+    std::string encoding;
+    const StaticBundle::Variant& variant = StaticBundle::select(*asset, req.get_header_value("Accept-Encoding"), encoding);
+    res.set_header("ETag", variant.etag);
+    res.set_header("Cache-Control", asset->cache_control);
+    if (asset->gzip.data || asset->brotli.data) {
+        res.set_header("Vary", "Accept-Encoding");
+    }
+    
+    std::string if_none_match = req.get_header_value("If-None-Match");
+    if (if_none_match == "*" || if_none_match.find(variant.etag) != std::string::npos) {
+        res.status = 304;
+        return true;
+    }
+    
+    if (!encoding.empty()) {
+        res.set_header("Content-Encoding", encoding);
+    }
+    res.status = 200;
+    send_buffer(res, variant.data, asset->content_type);
+    return true;
+}
+
+void HttpServer::apply_remote_change(const nlohmann::json& event) {
+    // Catalog snapshots follow the catalog version, and cached files are
+    // revalidated against the disk, so the indexes are all there is to update.
+    // Collections aren't cached in this process.
+    std::string kind = event.value("kind", "");
+    if (kind == "book") {
+        long book_id = event.value("id", -1L);
+        nlohmann::json book = database->get_book_by_id(book_id);
+        if (!book.is_null()) {
+            facet_index->add_book(book_id, book.value("language", ""), book.value("file_type", ""));
+        }
+        catalog->upsert(book_id);
+    } else if (kind == "books_removed") {
+        for (long book_id : event.value("ids", std::vector<long>{})) {
+            catalog->remove(book_id);
+            page_transcoder->remove_book(book_id);
+        }
+        facet_index->rebuild();
+    } else if (kind == "library" || kind == "resync") {
+        facet_index->rebuild();
+        catalog->rebuild();
+    } else if (kind == "book_tags") {
+        long book_id = event.value("id", -1L);
+        facet_index->set_tags(book_id, database->get_book_tags(book_id));
+    } else if (kind == "progress") {
+        facet_index->set_progress(event.value("user_id", -1L), event.value("book_id", -1L),
+                                  event.value("percent", 0.0));
+    }
+}
+
 void HttpServer::handle_health_check(const httplib::Request& req, httplib::Response& res) {
     nlohmann::json health_data;
     health_data["status"] = "ok";
     health_data["database_connected"] = database->is_connected();
+    health_data["schema_version"] = database->get_schema_version();
+    health_data["database_replicas"] = database->get_replica_stats();
+    health_data["invalidation_bus"] = invalidation_bus->get_stats();
+    health_data["stream_port"] = transfer_engine ? stream_port : 0;
+    health_data["io_backend"] = file_io->name();
+    health_data["entry_cache"] = entry_cache->get_stats();
+    health_data["file_cache"] = file_cache->get_stats();
+    health_data["static_bundle"] = static_bundle->get_stats();
+    health_data["archive_handles"] = ArchiveHandlePool::shared().get_stats();
+    health_data["prewarm"] = prewarm->get_stats();
+    health_data["facet_index"] = facet_index->get_stats();
+    health_data["catalog"] = catalog->get_stats();
     health_data["timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
     
@@ -279,16 +577,22 @@ void HttpServer::handle_book_upload(const httplib::Request& req, httplib::Respon
             return;
         }
         
+        long user_id = database->get_user_id(username);
+        if (user_id == -1) {
+            send_error(res, 404, "User not found");
+            return;
+        }
+        
         // Save book file and extract metadata
         BookInfo book_info = book_manager->save_uploaded_book(
             file.content, file.filename, file.content_type);
         
         // Override title and author if provided in form data
         if (req.has_param("title") && !req.get_param_value("title").empty()) {
-            book_info.title = req.get_param_value("title");
+            book_info.title = TextNormalizer::normalize(req.get_param_value("title"));
         }
         if (req.has_param("author") && !req.get_param_value("author").empty()) {
-            book_info.author = req.get_param_value("author");
+            book_info.author = TextNormalizer::normalize(req.get_param_value("author"));
         }
         
         // Add book to database with full metadata
@@ -302,7 +606,14 @@ void HttpServer::handle_book_upload(const httplib::Request& req, httplib::Respon
                                          book_info.thumbnail_path,
                                          book_info.metadata.page_count,
                                          book_info.metadata_extracted,
-                                         book_info.extraction_error);
+                                         book_info.extraction_error,
+                                         user_id);
+        if (book_id > 0) {
+            prewarm->enqueue(book_id);
+            collection_manager->refreshSmartMembership(static_cast<int>(book_id));
+            facet_index->add_book(book_id, book_info.metadata.language, book_info.file_type);
+            catalog->upsert(book_id);
+        }
         
         nlohmann::json response_data;
         response_data["message"] = "Book uploaded successfully";
@@ -328,16 +639,15 @@ void HttpServer::handle_list_books(const httplib::Request& req, httplib::Respons
             return;
         }
         
-        // Get user ID
-        long user_id = database->get_user_id(username);
+        // Get books with progress (?sort=title|author, default: recently read)
+        std::string order_by = req.has_param("sort") ? req.get_param_value("sort") : "recent";
+        long user_id = -1;
+        nlohmann::json books = database->get_user_books_with_progress(username, user_id, order_by);
         if (user_id == -1) {
             send_error(res, 404, "User not found");
             return;
         }
         
-        // Get books with progress
-        nlohmann::json books = database->get_user_books_with_progress(user_id);
-        
         send_success(res, books);
         
     } catch (const std::exception& e) {
@@ -345,7 +655,7 @@ void HttpServer::handle_list_books(const httplib::Request& req, httplib::Respons
     }
 }
 
-void HttpServer::handle_update_progress(const httplib::Request& req, httplib::Response& res) {
+void HttpServer::handle_catalog(const httplib::Request& req, httplib::Response& res) {
     try {
         // Validate session
         std::string username = validate_session(req);
@@ -354,11 +664,148 @@ void HttpServer::handle_update_progress(const httplib::Request& req, httplib::Re
             return;
         }
         
-        // Parse book ID from URL
-        long book_id = std::stol(req.matches[1]);
+        BookCatalog::Query query;
+        if (req.has_param("sort") && !BookCatalog::parse_sort_key(req.get_param_value("sort"), query.sort)) {
+            send_error(res, 400, "sort must be one of title, author, size, date");
+            return;
+        }
+        // Dates and sizes default to largest first, names to A-Z
+        query.descending = query.sort == BookCatalog::SortKey::Date || query.sort == BookCatalog::SortKey::Size;
+        if (req.has_param("order")) {
+            query.descending = req.get_param_value("order") == "desc";
+        }
+        query.format = req.get_param_value("format");
+        query.language = req.get_param_value("language");
+        query.author = req.get_param_value("author");
+        long offset = 0;
+        long limit = static_cast<long>(query.limit);
+        const std::pair<const char*, long*> numeric_params[] = {
+            {"min_size", &query.min_size}, {"max_size", &query.max_size}, {"offset", &offset}, {"limit", &limit}
+        };
+        for (const auto& [name, target] : numeric_params) {
+            if (!parse_long_param(req, name, *target)) {
+                send_error(res, 400, std::string(name) + " must be an integer");
+                return;
+            }
+        }
+        query.offset = static_cast<size_t>(std::max(0L, offset));
+        query.limit = static_cast<size_t>(std::clamp(limit, 1L, 500L));
+        
+        // Identical queries against an unchanged catalog reuse the serialized response
+        // (text values are length-prefixed, so values containing the separator can't collide)
+        std::string snapshot_key = std::to_string(static_cast<int>(query.sort)) + (query.descending ? "d" : "a");
+        for (const std::string* text : {&query.format, &query.language, &query.author}) {
+            snapshot_key += "|" + std::to_string(text->size()) + ":" + *text;
+        }
+        snapshot_key += "|" + std::to_string(query.min_size) + "|" + std::to_string(query.max_size) + "|" +
+            std::to_string(query.offset) + "|" + std::to_string(query.limit);
+        uint64_t version = catalog->version();
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex);
+            if (snapshot_version != version) {
+                catalog_snapshots.clear();
+                snapshot_version = version;
+            }
+            auto it = catalog_snapshots.find(snapshot_key);
+            if (it != catalog_snapshots.end()) {
+                send_buffer(res, it->second, "application/json");
+                return;
+            }
+        }
+        
+        BookCatalog::Page page = catalog->query(query);
+        
+        nlohmann::json response_data;
+        response_data["total"] = page.total;
+        response_data["offset"] = query.offset;
+        response_data["limit"] = query.limit;
+        response_data["books"] = std::move(page.books);
+        
+        nlohmann::json success_response;
+        success_response["success"] = true;
+        success_response["data"] = std::move(response_data);
+        auto snapshot = std::make_shared<const std::string>(success_response.dump());
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex);
+            if (snapshot_version == version && catalog_snapshots.size() < MAX_CATALOG_SNAPSHOTS) {
+                catalog_snapshots.emplace(snapshot_key, snapshot);
+            }
+        }
+        send_buffer(res, std::move(snapshot), "application/json");
+        
+    } catch (const std::exception& e) {
+        send_error(res, 400, e.what());
+    }
+}
+
+void HttpServer::handle_public_collections(const httplib::Request& req, httplib::Response& res) {
+    try {
+        // Validate session
+        std::string username = validate_session(req);
+        if (username.empty()) {
+            send_error(res, 401, "Authentication required");
+            return;
+        }
+        
+        long limit = 50;
+        if (!parse_long_param(req, "limit", limit)) {
+            send_error(res, 400, "limit must be an integer");
+            return;
+        }
+        std::string cursor = req.get_param_value("cursor");
+        std::string cursor_created_at;
+        int cursor_id = 0;
+        if (!cursor.empty() && !CollectionManager::parsePageCursor(cursor, cursor_created_at, cursor_id)) {
+            send_error(res, 400, "Invalid cursor");
+            return;
+        }
+        CollectionPage page = collection_manager->getPublicCollectionsPage(static_cast<int>(std::clamp(limit, 1L, 100L)), cursor);
+        
+        nlohmann::json collections = nlohmann::json::array();
+        for (const Collection& collection : page.collections) {
+            collections.push_back({
+                {"id", collection.id},
+                {"name", collection.name},
+                {"description", collection.description},
+                {"owner_id", collection.owner_id},
+                {"owner_username", collection.owner_username},
+                {"created_at", collection.created_at},
+                {"updated_at", collection.updated_at},
+                {"book_count", collection.book_count},
+                {"is_smart", collection.is_smart}
+            });
+        }
+        
+        nlohmann::json response_data;
+        response_data["collections"] = std::move(collections);
+        response_data["next_cursor"] = page.next_cursor;
+        send_success(res, response_data);
+        
+    } catch (const std::exception& e) {
+        send_error(res, 400, e.what());
+    }
+}
+
+void HttpServer::handle_update_progress(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
+    try {
+        // Validate session
+        std::string username = validate_session(req);
+        if (username.empty()) {
+            send_error(res, 401, "Authentication required");
+            return;
+        }
         
-        // Parse progress data
-        nlohmann::json progress_data = nlohmann::json::parse(req.body);
+        // Parse book ID from URL
+        long book_id = params[0];
+        
+        // Validate the body and pick out the fields we need in one pass;
+        // the body itself is stored as sent
+        ProgressJson::Fields fields;
+        std::string json_error;
+        if (!ProgressJson::scan(req.body, fields, json_error)) {
+            send_error(res, 400, "Invalid JSON in request body: " + json_error);
+            return;
+        }
         
         // Get user ID
         long user_id = database->get_user_id(username);
@@ -368,23 +815,26 @@ void HttpServer::handle_update_progress(const httplib::Request& req, httplib::Re
         }
         
         // Update progress
-        database->update_user_book_progress(user_id, book_id, progress_data);
+        bool first_progress = database->update_user_book_progress_raw(user_id, book_id, req.body);
+        
+        // Only opening a book can change smart membership ("unread" rules);
+        // later page turns leave it as it is
+        if (first_progress) {
+            collection_manager->refreshSmartMembership(static_cast<int>(book_id));
+        }
+        facet_index->set_progress(user_id, book_id, fields.has_percent ? fields.progress_percent : 0.0);
         
         nlohmann::json response_data;
-        response_data["message"] = "Progress updated successfully";
         response_data["book_id"] = book_id;
-        response_data["progress"] = progress_data;
         
         send_success(res, response_data);
         
-    } catch (const nlohmann::json::parse_error& e) {
-        send_error(res, 400, "Invalid JSON in request body");
     } catch (const std::exception& e) {
         send_error(res, 400, e.what());
     }
 }
 
-void HttpServer::handle_get_progress(const httplib::Request& req, httplib::Response& res) {
+void HttpServer::handle_get_progress(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
     try {
         // Validate session
         std::string username = validate_session(req);
@@ -394,7 +844,7 @@ void HttpServer::handle_get_progress(const httplib::Request& req, httplib::Respo
         }
         
         // Parse book ID from URL
-        long book_id = std::stol(req.matches[1]);
+        long book_id = params[0];
         
         // Get user ID
         long user_id = database->get_user_id(username);
@@ -417,7 +867,73 @@ void HttpServer::handle_get_progress(const httplib::Request& req, httplib::Respo
     }
 }
 
-void HttpServer::handle_book_download(const httplib::Request& req, httplib::Response& res) {
+void HttpServer::handle_book_facets(const httplib::Request& req, httplib::Response& res) {
+    try {
+        // Validate session
+        std::string username = validate_session(req);
+        if (username.empty()) {
+            send_error(res, 401, "Authentication required");
+            return;
+        }
+        
+        // Get user ID
+        long user_id = database->get_user_id(username);
+        if (user_id == -1) {
+            send_error(res, 404, "User not found");
+            return;
+        }
+        
+        FacetIndex::Query query;
+        query.user_id = user_id;
+        for (const char* facet : {"tag", "language", "format", "read_state"}) {
+            size_t count = req.get_param_value_count(facet);
+            for (size_t i = 0; i < count; i++) {
+                std::string value = req.get_param_value(facet, i);
+                if (std::string(facet) == "tag") {
+                    auto normalized = FacetIndex::normalize_tags({value});
+                    if (normalized.empty()) {
+                        continue;
+                    }
+                    value = normalized.front();
+                }
+                query.filters[facet].push_back(value);
+            }
+        }
+        
+        long offset_param = 0;
+        long limit_param = 100;
+        if (!parse_long_param(req, "offset", offset_param)) {
+            send_error(res, 400, "offset must be an integer");
+            return;
+        }
+        if (!parse_long_param(req, "limit", limit_param)) {
+            send_error(res, 400, "limit must be an integer");
+            return;
+        }
+        size_t offset = static_cast<size_t>(std::max(0L, offset_param));
+        size_t limit = static_cast<size_t>(std::clamp(limit_param, 1L, 500L));
+        
+        FacetIndex::Result result = facet_index->query(query);
+        
+        // Counts cover every match; only the requested page of IDs is sent
+        size_t begin = std::min(offset, result.book_ids.size());
+        size_t end = std::min(result.book_ids.size(), begin + limit);
+        
+        nlohmann::json response_data;
+        response_data["book_ids"] = std::vector<long>(result.book_ids.begin() + begin, result.book_ids.begin() + end);
+        response_data["total"] = result.book_ids.size();
+        response_data["offset"] = offset;
+        response_data["limit"] = limit;
+        response_data["facets"] = result.counts;
+        
+        send_success(res, response_data);
+        
+    } catch (const std::exception& e) {
+        send_error(res, 500, "Failed to filter books");
+    }
+}
+
+void HttpServer::handle_get_book_tags(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
     try {
         // Validate session
         std::string username = validate_session(req);
@@ -427,20 +943,89 @@ void HttpServer::handle_book_download(const httplib::Request& req, httplib::Resp
         }
         
         // Parse book ID from URL
-        long book_id = std::stol(req.matches[1]);
+        long book_id = params[0];
         
-        // Get book information from database
-        nlohmann::json all_books = database->get_all_books();
-        nlohmann::json book_info;
+        nlohmann::json response_data;
+        response_data["book_id"] = book_id;
+        response_data["tags"] = database->get_book_tags(book_id);
+        
+        send_success(res, response_data);
+        
+    } catch (const std::exception& e) {
+        send_error(res, 400, e.what());
+    }
+}
+
+void HttpServer::handle_set_book_tags(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
+    try {
+        // Validate session
+        std::string username = validate_session(req);
+        if (username.empty()) {
+            send_error(res, 401, "Authentication required");
+            return;
+        }
+        
+        // Parse book ID from URL
+        long book_id = params[0];
         
-        for (const auto& book : all_books) {
-            if (book["id"] == book_id) {
-                book_info = book;
-                break;
+        // Parse tag list
+        nlohmann::json body = nlohmann::json::parse(req.body);
+        if (!body.contains("tags") || !body["tags"].is_array()) {
+            send_error(res, 400, "Request body must contain a tags array");
+            return;
+        }
+        std::vector<std::string> raw_tags;
+        for (const auto& tag : body["tags"]) {
+            if (tag.is_string()) {
+                raw_tags.push_back(tag.get<std::string>());
             }
         }
+        std::vector<std::string> tags = FacetIndex::normalize_tags(raw_tags);
         
-        if (book_info.empty()) {
+        if (database->get_book_by_id(book_id).is_null()) {
+            send_error(res, 404, "Book not found");
+            return;
+        }
+        long user_id = database->get_user_id(username);
+        if (user_id == -1 || !database->can_edit_book(book_id, user_id)) {
+            send_error(res, 403, "Only the uploader or an administrator can change the tags of this book");
+            return;
+        }
+        if (!database->set_book_tags(book_id, tags)) {
+            send_error(res, 500, "Failed to update tags");
+            return;
+        }
+        facet_index->set_tags(book_id, tags);
+        
+        nlohmann::json response_data;
+        response_data["message"] = "Tags updated successfully";
+        response_data["book_id"] = book_id;
+        response_data["tags"] = tags;
+        
+        send_success(res, response_data);
+        
+    } catch (const nlohmann::json::parse_error& e) {
+        send_error(res, 400, "Invalid JSON in request body");
+    } catch (const std::exception& e) {
+        send_error(res, 400, e.what());
+    }
+}
+
+void HttpServer::handle_book_download(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
+    try {
+        // Validate session
+        std::string username = validate_session(req);
+        if (username.empty()) {
+            send_error(res, 401, "Authentication required");
+            return;
+        }
+        
+        // Parse book ID from URL
+        long book_id = params[0];
+        
+        // Get book information from database
+        nlohmann::json book_info = database->get_book_by_id(book_id);
+        if (book_info.is_null()) {
             send_error(res, 404, "Book not found");
             return;
         }
@@ -453,21 +1038,17 @@ void HttpServer::handle_book_download(const httplib::Request& req, httplib::Resp
             return;
         }
         
-        // Read file content
-        std::ifstream file(file_path, std::ios::binary);
-        if (!file.is_open()) {
+        // Read file content (borrowed: it is copied into the response right away)
+        FileReadResult file = file_io->read_file(file_path, true);
+        if (!file.ok) {
             send_error(res, 500, "Failed to open book file");
             return;
         }
-        
-        // Get file content
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        file.close();
+        std::string_view content = file.bytes();
         
         // Set appropriate headers
         std::string filename = book_info["title"].get<std::string>() + "." + book_info["file_type"].get<std::string>();
-        res.set_header("Content-Disposition", "attachment; filename=\"" + filename + "\"");
+        res.set_header("Content-Disposition", attachment_disposition(filename));
         
         // Set content type based on file type
         std::string file_type = book_info["file_type"];
@@ -483,14 +1064,14 @@ void HttpServer::handle_book_download(const httplib::Request& req, httplib::Resp
             res.set_header("Content-Type", "application/octet-stream");
         }
         
-        res.set_content(content, res.get_header_value("Content-Type"));
+        res.set_content(content.data(), content.size(), res.get_header_value("Content-Type"));
         
     } catch (const std::exception& e) {
         send_error(res, 400, e.what());
     }
 }
 
-void HttpServer::handle_book_file_access(const httplib::Request& req, httplib::Response& res) {
+void HttpServer::handle_book_file_access(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
     try {
         // Validate session
         std::string username = validate_session(req);
@@ -500,20 +1081,11 @@ void HttpServer::handle_book_file_access(const httplib::Request& req, httplib::R
         }
         
         // Parse book ID from URL
-        long book_id = std::stol(req.matches[1]);
+        long book_id = params[0];
         
         // Get book information from database
-        nlohmann::json all_books = database->get_all_books();
-        nlohmann::json book_info;
-        
-        for (const auto& book : all_books) {
-            if (book["id"] == book_id) {
-                book_info = book;
-                break;
-            }
-        }
-        
-        if (book_info.empty()) {
+        nlohmann::json book_info = database->get_book_by_id(book_id);
+        if (book_info.is_null()) {
             send_error(res, 404, "Book not found");
             return;
         }
@@ -526,17 +1098,13 @@ void HttpServer::handle_book_file_access(const httplib::Request& req, httplib::R
             return;
         }
         
-        // Read file content
-        std::ifstream file(file_path, std::ios::binary);
-        if (!file.is_open()) {
+        // Read file content (borrowed: it is copied into the response right away)
+        FileReadResult file = file_io->read_file(file_path, true);
+        if (!file.ok) {
             send_error(res, 500, "Failed to open book file");
             return;
         }
-        
-        // Get file content
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        file.close();
+        std::string_view content = file.bytes();
         
         // Set appropriate headers for inline viewing
         std::string file_type = book_info["file_type"];
@@ -554,7 +1122,7 @@ void HttpServer::handle_book_file_access(const httplib::Request& req, httplib::R
         
         // For inline viewing (not download)
         res.set_header("Content-Disposition", "inline");
-        res.set_content(content, res.get_header_value("Content-Type"));
+        res.set_content(content.data(), content.size(), res.get_header_value("Content-Type"));
         
     } catch (const std::exception& e) {
         send_error(res, 400, e.what());
@@ -567,6 +1135,14 @@ bool HttpServer::start() {
         std::cout << "API endpoints available at: http://localhost:" << port << "/api/" << std::endl;
         std::cout << "Web interface available at: http://localhost:" << port << "/" << std::endl;
         
+        if (transfer_engine && !transfer_engine->start()) {
+            std::cerr << "Streaming engine failed to start; file routes stay on port " << port << std::endl;
+            transfer_engine.reset();
+        }
+        
+        // Pick up scans that were still running when the server last stopped
+        scan_scheduler->resume_interrupted();
+        
         return server.listen("0.0.0.0", port);
     } catch (const std::exception& e) {
         std::cerr << "Failed to start server: " << e.what() << std::endl;
@@ -574,23 +1150,14 @@ bool HttpServer::start() {
     }
 }
 
-void HttpServer::handle_book_thumbnail(const httplib::Request& req, httplib::Response& res) {
+void HttpServer::handle_book_thumbnail(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
     try {
         // Parse book ID from URL
-        long book_id = std::stol(req.matches[1]);
+        long book_id = params[0];
         
         // Get book information from database
-        nlohmann::json all_books = database->get_all_books();
-        nlohmann::json book_info;
-        
-        for (const auto& book : all_books) {
-            if (book["id"] == book_id) {
-                book_info = book;
-                break;
-            }
-        }
-        
-        if (book_info.empty()) {
+        nlohmann::json book_info = database->get_book_by_id(book_id);
+        if (book_info.is_null()) {
             send_error(res, 404, "Book not found");
             return;
         }
@@ -602,21 +1169,14 @@ void HttpServer::handle_book_thumbnail(const httplib::Request& req, httplib::Res
         }
         
         if (thumbnail_path.empty() || !fs::exists(thumbnail_path)) {
+            if (thumbnail_path.empty()) {
+                // Books scanned before covers were generated get one in the background
+                prewarm->enqueue(book_id);
+            }
             send_error(res, 404, "Thumbnail not found");
             return;
         }
         
-        // Read thumbnail file
-        std::ifstream file(thumbnail_path, std::ios::binary);
-        if (!file.is_open()) {
-            send_error(res, 500, "Failed to read thumbnail file");
-            return;
-        }
-        
-        std::string content((std::istreambuf_iterator<char>(file)),
-                          std::istreambuf_iterator<char>());
-        file.close();
-        
         // Determine content type based on file extension
         std::string content_type = "application/octet-stream";
         if (thumbnail_path.ends_with(".svg")) {
@@ -627,13 +1187,297 @@ void HttpServer::handle_book_thumbnail(const httplib::Request& req, httplib::Res
             content_type = "image/png";
         }
         
-        res.set_content(content, content_type);
+        // Smaller sizes come from the transcode cache
+        int width = parse_page_width(req.get_param_value("w"));
+        if (width > 0) {
+            resize_thumbnail(book_id, width, req.get_param_value("format"), req.get_header_value("Accept"),
+                             thumbnail_path, content_type);
+        }
+        
+        // Read thumbnail file
+        FileBufferCache::Buffer content = file_cache->get(thumbnail_path);
+        if (!content) {
+            send_error(res, 500, "Failed to read thumbnail file");
+            return;
+        }
+        
+        send_buffer(res, std::move(content), content_type);
         
     } catch (const std::exception& e) {
         send_error(res, 500, "Failed to get thumbnail: " + std::string(e.what()));
     }
 }
 
+bool HttpServer::resize_thumbnail(long book_id, int width, const std::string& format, const std::string& accept,
+                                  std::string& thumbnail_path, std::string& content_type) {
+    // SVG placeholders scale on their own
+    if (thumbnail_path.ends_with(".svg")) {
+        return false;
+    }
+    
+    try {
+        std::string source_path = thumbnail_path;
+        PageTranscoder::Output output = page_transcoder->get_thumbnail(
+            book_id, source_path, width, PageTranscoder::negotiate_format(format, accept), [&] {
+                FileReadResult file = file_io->read_file(source_path);
+                if (!file.ok) {
+                    throw std::runtime_error(file.error);
+                }
+                return std::make_shared<const std::string>(std::move(file.data));
+            });
+        thumbnail_path = output.file_path;
+        content_type = output.content_type;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "HttpServer: Resizing thumbnail of book " << book_id << " failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void HttpServer::handle_book_page(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
+    try {
+        // Validate session
+        std::string username = validate_session(req);
+        if (username.empty()) {
+            send_error(res, 401, "Authentication required");
+            return;
+        }
+        
+        // Parse book ID and page index from URL
+        long book_id = params[0];
+        long page_index = params[1];
+        
+        int width = parse_page_width(req.get_param_value("w"));
+        TransferTarget target = resolve_book_page(book_id, page_index, username, width,
+                                                  req.get_param_value("format"),
+                                                  req.get_header_value("Accept"));
+        res.status = target.status;
+        for (const auto& [name, value] : target.headers) {
+            res.set_header(name, value);
+        }
+        if (!target.file_path.empty()) {
+            target.shared_body = file_cache->get(target.file_path);
+            if (!target.shared_body) {
+                send_error(res, 500, "Failed to read transcoded page");
+                return;
+            }
+        }
+        if (target.shared_body) {
+            send_buffer(res, std::move(target.shared_body), target.content_type);
+        } else {
+            res.set_content(target.body, target.content_type);
+        }
+        
+    } catch (const std::exception& e) {
+        send_error(res, 400, e.what());
+    }
+}
+
+void HttpServer::handle_book_chapter(const httplib::Request& req, httplib::Response& res, const RouteParams& params) {
+    try {
+        // Validate session
+        std::string username = validate_session(req);
+        if (username.empty()) {
+            send_error(res, 401, "Authentication required");
+            return;
+        }
+        
+        // Parse book ID and chapter index from URL
+        long book_id = params[0];
+        long chapter_index = params[1];
+        
+        TransferTarget target = resolve_book_chapter(book_id, chapter_index, username);
+        res.status = target.status;
+        for (const auto& [name, value] : target.headers) {
+            res.set_header(name, value);
+        }
+        if (target.shared_body) {
+            send_buffer(res, std::move(target.shared_body), target.content_type);
+        } else {
+            res.set_content(target.body, target.content_type);
+        }
+        
+    } catch (const std::exception& e) {
+        send_error(res, 400, e.what());
+    }
+}
+
+TransferTarget HttpServer::resolve_book_page(long book_id, long page_index, const std::string& username,
+                                             int width, const std::string& format, const std::string& accept) {
+    nlohmann::json book_info = database->get_book_by_id(book_id);
+    if (book_info.is_null()) {
+        return error_target(404, "Book not found");
+    }
+    
+    if (book_info["file_type"] != "cbz") {
+        return error_target(400, "Page access is only supported for CBZ books");
+    }
+    
+    std::string file_path = book_info["file_path"];
+    std::vector<std::string> pages = BookManager::list_archive_pages(file_path);
+    if (page_index < 0 || page_index >= static_cast<long>(pages.size())) {
+        return error_target(404, "Page not found");
+    }
+    
+    const std::string& entry = pages[page_index];
+    
+    TransferTarget target;
+    target.status = 200;
+    target.headers.emplace_back("X-Page-Count", std::to_string(pages.size()));
+    target.headers.emplace_back("Cache-Control", "private, max-age=86400");
+    readahead->on_access(username + ":" + std::to_string(book_id), file_path, pages, page_index);
+    
+    if (width > 0 || !format.empty()) {
+        try {
+            std::string output_format = PageTranscoder::negotiate_format(format, accept);
+            PageTranscoder::Output output = page_transcoder->get_page(
+                book_id, page_index, file_path, width > 0 ? width : PageTranscoder::snap_width(INT32_MAX),
+                output_format, [&] { return entry_cache->get_or_inflate(file_path, entry); });
+            target.file_path = output.file_path;
+            target.content_type = output.content_type;
+            if (format.empty() || format == "auto") {
+                target.headers.emplace_back("Vary", "Accept");
+            }
+            return target;
+        } catch (const std::exception& e) {
+            // GIF/AVIF pages and corrupt images are served as stored
+            std::cerr << "HttpServer: Transcoding page " << page_index << " of book " << book_id
+                      << " failed: " << e.what() << std::endl;
+        }
+    }
+    
+    target.shared_body = entry_cache->get_or_inflate(file_path, entry);
+    target.content_type = BookManager::get_image_content_type(entry);
+    return target;
+}
+
+TransferTarget HttpServer::resolve_book_chapter(long book_id, long chapter_index, const std::string& username) {
+    nlohmann::json book_info = database->get_book_by_id(book_id);
+    if (book_info.is_null()) {
+        return error_target(404, "Book not found");
+    }
+    
+    if (book_info["file_type"] != "epub") {
+        return error_target(400, "Chapter access is only supported for EPUB books");
+    }
+    
+    std::string file_path = book_info["file_path"];
+    std::vector<std::string> chapters = BookManager::list_epub_chapters(file_path);
+    if (chapter_index < 0 || chapter_index >= static_cast<long>(chapters.size())) {
+        return error_target(404, "Chapter not found");
+    }
+    
+    const std::string& entry = chapters[chapter_index];
+    
+    TransferTarget target;
+    target.status = 200;
+    target.shared_body = entry_cache->get_or_inflate(file_path, entry);
+    readahead->on_access(username + ":" + std::to_string(book_id), file_path, chapters, chapter_index);
+    
+    target.content_type = "application/xhtml+xml";
+    // Lets the client resolve relative links (images, stylesheets) inside the chapter.
+    // The href comes from the archive's OPF, so it is sent URL-encoded like a path
+    target.headers.emplace_back("X-Chapter-Path", percent_encode(entry, "/-._~"));
+    target.headers.emplace_back("X-Chapter-Count", std::to_string(chapters.size()));
+    target.headers.emplace_back("Cache-Control", "private, max-age=86400");
+    return target;
+}
+
+TransferTarget HttpServer::resolve_stream_request(const TransferRequest& request) {
+    prewarm->note_foreground_activity();
+    
+    // CORS preflight: pages served from the API port send the token in a header
+    if (request.method == "OPTIONS") {
+        TransferTarget target;
+        target.status = 204;
+        target.content_type = "text/plain";
+        target.headers.emplace_back("Access-Control-Allow-Methods", "GET, HEAD, OPTIONS");
+        target.headers.emplace_back("Access-Control-Allow-Headers", "Authorization, X-Session-Token, Range");
+        target.headers.emplace_back("Access-Control-Max-Age", "86400");
+        return target;
+    }
+    
+    if (request.method != "GET" && request.method != "HEAD") {
+        return error_target(405, "Method not allowed");
+    }
+    
+    long book_id = 0;
+    long page_index = -1;
+    std::string action;
+    if (!parse_book_route(request.path, book_id, action, page_index)) {
+        return error_target(404, "Not found");
+    }
+    
+    // Thumbnails are public like on the API port; everything else needs a session.
+    // The token is only taken from headers: in the URL it would end up in
+    // access logs, browser history and Referer headers
+    std::string username;
+    if (action != "thumbnail") {
+        std::string token;
+        std::string auth_header = request.header("Authorization");
+        if (auth_header.rfind("Bearer ", 0) == 0) {
+            token = auth_header.substr(7);
+        }
+        if (token.empty()) token = request.header("X-Session-Token");
+        
+        if (!token.empty()) username = Auth::validate_session_token(token);
+        if (username.empty()) {
+            return error_target(401, "Authentication required");
+        }
+    }
+    
+    if (action == "pages" && page_index >= 0) {
+        return resolve_book_page(book_id, page_index, username, parse_page_width(request.query_param("w")),
+                                 request.query_param("format"), request.header("Accept"));
+    }
+    if (action == "chapters" && page_index >= 0) {
+        return resolve_book_chapter(book_id, page_index, username);
+    }
+    if (page_index >= 0) {
+        return error_target(404, "Not found");
+    }
+    
+    nlohmann::json book_info = database->get_book_by_id(book_id);
+    if (book_info.is_null()) {
+        return error_target(404, "Book not found");
+    }
+    
+    TransferTarget target;
+    target.status = 200;
+    
+    if (action == "download" || action == "file") {
+        std::string file_type = book_info["file_type"];
+        target.file_path = book_info["file_path"];
+        target.content_type = book_content_type(file_type);
+        if (action == "download") {
+            std::string filename = book_info["title"].get<std::string>() + "." + file_type;
+            target.headers.emplace_back("Content-Disposition", attachment_disposition(filename));
+        } else {
+            target.headers.emplace_back("Content-Disposition", "inline");
+        }
+        return target;
+    }
+    
+    if (action == "thumbnail") {
+        std::string thumbnail_path = book_info["thumbnail_path"];
+        if (thumbnail_path.empty()) {
+            prewarm->enqueue(book_id);
+            return error_target(404, "Thumbnail not found");
+        }
+        target.content_type = thumbnail_content_type(thumbnail_path);
+        int width = parse_page_width(request.query_param("w"));
+        if (width > 0) {
+            resize_thumbnail(book_id, width, request.query_param("format"), request.header("Accept"),
+                             thumbnail_path, target.content_type);
+        }
+        target.file_path = thumbnail_path;
+        target.headers.emplace_back("Cache-Control", "public, max-age=86400");
+        return target;
+    }
+    
+    return error_target(404, "Not found");
+}
+
 void HttpServer::handle_cleanup_orphaned(const httplib::Request& req, httplib::Response& res) {
     // Validate session
     std::string username = validate_session(req);
@@ -651,6 +1495,10 @@ void HttpServer::handle_cleanup_orphaned(const httplib::Request& req, httplib::R
     
     try {
         int cleaned_count = database->cleanup_orphaned_books();
+        if (cleaned_count > 0) {
+            facet_index->rebuild();
+            catalog->rebuild();
+        }
         
         nlohmann::json response;
         response["success"] = true;
@@ -682,15 +1530,22 @@ void HttpServer::handle_sync_scan(const httplib::Request& req, httplib::Response
     }
     
     try {
-        // Get books directory from book manager (assuming it has a getter)
-        std::string books_directory = book_manager->get_books_directory();
+        // ?root= limits the scan to one library root; all roots otherwise
+        std::string root = req.get_param_value("root");
+        if (!root.empty() && !scan_scheduler->has_root(root)) {
+            send_error(res, 404, "Unknown library root");
+            return;
+        }
         
-        bool started = library_scanner->start_sync_scan(books_directory, true);  // cleanup_orphaned = true
+        // ?restart=true ignores the checkpoint of an earlier, unfinished scan
+        bool restart = req.get_param_value("restart") == "true";
+        std::vector<std::string> started = scan_scheduler->start(root, true, restart);  // cleanup_orphaned = true
         
         nlohmann::json response;
-        if (started) {
+        if (!started.empty()) {
             response["success"] = true;
             response["message"] = "Library synchronization scan started";
+            response["roots"] = started;
             res.set_content(response.dump(4), "application/json");
             
             std::cout << "Sync scan started by user " << user_id << std::endl;
@@ -722,15 +1577,21 @@ void HttpServer::handle_library_scan(const httplib::Request& req, httplib::Respo
     }
     
     try {
-        // Get books directory from book manager
-        std::string books_directory = book_manager->get_books_directory();
+        // ?root= limits the scan to one library root; all roots otherwise
+        std::string root = req.get_param_value("root");
+        if (!root.empty() && !scan_scheduler->has_root(root)) {
+            send_error(res, 404, "Unknown library root");
+            return;
+        }
         
-        bool started = library_scanner->start_scan(books_directory);  // Regular scan, no cleanup
+        bool restart = req.get_param_value("restart") == "true";
+        std::vector<std::string> started = scan_scheduler->start(root, false, restart);  // Regular scan, no cleanup
         
         nlohmann::json response;
-        if (started) {
+        if (!started.empty()) {
             response["success"] = true;
             response["message"] = "Library scan started";
+            response["roots"] = started;
             res.set_content(response.dump(4), "application/json");
             std::cout << "Library scan started by user " << user_id << std::endl;
         } else {
@@ -760,22 +1621,42 @@ void HttpServer::handle_scan_status(const httplib::Request& req, httplib::Respon
     }
     
     try {
-        ScanStatus status = library_scanner->get_status();
-        
-        nlohmann::json response;
-        response["is_scanning"] = status.is_scanning;
-        response["progress_percentage"] = status.progress_percentage;
-        response["current_book"] = status.current_book;
-        response["total_books"] = status.total_books;
-        response["processed_books"] = status.processed_books;
-        response["orphaned_cleaned"] = status.orphaned_cleaned;
-        response["errors"] = status.errors;
-        
-        // Convert start_time to timestamp
-        if (status.is_scanning) {
-            auto epoch = status.start_time.time_since_epoch();
-            auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(epoch).count();
-            response["start_timestamp"] = timestamp;
+        auto root_statuses = scan_scheduler->get_status();
+        
+        auto status_json = [](const ScanStatus& status) {
+            nlohmann::json json;
+            json["is_scanning"] = status.is_scanning;
+            json["progress_percentage"] = status.progress_percentage;
+            json["current_book"] = status.current_book;
+            json["total_books"] = status.total_books;
+            json["processed_books"] = status.processed_books;
+            json["orphaned_cleaned"] = status.orphaned_cleaned;
+            json["resumed"] = status.resumed;
+            json["errors"] = status.errors;
+            
+            // Convert start_time to timestamp
+            if (status.is_scanning) {
+                auto epoch = status.start_time.time_since_epoch();
+                auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(epoch).count();
+                json["start_timestamp"] = timestamp;
+            }
+            return json;
+        };
+        
+        // Top-level fields combine all roots; "roots" has the per-root detail
+        nlohmann::json response = status_json(ScanScheduler::combine(root_statuses));
+        response["roots"] = nlohmann::json::array();
+        for (const auto& [root, status] : root_statuses) {
+            nlohmann::json root_json = status_json(status);
+            root_json["path"] = root.path;
+            root_json["concurrency"] = root.limits.concurrency;
+            root_json["files_per_second"] = root.limits.files_per_second;
+            root_json["interval_minutes"] = root.interval.count();
+            if (root.interval.count() > 0) {
+                auto next = scan_scheduler->next_scheduled_scan(root.path).time_since_epoch();
+                root_json["next_scan_timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(next).count();
+            }
+            response["roots"].push_back(root_json);
         }
         
         res.set_content(response.dump(4), "application/json");
@@ -801,7 +1682,8 @@ void HttpServer::handle_stop_scan(const httplib::Request& req, httplib::Response
     }
     
     try {
-        library_scanner->stop_scan();
+        // ?discard=true drops the progress, so the next scan starts from the beginning
+        scan_scheduler->stop_scan(req.get_param_value("root"), req.get_param_value("discard") == "true");
         
         nlohmann::json response;
         response["success"] = true;
@@ -817,6 +1699,18 @@ void HttpServer::handle_stop_scan(const httplib::Request& req, httplib::Response
 }
 
 void HttpServer::stop() {
+    if (transfer_engine) {
+        transfer_engine->stop();
+    }
+    if (readahead) {
+        readahead->stop();
+    }
+    if (prewarm) {
+        prewarm->stop();
+    }
+    if (scan_scheduler) {
+        scan_scheduler->stop();
+    }
     server.stop();
     std::cout << "HTTP server stopped." << std::endl;
 }
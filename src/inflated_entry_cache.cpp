@@ -0,0 +1,212 @@
+/**
+ * @file inflated_entry_cache.cpp
+ * @brief Implementation of InflatedEntryCache
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "inflated_entry_cache.h"
+#include "book_manager.h"
+#include <openssl/sha.h>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr size_t FINGERPRINT_CHUNK = 64 * 1024;
+constexpr size_t FINGERPRINT_SLACK = 256;   // Memoized paths allowed beyond one per cached entry
+
+} // namespace
+
+InflatedEntryCache::InflatedEntryCache(size_t budget_bytes) : budget(budget_bytes) {
+}
+
+std::string InflatedEntryCache::fingerprint(const std::string& archive_path) {
+    struct stat st;
+    if (stat(archive_path.c_str(), &st) != 0) {
+        throw std::runtime_error("Cannot stat archive: " + archive_path);
+    }
+    uint64_t identity[4] = {
+        static_cast<uint64_t>(st.st_dev),
+        static_cast<uint64_t>(st.st_ino),
+        static_cast<uint64_t>(st.st_size),
+        static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ULL + static_cast<uint64_t>(st.st_mtim.tv_nsec),
+    };
+    uint64_t size = identity[2];
+    int64_t mtime_ns = static_cast<int64_t>(identity[3]);
+    
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = fingerprints.find(archive_path);
+        if (it != fingerprints.end()) {
+            const Fingerprint& memo = it->second;
+            if (memo.device == identity[0] && memo.inode == identity[1] && memo.size == size &&
+                memo.mtime_ns == mtime_ns) {
+                fingerprint_lru.splice(fingerprint_lru.begin(), fingerprint_lru, memo.lru_position);
+                return memo.hash;
+            }
+        }
+    }
+    
+    int fd = open(archive_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open archive: " + archive_path);
+    }
+    
+    // Hash identity + head + tail: the ZIP central directory sits at the tail, so
+    // any change to the entry list or entry sizes changes the fingerprint, and
+    // the inode and mtime catch a same-size rewrite in the middle
+    std::string head(std::min<uint64_t>(size, FINGERPRINT_CHUNK), '\0');
+    std::string tail(size > FINGERPRINT_CHUNK ? std::min<uint64_t>(size - FINGERPRINT_CHUNK, FINGERPRINT_CHUNK) : 0, '\0');
+    ssize_t head_read = pread(fd, head.data(), head.size(), 0);
+    ssize_t tail_read = tail.empty() ? 0 : pread(fd, tail.data(), tail.size(), static_cast<off_t>(size - tail.size()));
+    close(fd);
+    if (head_read < 0 || tail_read < 0) {
+        throw std::runtime_error("Cannot read archive: " + archive_path);
+    }
+    
+    std::string material(reinterpret_cast<const char*>(identity), sizeof(identity));
+    material.append(head.data(), static_cast<size_t>(head_read));
+    material.append(tail.data(), static_cast<size_t>(tail_read));
+    
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(material.data()), material.size(), digest);
+    
+    std::stringstream hash_hex;
+    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        hash_hex << std::hex << std::setw(2) << std::setfill('0') << (int)digest[i];
+    }
+    
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = fingerprints.find(archive_path);
+    if (it == fingerprints.end()) {
+        fingerprint_lru.push_front(archive_path);
+        it = fingerprints.emplace(archive_path, Fingerprint{}).first;
+    } else {
+        fingerprint_lru.splice(fingerprint_lru.begin(), fingerprint_lru, it->second.lru_position);
+    }
+    it->second = Fingerprint{identity[0], identity[1], size, mtime_ns, hash_hex.str(), fingerprint_lru.begin()};
+    trim_fingerprints();
+    return hash_hex.str();
+}
+
+void InflatedEntryCache::trim_fingerprints() {
+    // Dropping a memo only costs a recomputation; cached entries stay valid
+    while (fingerprints.size() > entries.size() + FINGERPRINT_SLACK) {
+        fingerprints.erase(fingerprint_lru.back());
+        fingerprint_lru.pop_back();
+    }
+}
+
+InflatedEntryCache::Buffer InflatedEntryCache::get_or_inflate(const std::string& archive_path,
+                                                              const std::string& entry_name) {
+    std::string key = fingerprint(archive_path) + '\n' + entry_name;
+    
+    {
+        std::unique_lock<std::mutex> lock(cache_mutex);
+        while (true) {
+            auto it = entries.find(key);
+            if (it != entries.end()) {
+                hits++;
+                touch(key, it->second);
+                return it->second.data;
+            }
+            // Someone else is inflating this entry; wait for their result
+            if (inflight.count(key) == 0) {
+                break;
+            }
+            inflight_cv.wait(lock);
+        }
+        inflight.insert(key);
+    }
+    
+    misses++;
+    auto start = std::chrono::steady_clock::now();
+    Buffer data;
+    try {
+        data = std::make_shared<const std::string>(BookManager::read_archive_entry(archive_path, entry_name));
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            inflight.erase(key);
+        }
+        inflight_cv.notify_all();
+        throw;
+    }
+    uint64_t cost_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        inflight.erase(key);
+        insert(key, data, cost_us);
+    }
+    inflight_cv.notify_all();
+    return data;
+}
+
+bool InflatedEntryCache::contains(const std::string& archive_path, const std::string& entry_name) {
+    std::string key;
+    try {
+        key = fingerprint(archive_path) + '\n' + entry_name;
+    } catch (const std::exception&) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return entries.count(key) > 0;
+}
+
+void InflatedEntryCache::touch(const std::string& key, Entry& entry) {
+    eviction_order.erase({entry.priority, key});
+    entry.priority = clock + static_cast<double>(entry.cost_us + 1) * 1024.0 /
+                     static_cast<double>(entry.data->size() + 1);
+    eviction_order.insert({entry.priority, key});
+}
+
+void InflatedEntryCache::insert(const std::string& key, Buffer data, uint64_t cost_us) {
+    // A single huge entry would flush everything else out
+    if (data->size() > budget / 8 || entries.count(key)) {
+        return;
+    }
+    
+    used_bytes += data->size();
+    Entry& entry = entries[key];
+    entry.data = std::move(data);
+    entry.cost_us = cost_us;
+    entry.priority = 0;
+    eviction_order.insert({0, key});
+    touch(key, entry);
+    
+    while (used_bytes > budget && !eviction_order.empty()) {
+        auto victim = eviction_order.begin();
+        auto it = entries.find(victim->second);
+        clock = victim->first;
+        used_bytes -= it->second.data->size();
+        entries.erase(it);
+        eviction_order.erase(victim);
+        evictions++;
+    }
+    trim_fingerprints();
+}
+
+nlohmann::json InflatedEntryCache::get_stats() {
+    nlohmann::json stats;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        stats["entries"] = entries.size();
+        stats["bytes"] = used_bytes;
+        stats["fingerprints"] = fingerprints.size();
+    }
+    stats["budget_bytes"] = budget;
+    stats["hits"] = hits.load();
+    stats["misses"] = misses.load();
+    stats["evictions"] = evictions.load();
+    return stats;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file invalidation_bus.cpp
+ * @brief Implementation of InvalidationBus
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-18
+ */
+
+#include "invalidation_bus.h"
+#include <libpq-fe.h>
+#include <poll.h>
+#include <iostream>
+#include <random>
+#include <cerrno>
+#include <chrono>
+
+namespace {
+
+constexpr int POLL_TIMEOUT_MS = 500;                      // Also bounds how long shutdown waits
+constexpr auto RECONNECT_DELAY = std::chrono::seconds(2);
+
+std::string trimmed_error(const char* message) {
+    std::string error = message ? message : "";
+    while (!error.empty() && (error.back() == '\n' || error.back() == ' ')) {
+        error.pop_back();
+    }
+    return error;
+}
+
+std::string random_origin() {
+    std::random_device device;
+    std::mt19937_64 generator((static_cast<uint64_t>(device()) << 32) ^ device());
+    static const char HEX[] = "0123456789abcdef";
+    std::string id;
+    uint64_t value = generator();
+    for (int i = 0; i < 16; i++) {
+        id.push_back(HEX[(value >> (i * 4)) & 0x0F]);
+    }
+    return id;
+}
+
+} // namespace
+
+InvalidationBus::InvalidationBus(const std::string& connection_string)
+    : connection_string(connection_string), origin_id(random_origin()) {
+    listener = std::thread(&InvalidationBus::listen_loop, this);
+}
+
+InvalidationBus::~InvalidationBus() {
+    stopping = true;
+    if (listener.joinable()) {
+        listener.join();
+    }
+}
+
+std::string InvalidationBus::payload(const std::string& kind, nlohmann::json fields) const {
+    fields["origin"] = origin_id;
+    fields["kind"] = kind;
+    return fields.dump();
+}
+
+void InvalidationBus::subscribe(Handler handler) {
+    std::lock_guard<std::mutex> lock(handlers_mutex);
+    handlers.push_back(std::move(handler));
+}
+
+nlohmann::json InvalidationBus::get_stats() const {
+    nlohmann::json stats;
+    stats["origin"] = origin_id;
+    stats["connected"] = connected.load();
+    stats["received"] = received.load();
+    stats["own"] = own.load();
+    stats["malformed"] = malformed.load();
+    stats["reconnects"] = reconnects.load();
+    return stats;
+}
+
+void InvalidationBus::listen_loop() {
+    pg_conn* conn = nullptr;
+    bool listened_before = false;
+    std::string last_error;
+
+    while (!stopping) {
+        if (!conn) {
+            std::string error;
+            conn = connect(error);
+            if (!conn) {
+                if (error != last_error) {
+                    std::cerr << "InvalidationBus: " << error << ", retrying" << std::endl;
+                    last_error = error;
+                }
+                for (auto waited = std::chrono::milliseconds(0); !stopping && waited < RECONNECT_DELAY;
+                     waited += std::chrono::milliseconds(POLL_TIMEOUT_MS)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MS));
+                }
+                continue;
+            }
+            connected = true;
+            last_error.clear();
+            if (listened_before) {
+                reconnects.fetch_add(1);
+            }
+            listened_before = true;
+            // Whatever was sent before LISTEN took effect is gone, including
+            // writes made between a subscriber's initial load and the first connect
+            dispatch({{"kind", "resync"}});
+        }
+
+        pollfd socket{PQsocket(conn), POLLIN, 0};
+        int ready = poll(&socket, 1, POLL_TIMEOUT_MS);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "InvalidationBus: poll failed" << std::endl;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        if (PQconsumeInput(conn) != 1) {
+            std::cerr << "InvalidationBus: Connection lost: " << trimmed_error(PQerrorMessage(conn)) << std::endl;
+            PQfinish(conn);
+            conn = nullptr;
+            connected = false;
+            continue;
+        }
+
+        while (PGnotify* notification = PQnotifies(conn)) {
+            std::string text = notification->extra ? notification->extra : "";
+            PQfreemem(notification);
+            received.fetch_add(1);
+
+            nlohmann::json event = nlohmann::json::parse(text, nullptr, false);
+            if (event.is_discarded() || !event.is_object() || !event.contains("kind")) {
+                malformed.fetch_add(1);
+                continue;
+            }
+            if (event.value("origin", "") == origin_id) {
+                own.fetch_add(1);
+                continue;
+            }
+            dispatch(event);
+        }
+    }
+
+    if (conn) {
+        PQfinish(conn);
+    }
+    connected = false;
+}
+
+pg_conn* InvalidationBus::connect(std::string& error) {
+    pg_conn* conn = PQconnectdb(connection_string.c_str());
+    if (PQstatus(conn) != CONNECTION_OK) {
+        error = "Connection failed: " + trimmed_error(PQerrorMessage(conn));
+        PQfinish(conn);
+        return nullptr;
+    }
+
+    PGresult* result = PQexec(conn, (std::string("LISTEN ") + CHANNEL).c_str());
+    bool ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+    PQclear(result);
+    if (!ok) {
+        error = "LISTEN failed: " + trimmed_error(PQerrorMessage(conn));
+        PQfinish(conn);
+        return nullptr;
+    }
+
+    std::cout << "InvalidationBus: Listening on " << CHANNEL << " as " << origin_id << std::endl;
+    return conn;
+}
+
+void InvalidationBus::dispatch(const nlohmann::json& event) {
+    std::vector<Handler> current;
+    {
+        std::lock_guard<std::mutex> lock(handlers_mutex);
+        current = handlers;
+    }
+    for (const auto& handler : current) {
+        try {
+            handler(event);
+        } catch (const std::exception& e) {
+            std::cerr << "InvalidationBus: Handler failed for " << event.value("kind", "") << ": " << e.what() << std::endl;
+        }
+    }
+}
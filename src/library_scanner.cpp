@@ -12,14 +12,30 @@
 #include <filesystem>
 #include <iostream>
 #include <algorithm>
+#include <sys/stat.h>
 
 namespace fs = std::filesystem;
 
-LibraryScanner::LibraryScanner(Database* db, BookManager* bm) 
-    : database(db), book_manager(bm) {
+// "device:inode" of a directory, following symlinks; empty if it can't be stat'ed
+static std::string directory_identity(const std::string& dir) {
+    struct stat st{};
+    if (stat(dir.c_str(), &st) != 0) {
+        return "";
+    }
+    return std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino);
+}
+
+LibraryScanner::LibraryScanner(Database* db, BookManager* bm, ScanLimits scan_limits) 
+    : database(db), book_manager(bm), limits(scan_limits) {
     if (!database || !book_manager) {
         throw std::invalid_argument("LibraryScanner requires valid Database and BookManager instances");
     }
+    limits.concurrency = std::clamp(limits.concurrency, 1, 64);
+    limits.files_per_second = std::max(limits.files_per_second, 0);
+    
+    for (int i = 1; i < limits.concurrency; i++) {
+        file_workers.emplace_back(&LibraryScanner::file_worker_loop, this);
+    }
     std::cout << "LibraryScanner initialized successfully" << std::endl;
 }
 
@@ -28,13 +44,24 @@ LibraryScanner::~LibraryScanner() {
         std::cout << "LibraryScanner destructor: stopping scan..." << std::endl;
         stop_scan();
     }
+    
+    {
+        std::lock_guard<std::mutex> lock(chunk_mutex);
+        workers_stopping = true;
+    }
+    chunk_cv.notify_all();
+    for (auto& worker : file_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
 }
 
 bool LibraryScanner::start_scan(const std::string& books_directory) {
     return start_sync_scan(books_directory, false);  // 기본 스캔은 고아 정리 안함
 }
 
-bool LibraryScanner::start_sync_scan(const std::string& books_directory, bool cleanup_orphaned) {
+bool LibraryScanner::start_sync_scan(const std::string& books_directory, bool cleanup_orphaned, bool restart) {
     if (is_scanning.load()) {
         std::cout << "Scan already in progress" << std::endl;
         return false;
@@ -45,18 +72,24 @@ bool LibraryScanner::start_sync_scan(const std::string& books_directory, bool cl
         return false;
     }
     
+    if (restart) {
+        database->clear_scan_checkpoint(books_directory);
+    }
+    
     // Reset counters
     current_progress.store(0);
     total_books.store(0);
     processed_books.store(0);
     orphaned_cleaned.store(0);
     books_found.store(0);
+    resumed.store(false);
     error_log.clear();
     scan_start_time = std::chrono::system_clock::now();
     
     // Start worker thread
     is_scanning.store(true);
     should_stop.store(false);
+    discard_on_stop.store(false);
     
     // 기존 스레드가 joinable하면 먼저 정리
     if (worker_thread.joinable()) {
@@ -70,12 +103,13 @@ bool LibraryScanner::start_sync_scan(const std::string& books_directory, bool cl
     return true;
 }
 
-void LibraryScanner::stop_scan() {
+void LibraryScanner::stop_scan(bool discard_checkpoint) {
     if (!is_scanning.load()) {
         return;
     }
     
     std::cout << "LibraryScanner: requesting scan stop..." << std::endl;
+    discard_on_stop.store(discard_checkpoint);
     should_stop.store(true);
     
     if (worker_thread.joinable()) {
@@ -86,123 +120,415 @@ void LibraryScanner::stop_scan() {
     std::cout << "LibraryScanner: scan stopped" << std::endl;
 }
 
+nlohmann::json LibraryScanner::ScanCursor::to_json() const {
+    nlohmann::json state;
+    state["version"] = VERSION;
+    state["cleanup_orphaned"] = cleanup_orphaned;
+    state["orphans_cleaned"] = orphans_cleaned;
+    state["stack"] = nlohmann::json::array();
+    for (const auto& frame : stack) {
+        state["stack"].push_back({
+            {"dir", frame.dir},
+            {"identity", frame.identity},
+            {"files_done", frame.files_done},
+            {"last_file", frame.last_file},
+            {"last_subdir", frame.last_subdir}
+        });
+    }
+    state["discovered"] = discovered;
+    state["processed"] = processed;
+    state["books_found"] = books_found;
+    state["orphaned_cleaned"] = orphaned_cleaned;
+    state["errors"] = errors;
+    return state;
+}
+
+LibraryScanner::ScanCursor LibraryScanner::ScanCursor::from_json(const nlohmann::json& state) {
+    ScanCursor cursor;
+    cursor.cleanup_orphaned = state.value("cleanup_orphaned", false);
+    cursor.orphans_cleaned = state.value("orphans_cleaned", false);
+    for (const auto& entry : state.value("stack", nlohmann::json::array())) {
+        ScanFrame frame;
+        frame.dir = entry.value("dir", "");
+        frame.identity = entry.value("identity", "");
+        frame.files_done = entry.value("files_done", false);
+        frame.last_file = entry.value("last_file", "");
+        frame.last_subdir = entry.value("last_subdir", "");
+        cursor.stack.push_back(std::move(frame));
+    }
+    cursor.discovered = state.value("discovered", 0);
+    cursor.processed = state.value("processed", 0);
+    cursor.books_found = state.value("books_found", 0);
+    cursor.orphaned_cleaned = state.value("orphaned_cleaned", 0);
+    cursor.errors = state.value("errors", std::vector<std::string>{});
+    return cursor;
+}
+
+bool LibraryScanner::resume_interrupted_scan(const std::string& books_directory) {
+    if (is_scanning.load()) {
+        return false;
+    }
+    
+    nlohmann::json checkpoint = database->load_scan_checkpoint(books_directory);
+    if (checkpoint.is_null()) {
+        return false;
+    }
+    
+    std::cout << "LibraryScanner: found interrupted scan checkpoint for " << books_directory << std::endl;
+    return start_sync_scan(books_directory, checkpoint.value("cleanup_orphaned", false));
+}
+
+void LibraryScanner::save_checkpoint(const std::string& books_directory, ScanCursor& cursor) {
+    cursor.processed = processed_books.load();
+    cursor.books_found = books_found.load();
+    cursor.orphaned_cleaned = orphaned_cleaned.load();
+    {
+        std::lock_guard<std::mutex> lock(progress_mutex);
+        // Keep the checkpoint small; the newest errors are the useful ones
+        size_t first = error_log.size() > MAX_CHECKPOINT_ERRORS ? error_log.size() - MAX_CHECKPOINT_ERRORS : 0;
+        cursor.errors.assign(error_log.begin() + static_cast<long>(first), error_log.end());
+    }
+    
+    if (!database->save_scan_checkpoint(books_directory, cursor.to_json())) {
+        std::cout << "LibraryScanner: failed to save scan checkpoint" << std::endl;
+    }
+    last_checkpoint_time = std::chrono::steady_clock::now();
+    files_since_checkpoint = 0;
+}
+
 void LibraryScanner::scan_worker(const std::string& books_directory, bool cleanup_orphaned) {
     try {
         std::cout << "LibraryScanner worker: starting scan..." << std::endl;
         
+        // Resume from the last checkpoint of this directory, or start a fresh walk
+        ScanCursor cursor;
+        nlohmann::json checkpoint = database->load_scan_checkpoint(books_directory);
+        if (!checkpoint.is_null() && checkpoint.value("version", 0) != ScanCursor::VERSION) {
+            std::cout << "LibraryScanner: ignoring checkpoint from an older version, starting over" << std::endl;
+            checkpoint = nullptr;
+        }
+        if (!checkpoint.is_null()) {
+            cursor = ScanCursor::from_json(checkpoint);
+            cursor.cleanup_orphaned = cursor.cleanup_orphaned || cleanup_orphaned;
+            
+            total_books.store(cursor.discovered);
+            processed_books.store(cursor.processed);
+            books_found.store(cursor.books_found);
+            orphaned_cleaned.store(cursor.orphaned_cleaned);
+            {
+                std::lock_guard<std::mutex> lock(progress_mutex);
+                error_log = cursor.errors;
+            }
+            resumed.store(true);
+            
+            std::cout << "LibraryScanner: resuming scan after " << cursor.processed << " processed files ("
+                      << cursor.stack.size() << " directories deep)" << std::endl;
+        } else {
+            cursor.cleanup_orphaned = cleanup_orphaned;
+            ScanFrame root;
+            root.dir = books_directory;
+            root.identity = directory_identity(books_directory);
+            cursor.stack.push_back(std::move(root));
+        }
+        bool fresh_walk = checkpoint.is_null();
+        save_checkpoint(books_directory, cursor);
+        
         // Step 1: Cleanup orphaned records if requested
-        if (cleanup_orphaned) {
-            std::lock_guard<std::mutex> lock(progress_mutex);
-            current_book_name = "Cleaning orphaned records...";
+        if (cursor.cleanup_orphaned && !cursor.orphans_cleaned) {
+            {
+                std::lock_guard<std::mutex> lock(progress_mutex);
+                current_book_name = "Cleaning orphaned records...";
+            }
             
-            int cleaned = database->cleanup_orphaned_books();
+            // Only this root's books: another root may be an unmounted share right now
+            int cleaned = database->cleanup_orphaned_books(books_directory);
             orphaned_cleaned.store(cleaned);
+            cursor.orphans_cleaned = true;
+            save_checkpoint(books_directory, cursor);
             
             std::cout << "LibraryScanner: cleaned " << cleaned << " orphaned records" << std::endl;
+            if (cleaned > 0 && on_books_removed) {
+                on_books_removed();
+            }
         }
         
-        // Step 2: Scan for new books
-        std::vector<std::string> book_files;
+        // Load the paths already in the database once, instead of one
+        // lookup per file. Nothing is added to the set during the scan:
+        // every file is visited once, and reads from the chunk workers
+        // need no lock.
+        known_paths_loaded = database->get_known_book_paths(books_directory, known_paths);
+        if (known_paths_loaded) {
+            std::cout << "LibraryScanner: " << known_paths.size() << " known books under " << books_directory << std::endl;
+        }
         
-        // Find all supported book files (including symlinks)
-        for (const auto& entry : fs::recursive_directory_iterator(books_directory, 
-                                                                  fs::directory_options::follow_directory_symlink)) {
-            if (should_stop.load()) {
-                std::cout << "LibraryScanner: scan interrupted by user" << std::endl;
-                return;
+        // Step 2: Walk the tree depth first: a directory's files, then each
+        // subdirectory in sorted order. Listings are kept in memory alongside
+        // the cursor's stack so a directory is read once per run, however
+        // many subdirectories it has.
+        struct DirListing {
+            std::vector<std::string> book_files;
+            std::vector<std::string> subdirectories;
+        };
+        auto list_directory = [this](const std::string& dir) {
+            DirListing listing;
+            std::error_code ec;
+            for (fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end;
+                 !ec && it != end; it.increment(ec)) {
+                // is_directory/is_regular_file follow symlinks
+                if (it->is_directory(ec)) {
+                    listing.subdirectories.push_back(it->path().string());
+                } else if (it->is_regular_file(ec)) {
+                    std::string extension = it->path().extension().string();
+                    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+                    
+                    if (extension == ".epub" || extension == ".pdf" || extension == ".cbz") {
+                        listing.book_files.push_back(it->path().string());
+                    }
+                }
+            }
+            if (ec) {
+                std::string error_msg = "Error reading directory " + dir + ": " + ec.message();
+                std::cout << "LibraryScanner: " << error_msg << std::endl;
+                std::lock_guard<std::mutex> lock(progress_mutex);
+                error_log.push_back(error_msg);
             }
             
-            if (entry.is_regular_file() || (entry.is_symlink() && fs::is_regular_file(entry.symlink_status()))) {
-                std::string extension = entry.path().extension().string();
-                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-                
-                if (extension == ".epub" || extension == ".pdf" || extension == ".cbz") {
-                    book_files.push_back(entry.path().string());
+            // Sorted so that last_file and last_subdir mark the same position after a restart
+            std::sort(listing.book_files.begin(), listing.book_files.end());
+            std::sort(listing.subdirectories.begin(), listing.subdirectories.end());
+            return listing;
+        };
+        
+        // Directories are followed through symlinks. The visited set is not
+        // checkpointed: seeded with the stack, it still catches any link back
+        // into an ancestor after a restart, and within a run it also skips a
+        // directory reached twice through different links.
+        std::unordered_set<std::string> visited_dirs;
+        std::vector<DirListing> listings;
+        for (const auto& frame : cursor.stack) {
+            listings.push_back(list_directory(frame.dir));
+            visited_dirs.insert(frame.identity);
+        }
+        if (fresh_walk) {
+            cursor.discovered += static_cast<int>(listings.back().book_files.size());
+            total_books.store(cursor.discovered);
+        }
+        
+        while (!cursor.stack.empty()) {
+            ScanFrame& frame = cursor.stack.back();
+            const DirListing& listing = listings.back();
+            
+            if (!frame.files_done) {
+                if (!process_directory(books_directory, listing.book_files, cursor)) {
+                    if (discard_on_stop.load()) {
+                        database->clear_scan_checkpoint(books_directory);
+                        std::cout << "LibraryScanner: scan interrupted by user, checkpoint discarded" << std::endl;
+                    } else {
+                        save_checkpoint(books_directory, cursor);
+                        std::cout << "LibraryScanner: scan interrupted by user, checkpoint saved" << std::endl;
+                    }
+                    release_known_paths();
+                    is_scanning.store(false);
+                    return;
                 }
+                frame.files_done = true;
+            }
+            
+            auto next = frame.last_subdir.empty()
+                ? listing.subdirectories.begin()
+                : std::upper_bound(listing.subdirectories.begin(), listing.subdirectories.end(), frame.last_subdir);
+            if (next == listing.subdirectories.end()) {
+                cursor.stack.pop_back();
+                listings.pop_back();
+                continue;
+            }
+            frame.last_subdir = *next;
+            
+            ScanFrame child;
+            child.dir = *next;
+            child.identity = directory_identity(child.dir);
+            if (!child.identity.empty() && !visited_dirs.insert(child.identity).second) {
+                std::cout << "LibraryScanner: skipping already scanned directory " << child.dir << std::endl;
+                continue;
             }
+            
+            DirListing child_listing = list_directory(child.dir);
+            cursor.discovered += static_cast<int>(child_listing.book_files.size());
+            total_books.store(cursor.discovered);
+            cursor.stack.push_back(std::move(child));
+            listings.push_back(std::move(child_listing));
         }
         
-        total_books.store(static_cast<int>(book_files.size()));
+        database->clear_scan_checkpoint(books_directory);
+        
+        auto end_time = std::chrono::system_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - scan_start_time);
         
-        std::cout << "LibraryScanner: found " << book_files.size() << " book files to process" << std::endl;
+        std::cout << "LibraryScanner: scan completed in " << duration.count() << " seconds" << std::endl;
+        std::cout << "LibraryScanner: processed " << processed_books.load() << " books, cleaned " 
+                  << orphaned_cleaned.load() << " orphaned records" << std::endl;
         
-        // Step 3: Process each book file
-        int processed = 0;
-        for (const std::string& book_path : book_files) {
-            if (should_stop.load()) {
-                std::cout << "LibraryScanner: scan interrupted by user" << std::endl;
-                return;
+    } catch (const std::exception& e) {
+        std::cout << "LibraryScanner worker error: " << e.what() << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(progress_mutex);
+            error_log.push_back("Scanner error: " + std::string(e.what()));
+        }
+        // Resuming would most likely hit the same failure again; the next scan starts over
+        database->clear_scan_checkpoint(books_directory);
+    }
+    
+    release_known_paths();
+    is_scanning.store(false);
+}
+
+bool LibraryScanner::process_directory(const std::string& books_directory,
+                                       const std::vector<std::string>& book_files, ScanCursor& cursor) {
+    size_t chunk_size = static_cast<size_t>(limits.concurrency);
+    
+    size_t first_file = 0;
+    std::string& last_file = cursor.stack.back().last_file;
+    if (!last_file.empty()) {
+        first_file = static_cast<size_t>(std::upper_bound(book_files.begin(), book_files.end(), last_file) -
+                                         book_files.begin());
+    }
+    
+    // Files of a chunk are processed in parallel; the cursor only moves
+    // past a chunk once all of it is done, so a checkpoint never skips a file.
+    for (size_t chunk_start = first_file; chunk_start < book_files.size(); chunk_start += chunk_size) {
+        if (should_stop.load()) {
+            return false;
+        }
+        
+        size_t chunk_end = std::min(book_files.size(), chunk_start + chunk_size);
+        auto chunk_started = std::chrono::steady_clock::now();
+        
+        run_chunk(book_files, chunk_start, chunk_end);
+        
+        int chunk_count = static_cast<int>(chunk_end - chunk_start);
+        last_file = book_files[chunk_end - 1];
+        processed_books.fetch_add(chunk_count);
+        
+        // Persist progress periodically so a restart loses at most a few seconds of work
+        files_since_checkpoint += chunk_count;
+        if (files_since_checkpoint >= CHECKPOINT_EVERY_FILES ||
+            std::chrono::steady_clock::now() - last_checkpoint_time >= CHECKPOINT_INTERVAL) {
+            save_checkpoint(books_directory, cursor);
+        }
+        
+        // Throttle to the root's file rate so a scan doesn't saturate its disk or mount
+        if (limits.files_per_second > 0) {
+            auto budget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(chunk_count) / limits.files_per_second));
+            auto elapsed = std::chrono::steady_clock::now() - chunk_started;
+            if (elapsed < budget) {
+                std::this_thread::sleep_for(budget - elapsed);
             }
+        }
+    }
+    
+    return true;
+}
+
+void LibraryScanner::process_book_file(const std::string& book_path) {
+    try {
+        // Update progress
+        update_progress(processed_books.load() + 1, total_books.load(), 
+                      fs::path(book_path).filename().string());
+        
+        // Check if book already exists in database
+        bool known = known_paths_loaded ? known_paths.count(book_path) > 0
+                                        : database->get_book_id(book_path) != -1;
+        if (!known) {
+            // New book found - add it to database
+            std::cout << "LibraryScanner: found new book, adding to database: " << book_path << std::endl;
             
             try {
-                // Update progress
-                update_progress(processed + 1, static_cast<int>(book_files.size()), 
-                              fs::path(book_path).filename().string());
+                // Extract basic metadata using BookManager
+                std::string file_type = book_manager->get_file_type(book_path);
+                auto metadata = book_manager->extract_metadata(book_path, file_type);
                 
-                // Check if book already exists in database
-                long existing_book_id = database->get_book_id(book_path);
-                if (existing_book_id == -1) {
-                    // New book found - add it to database
-                    std::cout << "LibraryScanner: found new book, adding to database: " << book_path << std::endl;
-                    
-                    try {
-                        // Extract basic metadata using BookManager
-                        std::string file_type = book_manager->get_file_type(book_path);
-                        auto metadata = book_manager->extract_metadata(book_path, file_type);
-                        
-                        // Get file info
-                        auto file_size = std::filesystem::file_size(book_path);
-                        std::string title = metadata.value("title", std::filesystem::path(book_path).stem().string());
-                        std::string author = metadata.value("author", "Unknown Author");
-                        
-                        // Add to database
-                        long book_id = database->add_book(book_path, title, author, file_type, file_size);
-                        if (book_id > 0) {
-                            books_found.fetch_add(1);
-                            std::cout << "LibraryScanner: successfully added new book (ID: " << book_id << "): " << book_path << std::endl;
-                        } else {
-                            std::cout << "LibraryScanner: failed to add book to database: " << book_path << std::endl;
-                        }
-                    } catch (const std::exception& e) {
-                        std::string error_msg = "Error adding book " + book_path + ": " + e.what();
-                        std::cout << "LibraryScanner: " << error_msg << std::endl;
-                        std::lock_guard<std::mutex> error_lock(progress_mutex);
-                        error_log.push_back(error_msg);
+                // Get file info
+                auto file_size = std::filesystem::file_size(book_path);
+                std::string title = metadata.value("title", std::filesystem::path(book_path).stem().string());
+                std::string author = metadata.value("author", "Unknown Author");
+                
+                // Add to database
+                long book_id = database->add_book(title, author, book_path, file_type, file_size);
+                if (book_id > 0) {
+                    books_found.fetch_add(1);
+                    if (on_book_added) {
+                        on_book_added(book_id);
                     }
+                    std::cout << "LibraryScanner: successfully added new book (ID: " << book_id << "): " << book_path << std::endl;
                 } else {
-                    // Book already exists - this is expected
-                    std::cout << "LibraryScanner: verified existing book: " << book_path << std::endl;
+                    std::cout << "LibraryScanner: failed to add book to database: " << book_path << std::endl;
                 }
-                
-                processed++;
-                processed_books.store(processed);
-                
             } catch (const std::exception& e) {
-                std::string error_msg = "Error processing " + book_path + ": " + e.what();
+                std::string error_msg = "Error adding book " + book_path + ": " + e.what();
                 std::cout << "LibraryScanner: " << error_msg << std::endl;
-                
-                std::lock_guard<std::mutex> lock(progress_mutex);
+                std::lock_guard<std::mutex> error_lock(progress_mutex);
                 error_log.push_back(error_msg);
             }
-            
-            // Small delay to prevent overwhelming the system
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        } else {
+            // Book already exists - this is expected
+            std::cout << "LibraryScanner: verified existing book: " << book_path << std::endl;
         }
         
-        auto end_time = std::chrono::system_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - scan_start_time);
-        
-        std::cout << "LibraryScanner: scan completed in " << duration.count() << " seconds" << std::endl;
-        std::cout << "LibraryScanner: processed " << processed << " books, cleaned " 
-                  << orphaned_cleaned.load() << " orphaned records" << std::endl;
-        
     } catch (const std::exception& e) {
-        std::cout << "LibraryScanner worker error: " << e.what() << std::endl;
+        std::string error_msg = "Error processing " + book_path + ": " + e.what();
+        std::cout << "LibraryScanner: " << error_msg << std::endl;
+        
         std::lock_guard<std::mutex> lock(progress_mutex);
-        error_log.push_back("Scanner error: " + std::string(e.what()));
+        error_log.push_back(error_msg);
+    }
+}
+
+void LibraryScanner::run_chunk(const std::vector<std::string>& book_files, size_t begin, size_t end) {
+    {
+        std::lock_guard<std::mutex> lock(chunk_mutex);
+        chunk_files = &book_files;
+        chunk_next = begin;
+        chunk_limit = end;
     }
+    chunk_cv.notify_all();
     
-    is_scanning.store(false);
+    // The scan thread claims files like any worker
+    std::unique_lock<std::mutex> lock(chunk_mutex);
+    while (chunk_next < chunk_limit) {
+        size_t index = chunk_next++;
+        lock.unlock();
+        process_book_file(book_files[index]);
+        lock.lock();
+    }
+    chunk_done_cv.wait(lock, [this] { return chunk_active == 0; });
+    chunk_files = nullptr;
+}
+
+void LibraryScanner::file_worker_loop() {
+    std::unique_lock<std::mutex> lock(chunk_mutex);
+    while (true) {
+        chunk_cv.wait(lock, [this] { return workers_stopping || (chunk_files && chunk_next < chunk_limit); });
+        if (workers_stopping) {
+            return;
+        }
+        
+        const std::vector<std::string>& book_files = *chunk_files;
+        size_t index = chunk_next++;
+        chunk_active++;
+        lock.unlock();
+        process_book_file(book_files[index]);
+        lock.lock();
+        
+        if (--chunk_active == 0) {
+            chunk_done_cv.notify_one();
+        }
+    }
+}
+
+void LibraryScanner::release_known_paths() {
+    std::unordered_set<std::string>().swap(known_paths);
+    known_paths_loaded = false;
 }
 
 void LibraryScanner::update_progress(int current, int total, const std::string& book_name) {
@@ -226,6 +552,7 @@ ScanStatus LibraryScanner::get_status() const {
     status.total_books = total_books.load();
     status.orphaned_cleaned = orphaned_cleaned.load();
     status.books_found = books_found.load();
+    status.resumed = resumed.load();
     status.current_book = current_book_name;
     status.errors = error_log;
     status.start_time = scan_start_time;
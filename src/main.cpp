@@ -40,7 +40,15 @@ void show_usage(const char* program_name) {
     std::cout << "  --db-name NAME       Database name (default: mylibrary_db)" << std::endl;
     std::cout << "  --db-user USER       Database user (default: mylibrary_user)" << std::endl;
     std::cout << "  --db-password PASS   Database password (default: your_password_here)" << std::endl;
+    std::cout << "  --db-replica SPEC    Standby for read queries, repeatable: HOST[:PORT]" << std::endl;
+    std::cout << "                       (same name, user and password) or a libpq connection string" << std::endl;
     std::cout << "  --books-dir DIR      Books storage directory (default: ./books)" << std::endl;
+    std::cout << "  --stream-port PORT   File streaming port, 0 to disable (default: 8081)" << std::endl;
+    std::cout << "  --io-backend NAME    File read backend: auto, io_uring, pread (default: auto)" << std::endl;
+    std::cout << "  --web-dir DIR        Built web frontend to serve (default: ./web)" << std::endl;
+    std::cout << "  --library-root SPEC  Extra directory to scan, repeatable:" << std::endl;
+    std::cout << "                       PATH[:CONCURRENCY[:FILES_PER_SEC[:INTERVAL_MIN]]]" << std::endl;
+    std::cout << "                       (defaults 1, 100, 0 = scan on demand only)" << std::endl;
     std::cout << "  --help               Show this help message" << std::endl;
 }
 
@@ -58,7 +66,12 @@ struct ServerConfig {
     std::string db_name = "mylibrary_db";
     std::string db_user = "mylibrary_user";
     std::string db_password = "your_password_here";
+    std::vector<std::string> db_replicas;
     std::string books_dir = "./books";
+    int stream_port = 8081;
+    std::string io_backend = "auto";
+    std::string web_dir = "./web";
+    std::vector<LibraryRoot> library_roots;
 };
 
 bool parse_arguments(int argc, char* argv[], ServerConfig& config) {
@@ -80,8 +93,23 @@ bool parse_arguments(int argc, char* argv[], ServerConfig& config) {
             config.db_user = argv[++i];
         } else if (arg == "--db-password" && i + 1 < argc) {
             config.db_password = argv[++i];
+        } else if (arg == "--db-replica" && i + 1 < argc) {
+            config.db_replicas.push_back(argv[++i]);
         } else if (arg == "--books-dir" && i + 1 < argc) {
             config.books_dir = argv[++i];
+        } else if (arg == "--stream-port" && i + 1 < argc) {
+            config.stream_port = std::stoi(argv[++i]);
+        } else if (arg == "--io-backend" && i + 1 < argc) {
+            config.io_backend = argv[++i];
+        } else if (arg == "--web-dir" && i + 1 < argc) {
+            config.web_dir = argv[++i];
+        } else if (arg == "--library-root" && i + 1 < argc) {
+            try {
+                config.library_roots.push_back(LibraryRoot::parse(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                return false;
+            }
         } else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             show_usage(argv[0]);
@@ -121,17 +149,50 @@ int main(int argc, char* argv[]) {
             " host=" + config.db_host + 
             " port=" + std::to_string(config.db_port);
         
+        // Standbys given as HOST[:PORT] share the primary's name and credentials
+        std::vector<std::string> db_replica_connection_strings;
+        for (const auto& replica : config.db_replicas) {
+            if (replica.find('=') != std::string::npos || replica.find("://") != std::string::npos) {
+                db_replica_connection_strings.push_back(replica);
+                continue;
+            }
+            size_t colon = replica.rfind(':');
+            if (colon != std::string::npos && (colon + 1 == replica.size() ||
+                replica.find_first_not_of("0123456789", colon + 1) != std::string::npos)) {
+                colon = std::string::npos;   // Not a port, e.g. a bare IPv6 address
+            }
+            std::string host = colon == std::string::npos ? replica : replica.substr(0, colon);
+            std::string port = colon == std::string::npos ? std::to_string(config.db_port) : replica.substr(colon + 1);
+            db_replica_connection_strings.push_back(
+                "dbname=" + config.db_name + 
+                " user=" + config.db_user + 
+                " password=" + config.db_password + 
+                " host=" + host + 
+                " port=" + port);
+        }
+        
         std::cout << "Initializing server with configuration:" << std::endl;
         std::cout << "  Server port: " << config.port << std::endl;
         std::cout << "  Database: " << config.db_host << ":" << config.db_port << "/" << config.db_name << std::endl;
+        std::cout << "  Read replicas: " << db_replica_connection_strings.size() << std::endl;
         std::cout << "  Books directory: " << config.books_dir << std::endl;
+        std::cout << "  Streaming port: " << config.stream_port << std::endl;
+        std::cout << "  Web directory: " << config.web_dir << std::endl;
+        for (const auto& root : config.library_roots) {
+            std::cout << "  Library root: " << root.path << std::endl;
+        }
         std::cout << std::endl;
         
         // Create and start the HTTP server
         global_server = std::make_unique<HttpServer>(
             db_connection_string, 
             config.books_dir, 
-            config.port
+            config.port,
+            config.stream_port,
+            config.io_backend,
+            config.library_roots,
+            config.web_dir,
+            db_replica_connection_strings
         );
         
         std::cout << "Starting server..." << std::endl;
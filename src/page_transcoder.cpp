@@ -0,0 +1,530 @@
+/**
+ * @file page_transcoder.cpp
+ * @brief Implementation of PageTranscoder
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "page_transcoder.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csetjmp>
+#include <jpeglib.h>
+#include <png.h>
+#ifdef MYLIBRARY_HAVE_LIBWEBP
+#include <webp/encode.h>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int WIDTH_BUCKETS[] = {320, 480, 640, 800, 1080, 1280, 1600, 2048};
+constexpr int THUMBNAIL_WIDTH_BUCKETS[] = {160, 320, 640};
+constexpr int JPEG_QUALITY = 82;
+constexpr float WEBP_QUALITY = 78.0f;
+constexpr int WEIGHT_BITS = 14;
+// Largest source image decoded: 40 megapixels, 120 MB as RGB. Header
+// dimensions are attacker-controlled, so they are checked before allocating
+constexpr uint64_t MAX_SOURCE_PIXELS = 40ull * 1000 * 1000;
+
+/**
+ * @brief Source span and fixed-point weights for one output row/column
+ */
+struct Contribution {
+    int first = 0;
+    std::vector<int16_t> weights;   ///< Q14, sum == 1 << WEIGHT_BITS
+};
+
+// Triangle filter widened by the scale factor, so downscaling averages every
+// source pixel instead of skipping them (no aliasing on screentone)
+std::vector<Contribution> compute_contributions(int source_size, int target_size) {
+    std::vector<Contribution> contributions(target_size);
+    double scale = static_cast<double>(source_size) / target_size;
+    double support = std::max(scale, 1.0);
+
+    std::vector<double> raw;
+    for (int i = 0; i < target_size; i++) {
+        double center = (i + 0.5) * scale;
+        int first = std::max(0, static_cast<int>(std::floor(center - support)));
+        int last = std::min(source_size - 1, static_cast<int>(std::ceil(center + support)));
+
+        raw.clear();
+        double total = 0;
+        for (int x = first; x <= last; x++) {
+            double w = std::max(0.0, 1.0 - std::abs((x + 0.5 - center) / support));
+            raw.push_back(w);
+            total += w;
+        }
+
+        Contribution& c = contributions[i];
+        c.first = first;
+        int sum = 0;
+        size_t largest = 0;
+        for (size_t k = 0; k < raw.size(); k++) {
+            int16_t w = static_cast<int16_t>(std::lround(raw[k] / total * (1 << WEIGHT_BITS)));
+            c.weights.push_back(w);
+            sum += w;
+            if (w > c.weights[largest]) largest = k;
+        }
+        // Put the rounding error on the largest tap so flat areas stay flat
+        c.weights[largest] = static_cast<int16_t>(c.weights[largest] + ((1 << WEIGHT_BITS) - sum));
+    }
+    return contributions;
+}
+
+// One output row = weighted sum of source rows, over every byte of the row
+void vertical_pass(const uint8_t* source, size_t row_bytes, const Contribution& c, uint8_t* out) {
+    size_t x = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi32(1 << (WEIGHT_BITS - 1));
+    for (; x + 8 <= row_bytes; x += 8) {
+        __m128i acc_lo = rounding;
+        __m128i acc_hi = rounding;
+        for (size_t k = 0; k < c.weights.size(); k++) {
+            const uint8_t* row = source + (c.first + k) * row_bytes;
+            __m128i weight = _mm_set1_epi32(c.weights[k] & 0xFFFF);
+            __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + x)), zero);
+            // (px, 0) pairs times (w, 0) pairs: madd yields px * w per 32-bit lane
+            acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(px, zero), weight));
+            acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(px, zero), weight));
+        }
+        acc_lo = _mm_srai_epi32(acc_lo, WEIGHT_BITS);
+        acc_hi = _mm_srai_epi32(acc_hi, WEIGHT_BITS);
+        __m128i packed = _mm_packs_epi32(acc_lo, acc_hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16(packed, packed));
+    }
+#endif
+    for (; x < row_bytes; x++) {
+        int acc = 1 << (WEIGHT_BITS - 1);
+        for (size_t k = 0; k < c.weights.size(); k++) {
+            acc += source[(c.first + k) * row_bytes + x] * c.weights[k];
+        }
+        out[x] = static_cast<uint8_t>(std::clamp(acc >> WEIGHT_BITS, 0, 255));
+    }
+}
+
+void horizontal_pass(const uint8_t* row, const std::vector<Contribution>& contributions, uint8_t* out) {
+    for (size_t i = 0; i < contributions.size(); i++) {
+        const Contribution& c = contributions[i];
+        int r = 1 << (WEIGHT_BITS - 1), g = r, b = r;
+        const uint8_t* px = row + c.first * 3;
+        for (size_t k = 0; k < c.weights.size(); k++, px += 3) {
+            r += px[0] * c.weights[k];
+            g += px[1] * c.weights[k];
+            b += px[2] * c.weights[k];
+        }
+        out[i * 3] = static_cast<uint8_t>(std::clamp(r >> WEIGHT_BITS, 0, 255));
+        out[i * 3 + 1] = static_cast<uint8_t>(std::clamp(g >> WEIGHT_BITS, 0, 255));
+        out[i * 3 + 2] = static_cast<uint8_t>(std::clamp(b >> WEIGHT_BITS, 0, 255));
+    }
+}
+
+struct JpegErrorManager {
+    jpeg_error_mgr base;
+    jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void jpeg_error_exit(j_common_ptr cinfo) {
+    JpegErrorManager* err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+    (*cinfo->err->format_message)(cinfo, err->message);
+    longjmp(err->jump, 1);
+}
+
+} // namespace
+
+PageTranscoder::PageTranscoder(const std::string& cache_dir, uint64_t max_cache_bytes)
+    : cache_directory(cache_dir), max_bytes(max_cache_bytes) {
+    try {
+        fs::create_directories(cache_directory);
+    } catch (const fs::filesystem_error& e) {
+        throw std::runtime_error("Failed to create transcode cache directory: " + std::string(e.what()));
+    }
+    load_index();
+}
+
+void PageTranscoder::load_index() {
+    // Rebuild recency from modification times, oldest first
+    std::vector<std::pair<fs::file_time_type, std::pair<std::string, uint64_t>>> found;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(cache_directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        std::string path = it->path().string();
+        if (path.find(".tmp") != std::string::npos) {
+            // Left behind by a write that didn't finish
+            fs::remove(path, ec);
+            continue;
+        }
+        found.push_back({it->last_write_time(ec), {path, it->file_size(ec)}});
+    }
+    std::sort(found.begin(), found.end());
+
+    std::lock_guard<std::mutex> lock(index_mutex);
+    for (const auto& [time, file] : found) {
+        recency.push_back(file.first);
+        index[file.first] = {file.second, std::prev(recency.end())};
+        used_bytes += file.second;
+    }
+    trim_locked();
+    std::cout << "PageTranscoder: " << index.size() << " cached files, " << used_bytes / (1024 * 1024)
+              << " MB of " << max_bytes / (1024 * 1024) << " MB" << std::endl;
+}
+
+void PageTranscoder::note_file(const std::string& path, uint64_t size) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    auto it = index.find(path);
+    if (it != index.end()) {
+        used_bytes -= it->second.size;
+        recency.erase(it->second.position);
+        index.erase(it);
+    }
+    recency.push_back(path);
+    index[path] = {size, std::prev(recency.end())};
+    used_bytes += size;
+    trim_locked();
+}
+
+void PageTranscoder::note_hit(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        auto it = index.find(path);
+        if (it != index.end()) {
+            recency.splice(recency.end(), recency, it->second.position);
+            return;
+        }
+    }
+    // Written by another instance sharing the directory
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    if (!ec) {
+        note_file(path, size);
+    }
+}
+
+void PageTranscoder::trim_locked() {
+    // The most recent file stays even if it alone is over the cap: it is about to be served
+    while (used_bytes > max_bytes && recency.size() > 1) {
+        const std::string& victim = recency.front();
+        std::error_code ec;
+        fs::remove(victim, ec);
+        used_bytes -= index[victim].size;
+        index.erase(victim);
+        recency.pop_front();
+    }
+}
+
+void PageTranscoder::remove_book(long book_id) {
+    std::string directory = cache_directory + "/" + std::to_string(book_id);
+    std::string prefix = directory + "/";
+    {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        for (auto it = index.begin(); it != index.end();) {
+            if (it->first.rfind(prefix, 0) == 0) {
+                used_bytes -= it->second.size;
+                recency.erase(it->second.position);
+                it = index.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    std::error_code ec;
+    fs::remove_all(directory, ec);
+}
+
+int PageTranscoder::snap_width(int requested) {
+    for (int bucket : WIDTH_BUCKETS) {
+        if (requested <= bucket) return bucket;
+    }
+    return WIDTH_BUCKETS[std::size(WIDTH_BUCKETS) - 1];
+}
+
+int PageTranscoder::snap_thumbnail_width(int requested) {
+    for (int bucket : THUMBNAIL_WIDTH_BUCKETS) {
+        if (requested <= bucket) return bucket;
+    }
+    return THUMBNAIL_WIDTH_BUCKETS[std::size(THUMBNAIL_WIDTH_BUCKETS) - 1];
+}
+
+std::vector<int> PageTranscoder::thumbnail_widths() {
+    return std::vector<int>(std::begin(THUMBNAIL_WIDTH_BUCKETS), std::end(THUMBNAIL_WIDTH_BUCKETS));
+}
+
+bool PageTranscoder::webp_available() {
+#ifdef MYLIBRARY_HAVE_LIBWEBP
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string PageTranscoder::negotiate_format(const std::string& requested, const std::string& accept) {
+    if (requested == "jpeg" || requested == "jpg") return "jpeg";
+    if (requested == "webp") return webp_available() ? "webp" : "jpeg";
+    return webp_available() && accept.find("image/webp") != std::string::npos ? "webp" : "jpeg";
+}
+
+PageTranscoder::Output PageTranscoder::get_page(long book_id, long page_index, const std::string& archive_path,
+                                                int width, const std::string& format,
+                                                const SourceLoader& load_source) {
+    width = snap_width(width);
+    std::string name = std::to_string(book_id) + "/" + std::to_string(page_index) + "_" + std::to_string(width);
+    return render(name, archive_path, width, format, load_source);
+}
+
+PageTranscoder::Output PageTranscoder::get_thumbnail(long book_id, const std::string& thumbnail_path,
+                                                     int width, const std::string& format,
+                                                     const SourceLoader& load_source) {
+    width = snap_thumbnail_width(width);
+    std::string name = std::to_string(book_id) + "/cover_" + std::to_string(width);
+    return render(name, thumbnail_path, width, format, load_source);
+}
+
+PageTranscoder::Output PageTranscoder::render(const std::string& name, const std::string& source_path,
+                                              int width, const std::string& format,
+                                              const SourceLoader& load_source) {
+    Output output;
+    output.content_type = format == "webp" ? "image/webp" : "image/jpeg";
+    output.file_path = cache_directory + "/" + name + (format == "webp" ? ".webp" : ".jpg");
+
+    auto is_fresh = [&] {
+        std::error_code ec;
+        auto cached_time = fs::last_write_time(output.file_path, ec);
+        if (ec) return false;
+        auto source_time = fs::last_write_time(source_path, ec);
+        return ec || cached_time >= source_time;
+    };
+
+    if (is_fresh()) {
+        note_hit(output.file_path);
+        return output;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(inflight_mutex);
+        inflight_cv.wait(lock, [&] { return inflight.count(output.file_path) == 0; });
+        if (is_fresh()) {
+            note_hit(output.file_path);
+            return output;
+        }
+        inflight.insert(output.file_path);
+    }
+
+    auto finish = [&] {
+        {
+            std::lock_guard<std::mutex> lock(inflight_mutex);
+            inflight.erase(output.file_path);
+        }
+        inflight_cv.notify_all();
+    };
+
+    try {
+        std::shared_ptr<const std::string> source = load_source();
+        Image image = resize(decode(*source, width), width);
+        std::string encoded = format == "webp" ? encode_webp(image, WEBP_QUALITY) : encode_jpeg(image, JPEG_QUALITY);
+
+        // Write to a temporary name and rename so readers never see a partial file
+        fs::create_directories(fs::path(output.file_path).parent_path());
+        std::string temp_path = output.file_path + ".tmp" +
+                                std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file || !file.write(encoded.data(), static_cast<std::streamsize>(encoded.size()))) {
+                throw std::runtime_error("Failed to write " + temp_path);
+            }
+        }
+        fs::rename(temp_path, output.file_path);
+        note_file(output.file_path, encoded.size());
+    } catch (...) {
+        finish();
+        throw;
+    }
+
+    finish();
+    return output;
+}
+
+PageTranscoder::Image PageTranscoder::decode(const std::string& data, int target_width) {
+    if (data.size() >= 3 && static_cast<unsigned char>(data[0]) == 0xFF &&
+        static_cast<unsigned char>(data[1]) == 0xD8) {
+        Image image;
+        decode_jpeg(data, target_width, image);
+        return image;
+    }
+    if (data.size() >= 8 && png_sig_cmp(reinterpret_cast<png_const_bytep>(data.data()), 0, 8) == 0) {
+        return decode_png(data);
+    }
+    throw std::runtime_error("Unsupported page image format for transcoding");
+}
+
+void PageTranscoder::decode_jpeg(const std::string& data, int target_width, Image& image) {
+    // image belongs to the caller: locals changed after setjmp are indeterminate after longjmp
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager err;
+    cinfo.err = jpeg_std_error(&err.base);
+    err.base.error_exit = jpeg_error_exit;
+
+    if (setjmp(err.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        throw std::runtime_error(std::string("JPEG decode failed: ") + err.message);
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char*>(data.data()), static_cast<unsigned long>(data.size()));
+    jpeg_read_header(&cinfo, TRUE);
+    if (static_cast<uint64_t>(cinfo.image_width) * cinfo.image_height > MAX_SOURCE_PIXELS) {
+        std::string size = std::to_string(cinfo.image_width) + "x" + std::to_string(cinfo.image_height);
+        jpeg_destroy_decompress(&cinfo);
+        throw std::runtime_error("JPEG too large to transcode: " + size);
+    }
+    cinfo.out_color_space = JCS_RGB;
+
+    // Let the IDCT do the first 2x/4x/8x of the downscale for free
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = 1;
+    for (unsigned denom : {8u, 4u, 2u}) {
+        if (cinfo.image_width / denom >= static_cast<unsigned>(target_width)) {
+            cinfo.scale_denom = denom;
+            break;
+        }
+    }
+
+    jpeg_start_decompress(&cinfo);
+    image.width = static_cast<int>(cinfo.output_width);
+    image.height = static_cast<int>(cinfo.output_height);
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height * 3);
+
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = image.pixels.data() + static_cast<size_t>(cinfo.output_scanline) * image.width * 3;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+}
+
+PageTranscoder::Image PageTranscoder::decode_png(const std::string& data) {
+    png_image png;
+    std::memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+
+    if (!png_image_begin_read_from_memory(&png, data.data(), data.size())) {
+        throw std::runtime_error(std::string("PNG decode failed: ") + png.message);
+    }
+
+    if (static_cast<uint64_t>(png.width) * png.height > MAX_SOURCE_PIXELS) {
+        std::string size = std::to_string(png.width) + "x" + std::to_string(png.height);
+        png_image_free(&png);
+        throw std::runtime_error("PNG too large to transcode: " + size);
+    }
+
+    png.format = PNG_FORMAT_RGB;
+    Image image;
+    image.width = static_cast<int>(png.width);
+    image.height = static_cast<int>(png.height);
+    image.pixels.resize(PNG_IMAGE_SIZE(png));
+
+    // Transparent areas are composited onto white, like a printed page
+    png_color background = {255, 255, 255};
+    if (!png_image_finish_read(&png, &background, image.pixels.data(), 0, nullptr)) {
+        png_image_free(&png);
+        throw std::runtime_error(std::string("PNG decode failed: ") + png.message);
+    }
+    return image;
+}
+
+PageTranscoder::Image PageTranscoder::resize(const Image& source, int target_width) {
+    if (source.width <= target_width || source.width == 0 || source.height == 0) {
+        return source;
+    }
+
+    int target_height = std::max(1, static_cast<int>(std::lround(
+        static_cast<double>(source.height) * target_width / source.width)));
+
+    // Vertical pass first: it runs over whole source-width rows (vectorized)
+    // and leaves fewer rows for the scalar horizontal pass
+    std::vector<Contribution> rows = compute_contributions(source.height, target_height);
+    std::vector<Contribution> columns = compute_contributions(source.width, target_width);
+
+    size_t source_row_bytes = static_cast<size_t>(source.width) * 3;
+    std::vector<uint8_t> row_buffer(source_row_bytes);
+
+    Image result;
+    result.width = target_width;
+    result.height = target_height;
+    result.pixels.resize(static_cast<size_t>(target_width) * target_height * 3);
+
+    for (int y = 0; y < target_height; y++) {
+        vertical_pass(source.pixels.data(), source_row_bytes, rows[y], row_buffer.data());
+        horizontal_pass(row_buffer.data(), columns, result.pixels.data() + static_cast<size_t>(y) * target_width * 3);
+    }
+    return result;
+}
+
+std::string PageTranscoder::encode_jpeg(const Image& image, int quality) {
+    jpeg_compress_struct cinfo;
+    JpegErrorManager err;
+    cinfo.err = jpeg_std_error(&err.base);
+    err.base.error_exit = jpeg_error_exit;
+
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    if (setjmp(err.jump)) {
+        jpeg_destroy_compress(&cinfo);
+        free(buffer);
+        throw std::runtime_error(std::string("JPEG encode failed: ") + err.message);
+    }
+
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+    cinfo.image_width = static_cast<JDIMENSION>(image.width);
+    cinfo.image_height = static_cast<JDIMENSION>(image.height);
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    jpeg_simple_progression(&cinfo);
+
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(image.pixels.data() + static_cast<size_t>(cinfo.next_scanline) * image.width * 3);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    std::string encoded(reinterpret_cast<const char*>(buffer), size);
+    free(buffer);
+    return encoded;
+}
+
+std::string PageTranscoder::encode_webp(const Image& image, float quality) {
+#ifdef MYLIBRARY_HAVE_LIBWEBP
+    uint8_t* output = nullptr;
+    size_t size = WebPEncodeRGB(image.pixels.data(), image.width, image.height, image.width * 3, quality, &output);
+    if (size == 0) {
+        throw std::runtime_error("WebP encode failed");
+    }
+    std::string encoded(reinterpret_cast<const char*>(output), size);
+    WebPFree(output);
+    return encoded;
+#else
+    (void)image;
+    (void)quality;
+    throw std::runtime_error("WebP support not compiled in");
+#endif
+}
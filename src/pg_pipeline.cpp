@@ -0,0 +1,210 @@
+/**
+ * @file pg_pipeline.cpp
+ * @brief Implementation of PgPipeline
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "pg_pipeline.h"
+#include <libpq-fe.h>
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace {
+
+std::string trimmed_error(const char* message) {
+    std::string error = message ? message : "";
+    while (!error.empty() && (error.back() == '\n' || error.back() == ' ')) {
+        error.pop_back();
+    }
+    return error.empty() ? "unknown error" : error;
+}
+
+PgPipeline::Result to_result(PGresult* res) {
+    PgPipeline::Result result;
+    ExecStatusType status = PQresultStatus(res);
+    if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK) {
+#ifdef LIBPQ_HAS_PIPELINING
+        if (status == PGRES_PIPELINE_ABORTED) {
+            result.error = "skipped after an earlier error in the batch";
+            return result;
+        }
+#endif
+        result.error = trimmed_error(PQresultErrorMessage(res));
+        return result;
+    }
+
+    result.ok = true;
+    int columns = PQnfields(res);
+    int rows = PQntuples(res);
+    result.columns.reserve(columns);
+    for (int c = 0; c < columns; c++) {
+        result.columns.emplace_back(PQfname(res, c));
+    }
+    result.rows.resize(rows);
+    for (int r = 0; r < rows; r++) {
+        result.rows[r].reserve(columns);
+        for (int c = 0; c < columns; c++) {
+            if (PQgetisnull(res, r, c)) {
+                result.rows[r].emplace_back(std::nullopt);
+            } else {
+                result.rows[r].emplace_back(std::string(PQgetvalue(res, r, c), PQgetlength(res, r, c)));
+            }
+        }
+    }
+    result.affected_rows = std::atol(PQcmdTuples(res));
+    return result;
+}
+
+std::vector<const char*> param_values(const PgPipeline::Statement& statement) {
+    std::vector<const char*> values;
+    values.reserve(statement.params.size());
+    for (const auto& param : statement.params) {
+        values.push_back(param ? param->c_str() : nullptr);
+    }
+    return values;
+}
+
+} // namespace
+
+const std::optional<std::string>& PgPipeline::Result::get(size_t row, const std::string& column) const {
+    for (size_t c = 0; c < columns.size(); c++) {
+        if (columns[c] == column) {
+            return rows.at(row).at(c);
+        }
+    }
+    throw std::out_of_range("PgPipeline: no column " + column);
+}
+
+PgPipeline::PgPipeline(const std::string& connection_string) {
+    conn = PQconnectdb(connection_string.c_str());
+    if (PQstatus(conn) != CONNECTION_OK) {
+        std::string error = trimmed_error(PQerrorMessage(conn));
+        PQfinish(conn);
+        conn = nullptr;
+        throw std::runtime_error("PgPipeline: connection failed: " + error);
+    }
+}
+
+PgPipeline::~PgPipeline() {
+    if (conn) {
+        PQfinish(conn);
+    }
+}
+
+bool PgPipeline::pipelined() {
+#ifdef LIBPQ_HAS_PIPELINING
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<PgPipeline::Result> PgPipeline::run(const std::vector<Statement>& statements) {
+    std::vector<Result> results(statements.size());
+    if (statements.empty()) {
+        return results;
+    }
+
+    std::lock_guard<std::mutex> lock(conn_mutex);
+    if (!ensure_connected()) {
+        for (auto& result : results) {
+            result.error = "database connection lost";
+        }
+        return results;
+    }
+
+#ifdef LIBPQ_HAS_PIPELINING
+    run_pipelined(statements, results);
+#else
+    run_sequential(statements, results);
+#endif
+    return results;
+}
+
+bool PgPipeline::ensure_connected() {
+    if (PQstatus(conn) == CONNECTION_OK) {
+        return true;
+    }
+    std::cerr << "PgPipeline: Connection lost, reconnecting" << std::endl;
+    PQreset(conn);
+    return PQstatus(conn) == CONNECTION_OK;
+}
+
+void PgPipeline::run_pipelined(const std::vector<Statement>& statements, std::vector<Result>& results) {
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQenterPipelineMode(conn) != 1) {
+        std::string error = trimmed_error(PQerrorMessage(conn));
+        for (auto& result : results) {
+            result.error = error;
+        }
+        return;
+    }
+
+    size_t sent = 0;
+    for (const auto& statement : statements) {
+        std::vector<const char*> values = param_values(statement);
+        if (PQsendQueryParams(conn, statement.sql.c_str(), static_cast<int>(values.size()), nullptr,
+                              values.data(), nullptr, nullptr, 0) != 1) {
+            results[sent].error = trimmed_error(PQerrorMessage(conn));
+            break;
+        }
+        sent++;
+    }
+    for (size_t i = sent + (sent < statements.size() ? 1 : 0); i < statements.size(); i++) {
+        results[i].error = "not sent";
+    }
+
+    if (PQpipelineSync(conn) != 1) {
+        std::cerr << "PgPipeline: Sync failed: " << trimmed_error(PQerrorMessage(conn)) << std::endl;
+    }
+
+    // Each statement's results end with a NULL; the sync comes last
+    for (size_t i = 0; i < sent; i++) {
+        bool received = false;
+        while (PGresult* res = PQgetResult(conn)) {
+            if (!received) {
+                results[i] = to_result(res);
+                received = true;
+            }
+            PQclear(res);
+        }
+        if (!received) {
+            results[i].error = trimmed_error(PQerrorMessage(conn));
+        }
+    }
+    while (PGresult* res = PQgetResult(conn)) {
+        bool synced = PQresultStatus(res) == PGRES_PIPELINE_SYNC;
+        PQclear(res);
+        if (synced) {
+            break;
+        }
+    }
+
+    if (PQexitPipelineMode(conn) != 1) {
+        std::cerr << "PgPipeline: Leaving pipeline mode failed: " << trimmed_error(PQerrorMessage(conn)) << std::endl;
+    }
+#else
+    run_sequential(statements, results);
+#endif
+}
+
+void PgPipeline::run_sequential(const std::vector<Statement>& statements, std::vector<Result>& results) {
+    PQclear(PQexec(conn, "BEGIN"));
+    bool failed = false;
+    for (size_t i = 0; i < statements.size(); i++) {
+        if (failed) {
+            results[i].error = "skipped after an earlier error in the batch";
+            continue;
+        }
+        std::vector<const char*> values = param_values(statements[i]);
+        PGresult* res = PQexecParams(conn, statements[i].sql.c_str(), static_cast<int>(values.size()), nullptr,
+                                     values.data(), nullptr, nullptr, 0);
+        results[i] = to_result(res);
+        PQclear(res);
+        failed = !results[i].ok;
+    }
+    PQclear(PQexec(conn, failed ? "ROLLBACK" : "COMMIT"));
+}
@@ -0,0 +1,286 @@
+/**
+ * @file prewarm_service.cpp
+ * @brief Implementation of PrewarmService
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "prewarm_service.h"
+#include "database.h"
+#include "book_manager.h"
+#include "file_io.h"
+#include "inflated_entry_cache.h"
+#include "page_transcoder.h"
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+
+namespace {
+
+// Reader widths worth having ready: phone portrait and tablet/desktop
+constexpr int PREWARM_PAGE_WIDTHS[] = {800, 1280};
+
+// From linux/ioprio.h, which is not part of the libc headers
+constexpr int IOPRIO_WHO_PROCESS = 1;
+constexpr int IOPRIO_CLASS_IDLE = 3;
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+
+} // namespace
+
+PrewarmService::PrewarmService(Database* db, BookManager* books, FileIoBackend* io, InflatedEntryCache* entry_cache,
+                               PageTranscoder* transcoder, Budget budget)
+    : database(db), book_manager(books), file_io(io), entry_cache(entry_cache), transcoder(transcoder), budget(budget),
+      last_refill(std::chrono::steady_clock::now()) {
+    if (!database || !book_manager || !file_io || !entry_cache || !transcoder) {
+        throw std::invalid_argument("PrewarmService requires Database, BookManager, FileIoBackend, InflatedEntryCache and PageTranscoder");
+    }
+    this->budget.cpu_duty_cycle = std::clamp(this->budget.cpu_duty_cycle, 0.01, 1.0);
+    this->budget.bytes_per_second = std::max<size_t>(this->budget.bytes_per_second, 1024 * 1024);
+    byte_tokens = static_cast<double>(this->budget.bytes_per_second);
+    worker = std::thread(&PrewarmService::worker_loop, this);
+}
+
+PrewarmService::~PrewarmService() {
+    stop();
+}
+
+void PrewarmService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping.exchange(true)) {
+            return;
+        }
+        queue.clear();
+        queued.clear();
+    }
+    queue_cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PrewarmService::enqueue(long book_id) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping || !queued.insert(book_id).second) {
+            return;
+        }
+        queue.push_back(book_id);
+    }
+    queue_cv.notify_one();
+}
+
+void PrewarmService::note_foreground_activity() {
+    last_foreground_ms.store(now_ms(), std::memory_order_relaxed);
+}
+
+int64_t PrewarmService::now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PrewarmService::lower_thread_priority() {
+    pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+
+    // On Linux, nice values apply per thread
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), 19) != 0) {
+        std::cerr << "PrewarmService: Failed to lower CPU priority" << std::endl;
+    }
+    if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) != 0) {
+        std::cerr << "PrewarmService: Failed to set idle I/O priority" << std::endl;
+    }
+}
+
+bool PrewarmService::sleep_for(std::chrono::steady_clock::duration duration) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    return !queue_cv.wait_for(lock, duration, [this] { return stopping.load(); });
+}
+
+bool PrewarmService::wait_for_quiet() {
+    while (!stopping) {
+        int64_t idle_ms = now_ms() - last_foreground_ms.load(std::memory_order_relaxed);
+        if (idle_ms >= budget.quiet_period.count()) {
+            return true;
+        }
+        if (!sleep_for(std::chrono::milliseconds(budget.quiet_period.count() - idle_ms))) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool PrewarmService::charge(std::chrono::steady_clock::duration elapsed, size_t bytes_read) {
+    // CPU: after working for t, rest for t * (1 - duty) / duty
+    auto rest = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        elapsed * ((1.0 - budget.cpu_duty_cycle) / budget.cpu_duty_cycle));
+
+    // I/O: token bucket refilled at bytes_per_second, one second of burst
+    auto now = std::chrono::steady_clock::now();
+    double rate = static_cast<double>(budget.bytes_per_second);
+    byte_tokens = std::min(rate, byte_tokens + std::chrono::duration<double>(now - last_refill).count() * rate);
+    last_refill = now;
+    byte_tokens -= static_cast<double>(bytes_read);
+    if (byte_tokens < 0) {
+        rest = std::max(rest, std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(-byte_tokens / rate)));
+    }
+
+    return rest.count() <= 0 || sleep_for(rest);
+}
+
+void PrewarmService::worker_loop() {
+    lower_thread_priority();
+
+    while (true) {
+        long book_id;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            book_id = queue.front();
+            queue.pop_front();
+            queued.erase(book_id);
+        }
+
+        warm_book(book_id);
+    }
+}
+
+void PrewarmService::warm_book(long book_id) {
+    nlohmann::json book_info = database->get_book_by_id(book_id);
+    if (book_info.is_null()) {
+        return;
+    }
+
+    std::string file_type = book_info["file_type"];
+    std::string file_path = book_info["file_path"];
+    std::string thumbnail_path = book_info.value("thumbnail_path", "");
+    std::string format = PageTranscoder::negotiate_format("auto", "image/webp");
+
+    // Each step is one unit of work: wait for a quiet moment, run it, pay for it
+    auto step = [&](const std::string& what, const std::function<size_t()>& work) {
+        if (!wait_for_quiet()) {
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        size_t bytes_read = 0;
+        try {
+            bytes_read = work();
+            artifacts_built++;
+        } catch (const std::exception& e) {
+            failures++;
+            std::cerr << "PrewarmService: " << what << " for book " << book_id << " failed: " << e.what() << std::endl;
+        }
+        return charge(std::chrono::steady_clock::now() - start, bytes_read);
+    };
+
+    // The scanner adds books without a thumbnail; make the one an upload would have
+    if (thumbnail_path.empty()) {
+        if (!step("cover", [&] {
+            std::vector<unsigned char> cover;
+            std::string cover_format;
+            if (file_type == "epub") {
+                BookMetadata metadata = BookManager::extract_epub_metadata(file_path);
+                cover = std::move(metadata.cover_image);
+                cover_format = metadata.cover_format;
+            } else if (file_type == "cbz") {
+                std::vector<std::string> pages = BookManager::list_archive_pages(file_path);
+                if (!pages.empty()) {
+                    auto page = entry_cache->get_or_inflate(file_path, pages.front());
+                    cover.assign(page->begin(), page->end());
+                    cover_format = BookManager::get_image_content_type(pages.front());
+                }
+            }
+            std::string path = book_manager->get_thumbnails_directory() + "/thumb_book" + std::to_string(book_id) +
+                               BookManager::thumbnail_extension(cover.empty() ? "" : cover_format);
+            if (!BookManager::generate_thumbnail(file_path, file_type, cover, path)) {
+                throw std::runtime_error("Failed to write " + path);
+            }
+            if (!database->set_book_thumbnail(book_id, path)) {
+                throw std::runtime_error("Failed to store thumbnail path");
+            }
+            thumbnail_path = path;
+            return cover.size();
+        })) {
+            return;
+        }
+    }
+
+    // Cover thumbnails at every size the thumbnail endpoint serves
+    if (!thumbnail_path.empty() && !thumbnail_path.ends_with(".svg")) {
+        std::shared_ptr<const std::string> cover;
+        auto load_cover = [&] {
+            if (!cover) {
+                FileReadResult file = file_io->read_file(thumbnail_path);
+                if (!file.ok) {
+                    throw std::runtime_error(file.error);
+                }
+                cover = std::make_shared<const std::string>(std::move(file.data));
+            }
+            return cover;
+        };
+        for (int width : PageTranscoder::thumbnail_widths()) {
+            if (!step("thumbnail", [&] {
+                bool loaded = cover != nullptr;
+                transcoder->get_thumbnail(book_id, thumbnail_path, width, format, load_cover);
+                return !loaded && cover ? cover->size() : size_t{0};
+            })) {
+                return;
+            }
+        }
+    }
+
+    if (file_type == "cbz") {
+        std::vector<std::string> pages;
+        if (!step("page index", [&] {
+            pages = BookManager::list_archive_pages(file_path);
+            return size_t{0};
+        })) {
+            return;
+        }
+
+        size_t count = std::min(pages.size(), budget.first_pages);
+        for (size_t i = 0; i < count; i++) {
+            for (int width : PREWARM_PAGE_WIDTHS) {
+                if (!step("page transcode", [&] {
+                    size_t bytes_read = 0;
+                    transcoder->get_page(book_id, static_cast<long>(i), file_path, width, format, [&] {
+                        auto page = entry_cache->get_or_inflate(file_path, pages[i]);
+                        bytes_read = page->size();
+                        return page;
+                    });
+                    return bytes_read;
+                })) {
+                    return;
+                }
+            }
+        }
+    } else if (file_type == "epub") {
+        if (!step("chapter index", [&] {
+            std::vector<std::string> chapters = BookManager::list_epub_chapters(file_path);
+            return chapters.empty() ? size_t{0} : entry_cache->get_or_inflate(file_path, chapters.front())->size();
+        })) {
+            return;
+        }
+    }
+
+    books_warmed++;
+}
+
+nlohmann::json PrewarmService::get_stats() {
+    nlohmann::json stats;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stats["queued"] = queue.size();
+    }
+    stats["books_warmed"] = books_warmed.load();
+    stats["artifacts_built"] = artifacts_built.load();
+    stats["failures"] = failures.load();
+    return stats;
+}
@@ -0,0 +1,358 @@
+/**
+ * @file progress_json.cpp
+ * @brief Implementation of ProgressJson
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "progress_json.h"
+#include "text_normalizer.h"
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool integral(double value, long& result) {
+    if (std::floor(value) != value || std::fabs(value) > 1e15) {
+        return false;
+    }
+    result = static_cast<long>(value);
+    return true;
+}
+
+/**
+ * Recursive-descent walk over the body. Each method starts at the first
+ * character of its production and leaves the cursor just past it.
+ */
+class Scanner {
+public:
+    explicit Scanner(const std::string& text)
+        : cursor(text.data()), end(text.data() + text.size()) {}
+
+    const char* error = nullptr;
+
+    bool document(ProgressJson::Fields& fields) {
+        skip_space();
+        if (cursor >= end || *cursor != '{') {
+            return fail("body must be a JSON object");
+        }
+        if (!object(1, &fields)) {
+            return false;
+        }
+        skip_space();
+        return cursor == end || fail("unexpected data after the object");
+    }
+
+private:
+    const char* cursor;
+    const char* end;
+
+    bool fail(const char* message) {
+        if (!error) {
+            error = message;
+        }
+        return false;
+    }
+
+    void skip_space() {
+        while (cursor < end && is_space(*cursor)) {
+            cursor++;
+        }
+    }
+
+    bool hex4(unsigned& code) {
+        if (end - cursor < 4) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; i++) {
+            int digit = hex_value(cursor[i]);
+            if (digit < 0) {
+                return false;
+            }
+            code = (code << 4) | static_cast<unsigned>(digit);
+        }
+        cursor += 4;
+        return true;
+    }
+
+    bool escape() {
+        if (cursor >= end) {
+            return fail("unterminated string");
+        }
+        switch (*cursor++) {
+            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                return true;
+            case 'u':
+                break;
+            default:
+                return fail("invalid escape in string");
+        }
+
+        unsigned code = 0;
+        if (!hex4(code)) {
+            return fail("invalid \\u escape in string");
+        }
+        if (code == 0) {
+            return fail("\\u0000 is not allowed");
+        }
+        if (code >= 0xDC00 && code <= 0xDFFF) {
+            return fail("unpaired surrogate in string");
+        }
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            unsigned low = 0;
+            if (end - cursor < 2 || cursor[0] != '\\' || cursor[1] != 'u') {
+                return fail("unpaired surrogate in string");
+            }
+            cursor += 2;
+            if (!hex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                return fail("unpaired surrogate in string");
+            }
+        }
+        return true;
+    }
+
+    bool string(std::string_view* raw) {
+        const char* start = ++cursor;
+        while (true) {
+#ifdef __SSE2__
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i last_control = _mm_set1_epi8(0x1F);
+            while (end - cursor >= 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+                __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, last_control), chunk);
+                __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                            _mm_cmpeq_epi8(chunk, backslash)), control);
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+                if (mask != 0) {
+                    cursor += std::countr_zero(mask);
+                    break;
+                }
+                cursor += 16;
+            }
+#endif
+            while (cursor < end && *cursor != '"' && *cursor != '\\' &&
+                   static_cast<unsigned char>(*cursor) >= 0x20) {
+                cursor++;
+            }
+            if (cursor >= end) {
+                return fail("unterminated string");
+            }
+            if (*cursor == '"') {
+                if (raw) {
+                    *raw = std::string_view(start, static_cast<size_t>(cursor - start));
+                }
+                cursor++;
+                return true;
+            }
+            if (*cursor != '\\') {
+                return fail("control character in string");
+            }
+            cursor++;
+            if (!escape()) {
+                return false;
+            }
+        }
+    }
+
+    bool number(double* value, bool* in_range) {
+        const char* start = cursor;
+        if (cursor < end && *cursor == '-') {
+            cursor++;
+        }
+        if (cursor >= end || !is_digit(*cursor)) {
+            return fail("invalid number");
+        }
+        if (*cursor == '0') {
+            cursor++;
+        } else {
+            while (cursor < end && is_digit(*cursor)) cursor++;
+        }
+        if (cursor < end && *cursor == '.') {
+            cursor++;
+            if (cursor >= end || !is_digit(*cursor)) {
+                return fail("invalid number");
+            }
+            while (cursor < end && is_digit(*cursor)) cursor++;
+        }
+        if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+            cursor++;
+            if (cursor < end && (*cursor == '+' || *cursor == '-')) {
+                cursor++;
+            }
+            if (cursor >= end || !is_digit(*cursor)) {
+                return fail("invalid number");
+            }
+            while (cursor < end && is_digit(*cursor)) cursor++;
+        }
+        if (value) {
+            auto result = std::from_chars(start, cursor, *value);
+            *in_range = result.ec == std::errc();
+        }
+        return true;
+    }
+
+    bool literal(std::string_view word) {
+        if (static_cast<size_t>(end - cursor) < word.size() ||
+            std::string_view(cursor, word.size()) != word) {
+            return fail("invalid literal");
+        }
+        cursor += word.size();
+        return true;
+    }
+
+    bool value(int depth) {
+        if (cursor >= end) {
+            return fail("unexpected end of body");
+        }
+        switch (*cursor) {
+            case '{': return object(depth + 1, nullptr);
+            case '[': return array(depth + 1);
+            case '"': return string(nullptr);
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default: return number(nullptr, nullptr);
+        }
+    }
+
+    bool array(int depth) {
+        if (depth > ProgressJson::MAX_DEPTH) {
+            return fail("nesting too deep");
+        }
+        cursor++;
+        skip_space();
+        if (cursor < end && *cursor == ']') {
+            cursor++;
+            return true;
+        }
+        while (true) {
+            skip_space();
+            if (!value(depth)) {
+                return false;
+            }
+            skip_space();
+            if (cursor >= end) {
+                return fail("unterminated array");
+            }
+            if (*cursor == ']') {
+                cursor++;
+                return true;
+            }
+            if (*cursor != ',') {
+                return fail("expected ',' or ']'");
+            }
+            cursor++;
+        }
+    }
+
+    // Top-level fields are only collected when fields is set
+    bool object(int depth, ProgressJson::Fields* fields) {
+        if (depth > ProgressJson::MAX_DEPTH) {
+            return fail("nesting too deep");
+        }
+        cursor++;
+        skip_space();
+        if (cursor < end && *cursor == '}') {
+            cursor++;
+            return true;
+        }
+        while (true) {
+            skip_space();
+            if (cursor >= end || *cursor != '"') {
+                return fail("expected object key");
+            }
+            std::string_view key;
+            if (!string(&key)) {
+                return false;
+            }
+            skip_space();
+            if (cursor >= end || *cursor != ':') {
+                return fail("expected ':'");
+            }
+            cursor++;
+            skip_space();
+
+            if (fields && cursor < end && (*cursor == '-' || is_digit(*cursor))) {
+                double number_value = 0.0;
+                bool in_range = false;
+                if (!number(&number_value, &in_range)) {
+                    return false;
+                }
+                if (in_range) {
+                    assign(key, number_value, *fields);
+                }
+            } else if (!value(depth)) {
+                return false;
+            }
+
+            skip_space();
+            if (cursor >= end) {
+                return fail("unterminated object");
+            }
+            if (*cursor == '}') {
+                cursor++;
+                return true;
+            }
+            if (*cursor != ',') {
+                return fail("expected ',' or '}'");
+            }
+            cursor++;
+        }
+    }
+
+    // Later duplicates win, as in jsonb
+    static void assign(std::string_view key, double number_value, ProgressJson::Fields& fields) {
+        if (key == "progress_percent") {
+            fields.has_percent = true;
+            fields.progress_percent = number_value;
+        } else if (key == "page") {
+            fields.has_page = integral(number_value, fields.page);
+        } else if (key == "chapter") {
+            fields.has_chapter = integral(number_value, fields.chapter);
+        }
+    }
+};
+
+} // namespace
+
+bool ProgressJson::scan(const std::string& body, Fields& fields, std::string& error) {
+    fields = Fields();
+    if (body.size() > MAX_BODY_BYTES) {
+        error = "body too large";
+        return false;
+    }
+    if (!TextNormalizer::is_valid_utf8(body)) {
+        error = "body is not valid UTF-8";
+        return false;
+    }
+
+    Scanner scanner(body);
+    if (!scanner.document(fields)) {
+        error = scanner.error ? scanner.error : "invalid JSON";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file readahead_engine.cpp
+ * @brief Implementation of ReadaheadEngine for sequential page/chapter reading
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "readahead_engine.h"
+#include "book_manager.h"
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t MAX_QUEUED_JOBS = 64;
+constexpr auto SESSION_IDLE_TIMEOUT = std::chrono::minutes(30);
+constexpr auto SESSION_SWEEP_INTERVAL = std::chrono::minutes(5);
+
+} // namespace
+
+ReadaheadEngine::ReadaheadEngine(InflatedEntryCache& entry_cache, size_t max_window)
+    : cache(entry_cache),
+      max_window(max_window > 0 ? max_window : 1),
+      last_session_sweep(std::chrono::steady_clock::now()) {
+    worker = std::thread(&ReadaheadEngine::worker_loop, this);
+}
+
+ReadaheadEngine::~ReadaheadEngine() {
+    stop();
+}
+
+void ReadaheadEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        if (stopping.exchange(true)) {
+            return;
+        }
+        jobs.clear();
+        queued_keys.clear();
+    }
+    jobs_cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+std::string ReadaheadEngine::queue_key(const std::string& archive_path, const std::string& entry_name) {
+    return archive_path + '\n' + entry_name;
+}
+
+void ReadaheadEngine::on_access(const std::string& session_key, const std::string& archive_path,
+                                const std::vector<std::string>& entries, size_t index) {
+    if (stopping || index >= entries.size()) {
+        return;
+    }
+    
+    size_t window;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        auto now = std::chrono::steady_clock::now();
+        
+        // Drop sessions of readers that went away
+        if (now - last_session_sweep > SESSION_SWEEP_INTERVAL) {
+            for (auto it = sessions.begin(); it != sessions.end();) {
+                if (now - it->second.last_seen > SESSION_IDLE_TIMEOUT) {
+                    it = sessions.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            last_session_sweep = now;
+        }
+        
+        auto [it, inserted] = sessions.try_emplace(session_key);
+        Session& session = it->second;
+        if (!inserted && session.archive_path == archive_path && index == session.last_index + 1) {
+            // Reading forward: widen the window
+            session.window = std::min(session.window * 2, max_window);
+        } else if (inserted || session.archive_path != archive_path || index != session.last_index) {
+            // First access or a jump: only prefetch the next entry
+            session.window = 1;
+        }
+        session.archive_path = archive_path;
+        session.last_index = index;
+        session.last_seen = now;
+        window = session.window;
+    }
+    
+    Job job;
+    job.archive_path = archive_path;
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        for (size_t i = index + 1; i < entries.size() && i <= index + window; i++) {
+            std::string key = queue_key(archive_path, entries[i]);
+            if (queued_keys.count(key) || cache.contains(archive_path, entries[i])) {
+                continue;
+            }
+            queued_keys.insert(key);
+            job.entries.push_back(entries[i]);
+        }
+        if (job.entries.empty()) {
+            return;
+        }
+        
+        // Under pressure, stale readahead is worth less than fresh readahead
+        while (jobs.size() >= MAX_QUEUED_JOBS) {
+            for (const auto& entry : jobs.front().entries) {
+                queued_keys.erase(queue_key(jobs.front().archive_path, entry));
+            }
+            jobs.pop_front();
+        }
+        jobs.push_back(std::move(job));
+    }
+    jobs_cv.notify_one();
+}
+
+void ReadaheadEngine::worker_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            jobs_cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        
+        run_job(job);
+        
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        for (const auto& entry : job.entries) {
+            queued_keys.erase(queue_key(job.archive_path, entry));
+        }
+    }
+}
+
+void ReadaheadEngine::run_job(const Job& job) {
+    // Step 1: hint the kernel so the compressed bytes are already in the page
+    // cache (or on their way from the NAS) by the time we inflate them
+    std::vector<ArchiveEntryRange> ranges = BookManager::locate_archive_entries(job.archive_path, job.entries);
+    int fd = open(job.archive_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        for (const auto& range : ranges) {
+            posix_fadvise(fd, static_cast<off_t>(range.offset), static_cast<off_t>(range.length),
+                          POSIX_FADV_WILLNEED);
+        }
+        close(fd);
+    }
+    
+    // Step 2: inflate the entries so the next request is a memory copy
+    for (const auto& entry : job.entries) {
+        if (stopping) {
+            return;
+        }
+        try {
+            cache.get_or_inflate(job.archive_path, entry);
+        } catch (const std::exception& e) {
+            std::cerr << "ReadaheadEngine: Failed to prefetch " << entry
+                      << " from " << job.archive_path << ": " << e.what() << std::endl;
+            return;
+        }
+    }
+}
@@ -0,0 +1,193 @@
+/**
+ * @file replica_set.cpp
+ * @brief Implementation of ReplicaSet
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-18
+ */
+
+#include "replica_set.h"
+#include <iostream>
+
+namespace {
+
+constexpr size_t CONNECTIONS_PER_REPLICA = 4;
+
+// $1 is the primary's WAL position, read just before
+const char* const CHECK_SQL =
+    "SELECT pg_is_in_recovery() AS standby, "
+    "COALESCE(pg_wal_lsn_diff($1::pg_lsn, pg_last_wal_replay_lsn()), 0)::float8 AS behind_bytes, "
+    "COALESCE(EXTRACT(EPOCH FROM clock_timestamp() - pg_last_xact_replay_timestamp()), 0)::float8 AS replay_age";
+
+} // namespace
+
+ReplicaSet::ReplicaSet(const std::vector<std::string>& connection_strings, PgPipeline* primary,
+                       std::chrono::milliseconds check_interval)
+    : primary(primary), interval(check_interval), replicas(connection_strings.size()) {
+    for (size_t i = 0; i < connection_strings.size(); i++) {
+        replicas[i].connection_string = connection_strings[i];
+    }
+    // The first check connects, so an unreachable standby doesn't delay startup
+    checker = std::thread(&ReplicaSet::check_loop, this);
+}
+
+ReplicaSet::~ReplicaSet() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+        stopping = true;
+    }
+    stop_signal.notify_all();
+    if (checker.joinable()) {
+        checker.join();
+    }
+}
+
+bool ReplicaSet::run(const std::vector<PgPipeline::Statement>& statements, double max_staleness_seconds,
+                     std::vector<PgPipeline::Result>& results) {
+    std::shared_ptr<PgPipeline> connection;
+    size_t chosen = 0;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        auto now = std::chrono::steady_clock::now();
+        std::vector<size_t> eligible;
+        for (size_t i = 0; i < replicas.size(); i++) {
+            const Replica& replica = replicas[i];
+            double staleness = replica.lag_seconds +
+                               std::chrono::duration<double>(now - replica.checked_at).count();
+            if (replica.healthy && staleness <= max_staleness_seconds) {
+                eligible.push_back(i);
+            }
+        }
+        if (eligible.empty()) {
+            fallbacks.fetch_add(1);
+            return false;
+        }
+        uint64_t turn = next.fetch_add(1);
+        chosen = eligible[turn % eligible.size()];
+        Replica& replica = replicas[chosen];
+        connection = replica.connections[(turn / eligible.size()) % replica.connections.size()];
+        replica.reads++;
+    }
+
+    results = connection->run(statements);
+    for (const auto& result : results) {
+        if (!result.ok) {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            Replica& replica = replicas[chosen];
+            replica.failures++;
+            if (replica.healthy) {
+                std::cerr << "ReplicaSet: Read from standby " << chosen << " failed, using the primary until the next check: "
+                          << result.error << std::endl;
+            }
+            replica.healthy = false;
+            replica.state = "read failed: " + result.error;
+            fallbacks.fetch_add(1);
+            return false;
+        }
+    }
+    return true;
+}
+
+nlohmann::json ReplicaSet::get_stats() {
+    nlohmann::json stats;
+    stats["check_interval_ms"] = interval.count();
+    stats["primary_fallbacks"] = fallbacks.load();
+    stats["replicas"] = nlohmann::json::array();
+
+    std::lock_guard<std::mutex> lock(state_mutex);
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < replicas.size(); i++) {
+        const Replica& replica = replicas[i];
+        nlohmann::json entry;
+        entry["index"] = i;
+        entry["healthy"] = replica.healthy;
+        entry["state"] = replica.state;
+        entry["lag_seconds"] = replica.lag_seconds;
+        entry["checked_ago_seconds"] = replica.connections.empty() ? nullptr : nlohmann::json(
+            std::chrono::duration<double>(now - replica.checked_at).count());
+        entry["reads"] = replica.reads;
+        entry["failures"] = replica.failures;
+        stats["replicas"].push_back(entry);
+    }
+    return stats;
+}
+
+void ReplicaSet::check_loop() {
+    std::unique_lock<std::mutex> lock(stop_mutex);
+    while (!stopping) {
+        lock.unlock();
+        check_all();
+        lock.lock();
+        stop_signal.wait_for(lock, interval, [this] { return stopping; });
+    }
+}
+
+void ReplicaSet::check_all() {
+    // Without the primary's position nothing can be judged; the standbys
+    // keep their last state and age out of every staleness bound
+    std::vector<PgPipeline::Result> position = primary->run({{"SELECT pg_current_wal_lsn()::text", {}}});
+    if (!position[0].ok || position[0].rows.empty() || !position[0].rows[0][0]) {
+        return;
+    }
+    const std::string& primary_lsn = *position[0].rows[0][0];
+
+    for (size_t i = 0; i < replicas.size(); i++) {
+        std::vector<std::shared_ptr<PgPipeline>> connections;
+        std::string connection_string;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            connections = replicas[i].connections;
+            connection_string = replicas[i].connection_string;
+        }
+
+        bool connected_now = false;
+        std::string state;
+        if (connections.empty()) {
+            try {
+                for (size_t c = 0; c < CONNECTIONS_PER_REPLICA; c++) {
+                    connections.push_back(std::make_shared<PgPipeline>(connection_string));
+                }
+                connected_now = true;
+            } catch (const std::exception& e) {
+                connections.clear();
+                state = e.what();
+            }
+        }
+
+        bool healthy = false;
+        double lag_seconds = 0.0;
+        auto checked_at = std::chrono::steady_clock::now();
+        if (!connections.empty()) {
+            std::vector<PgPipeline::Result> results = connections[0]->run({{CHECK_SQL, {primary_lsn}}});
+            const PgPipeline::Result& result = results[0];
+            if (!result.ok || result.rows.empty()) {
+                state = "check failed: " + result.error;
+            } else if (result.get(0, "standby").value_or("") != "t") {
+                state = "not a standby";
+            } else {
+                double behind_bytes = std::stod(result.get(0, "behind_bytes").value_or("0"));
+                double replay_age = std::stod(result.get(0, "replay_age").value_or("0"));
+                lag_seconds = behind_bytes > 0 ? replay_age : 0.0;
+                healthy = true;
+                state = "ok";
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(state_mutex);
+        Replica& replica = replicas[i];
+        if (connected_now) {
+            replica.connections = connections;
+        }
+        if (healthy != replica.healthy || state != replica.state) {
+            if (healthy) {
+                std::cout << "ReplicaSet: Standby " << i << " is serving reads (lag " << lag_seconds << "s)" << std::endl;
+            } else if (state != replica.state) {
+                std::cerr << "ReplicaSet: Standby " << i << " unavailable: " << state << std::endl;
+            }
+        }
+        replica.healthy = healthy;
+        replica.state = state;
+        replica.lag_seconds = lag_seconds;
+        replica.checked_at = checked_at;
+    }
+}
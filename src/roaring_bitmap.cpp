@@ -0,0 +1,366 @@
+/**
+ * @file roaring_bitmap.cpp
+ * @brief Implementation of RoaringBitmap
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "roaring_bitmap.h"
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+void RoaringBitmap::add(uint32_t value) {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    size_t index = static_cast<size_t>(it - keys.begin());
+    if (it == keys.end() || *it != key) {
+        keys.insert(it, key);
+        containers.insert(containers.begin() + static_cast<long>(index), Container{});
+    }
+
+    Container& container = containers[index];
+    if (container.is_bitmap()) {
+        uint64_t& word = container.bits[low >> 6];
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (!(word & mask)) {
+            word |= mask;
+            container.cardinality++;
+        }
+        return;
+    }
+
+    auto pos = std::lower_bound(container.array.begin(), container.array.end(), low);
+    if (pos != container.array.end() && *pos == low) {
+        return;
+    }
+    container.array.insert(pos, low);
+    container.cardinality++;
+    if (container.array.size() > ARRAY_MAX) {
+        to_bitmap(container);
+    }
+}
+
+void RoaringBitmap::remove(uint32_t value) {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) {
+        return;
+    }
+    size_t index = static_cast<size_t>(it - keys.begin());
+    Container& container = containers[index];
+
+    if (container.is_bitmap()) {
+        uint64_t& word = container.bits[low >> 6];
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (word & mask) {
+            word &= ~mask;
+            container.cardinality--;
+            normalize(container);
+        }
+    } else {
+        auto pos = std::lower_bound(container.array.begin(), container.array.end(), low);
+        if (pos != container.array.end() && *pos == low) {
+            container.array.erase(pos);
+            container.cardinality--;
+        }
+    }
+
+    if (container.cardinality == 0) {
+        keys.erase(it);
+        containers.erase(containers.begin() + static_cast<long>(index));
+    }
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) {
+        return false;
+    }
+    const Container& container = containers[static_cast<size_t>(it - keys.begin())];
+    if (container.is_bitmap()) {
+        return (container.bits[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(container.array.begin(), container.array.end(), low);
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const auto& container : containers) {
+        total += container.cardinality;
+    }
+    return total;
+}
+
+void RoaringBitmap::clear() {
+    keys.clear();
+    containers.clear();
+}
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < keys.size() && j < other.keys.size()) {
+        if (keys[i] < other.keys[j]) {
+            i++;
+        } else if (keys[i] > other.keys[j]) {
+            j++;
+        } else {
+            Container container = intersect(containers[i], other.containers[j]);
+            if (container.cardinality > 0) {
+                result.keys.push_back(keys[i]);
+                result.containers.push_back(std::move(container));
+            }
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < keys.size() || j < other.keys.size()) {
+        if (j == other.keys.size() || (i < keys.size() && keys[i] < other.keys[j])) {
+            result.keys.push_back(keys[i]);
+            result.containers.push_back(containers[i]);
+            i++;
+        } else if (i == keys.size() || keys[i] > other.keys[j]) {
+            result.keys.push_back(other.keys[j]);
+            result.containers.push_back(other.containers[j]);
+            j++;
+        } else {
+            result.keys.push_back(keys[i]);
+            result.containers.push_back(unite(containers[i], other.containers[j]));
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::and_not(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t j = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        while (j < other.keys.size() && other.keys[j] < keys[i]) {
+            j++;
+        }
+        if (j < other.keys.size() && other.keys[j] == keys[i]) {
+            Container container = subtract(containers[i], other.containers[j]);
+            if (container.cardinality > 0) {
+                result.keys.push_back(keys[i]);
+                result.containers.push_back(std::move(container));
+            }
+        } else {
+            result.keys.push_back(keys[i]);
+            result.containers.push_back(containers[i]);
+        }
+    }
+    return result;
+}
+
+uint64_t RoaringBitmap::and_cardinality(const RoaringBitmap& other) const {
+    uint64_t total = 0;
+    size_t i = 0, j = 0;
+    while (i < keys.size() && j < other.keys.size()) {
+        if (keys[i] < other.keys[j]) {
+            i++;
+        } else if (keys[i] > other.keys[j]) {
+            j++;
+        } else {
+            total += intersect_count(containers[i], other.containers[j]);
+            i++;
+            j++;
+        }
+    }
+    return total;
+}
+
+std::vector<uint32_t> RoaringBitmap::to_vector() const {
+    std::vector<uint32_t> values;
+    values.reserve(cardinality());
+    for (size_t i = 0; i < keys.size(); i++) {
+        uint32_t high = static_cast<uint32_t>(keys[i]) << 16;
+        const Container& container = containers[i];
+        if (container.is_bitmap()) {
+            for (size_t w = 0; w < BITMAP_WORDS; w++) {
+                uint64_t word = container.bits[w];
+                while (word) {
+                    int bit = std::countr_zero(word);
+                    values.push_back(high | static_cast<uint32_t>(w * 64 + static_cast<size_t>(bit)));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (uint16_t low : container.array) {
+                values.push_back(high | low);
+            }
+        }
+    }
+    return values;
+}
+
+size_t RoaringBitmap::memory_bytes() const {
+    size_t bytes = keys.capacity() * sizeof(uint16_t) + containers.capacity() * sizeof(Container);
+    for (const auto& container : containers) {
+        bytes += container.array.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+void RoaringBitmap::to_bitmap(Container& container) {
+    container.bits.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : container.array) {
+        container.bits[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    container.array.clear();
+    container.array.shrink_to_fit();
+}
+
+void RoaringBitmap::to_array(Container& container) {
+    container.array.clear();
+    container.array.reserve(container.cardinality);
+    for (size_t w = 0; w < BITMAP_WORDS; w++) {
+        uint64_t word = container.bits[w];
+        while (word) {
+            container.array.push_back(static_cast<uint16_t>(w * 64 + static_cast<size_t>(std::countr_zero(word))));
+            word &= word - 1;
+        }
+    }
+    container.bits.clear();
+    container.bits.shrink_to_fit();
+}
+
+void RoaringBitmap::normalize(Container& container) {
+    if (container.is_bitmap() && container.cardinality <= ARRAY_MAX) {
+        to_array(container);
+    } else if (!container.is_bitmap() && container.cardinality > ARRAY_MAX) {
+        to_bitmap(container);
+    }
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container& a, const Container& b) {
+    Container result;
+    if (a.is_bitmap() && b.is_bitmap()) {
+        result.bits.resize(BITMAP_WORDS);
+        for (size_t w = 0; w < BITMAP_WORDS; w++) {
+            result.bits[w] = a.bits[w] & b.bits[w];
+            result.cardinality += static_cast<uint32_t>(std::popcount(result.bits[w]));
+        }
+        normalize(result);
+    } else if (a.is_bitmap() || b.is_bitmap()) {
+        const Container& array = a.is_bitmap() ? b : a;
+        const Container& bitmap = a.is_bitmap() ? a : b;
+        for (uint16_t low : array.array) {
+            if ((bitmap.bits[low >> 6] >> (low & 63)) & 1) {
+                result.array.push_back(low);
+            }
+        }
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+    } else {
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(result.array));
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+    }
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container& a, const Container& b) {
+    Container result;
+    if (!a.is_bitmap() && !b.is_bitmap() && a.array.size() + b.array.size() <= ARRAY_MAX) {
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(result.array));
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+        return result;
+    }
+
+    result.bits.assign(BITMAP_WORDS, 0);
+    for (const Container* source : {&a, &b}) {
+        if (source->is_bitmap()) {
+            for (size_t w = 0; w < BITMAP_WORDS; w++) {
+                result.bits[w] |= source->bits[w];
+            }
+        } else {
+            for (uint16_t low : source->array) {
+                result.bits[low >> 6] |= uint64_t{1} << (low & 63);
+            }
+        }
+    }
+    for (uint64_t word : result.bits) {
+        result.cardinality += static_cast<uint32_t>(std::popcount(word));
+    }
+    normalize(result);
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::subtract(const Container& a, const Container& b) {
+    Container result;
+    if (a.is_bitmap()) {
+        result.bits = a.bits;
+        if (b.is_bitmap()) {
+            for (size_t w = 0; w < BITMAP_WORDS; w++) {
+                result.bits[w] &= ~b.bits[w];
+            }
+        } else {
+            for (uint16_t low : b.array) {
+                result.bits[low >> 6] &= ~(uint64_t{1} << (low & 63));
+            }
+        }
+        for (uint64_t word : result.bits) {
+            result.cardinality += static_cast<uint32_t>(std::popcount(word));
+        }
+        normalize(result);
+    } else if (b.is_bitmap()) {
+        for (uint16_t low : a.array) {
+            if (!((b.bits[low >> 6] >> (low & 63)) & 1)) {
+                result.array.push_back(low);
+            }
+        }
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+    } else {
+        std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                            std::back_inserter(result.array));
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+    }
+    return result;
+}
+
+uint64_t RoaringBitmap::intersect_count(const Container& a, const Container& b) {
+    uint64_t count = 0;
+    if (a.is_bitmap() && b.is_bitmap()) {
+        for (size_t w = 0; w < BITMAP_WORDS; w++) {
+            count += static_cast<uint64_t>(std::popcount(a.bits[w] & b.bits[w]));
+        }
+    } else if (a.is_bitmap() || b.is_bitmap()) {
+        const Container& array = a.is_bitmap() ? b : a;
+        const Container& bitmap = a.is_bitmap() ? a : b;
+        for (uint16_t low : array.array) {
+            count += (bitmap.bits[low >> 6] >> (low & 63)) & 1;
+        }
+    } else {
+        // Merge walk over two sorted arrays
+        size_t i = 0, j = 0;
+        while (i < a.array.size() && j < b.array.size()) {
+            if (a.array[i] < b.array[j]) {
+                i++;
+            } else if (a.array[i] > b.array[j]) {
+                j++;
+            } else {
+                count++;
+                i++;
+                j++;
+            }
+        }
+    }
+    return count;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file router.cpp
+ * @brief Implementation of Router
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "router.h"
+#include <charconv>
+#include <stdexcept>
+
+void Router::add(const std::string& method, const std::string& pattern, Handler handler) {
+    int index = method_index(method);
+    if (index < 0 || method == "HEAD") {
+        throw std::invalid_argument("Router: unsupported method " + method);
+    }
+    if (pattern.empty() || pattern[0] != '/') {
+        throw std::invalid_argument("Router: pattern must start with '/': " + pattern);
+    }
+
+    Node* node = &root;
+    size_t param_count = 0;
+    size_t start = 1;
+    while (start <= pattern.size()) {
+        size_t end = pattern.find('/', start);
+        if (end == std::string::npos) {
+            end = pattern.size();
+        }
+        std::string segment = pattern.substr(start, end - start);
+
+        if (segment.size() > 2 && segment.front() == '{' && segment.back() == '}') {
+            if (++param_count > RouteParams::MAX_PARAMS) {
+                throw std::invalid_argument("Router: too many parameters in " + pattern);
+            }
+            if (!node->number) {
+                node->number = std::make_unique<Node>();
+            }
+            node = node->number.get();
+        } else {
+            Node* next = nullptr;
+            for (auto& [literal, child] : node->literals) {
+                if (literal == segment) {
+                    next = child.get();
+                    break;
+                }
+            }
+            if (!next) {
+                node->literals.emplace_back(segment, std::make_unique<Node>());
+                next = node->literals.back().second.get();
+            }
+            node = next;
+        }
+        start = end + 1;
+    }
+
+    if (node->handlers[index]) {
+        throw std::invalid_argument("Router: duplicate route " + method + " " + pattern);
+    }
+    node->handlers[index] = std::move(handler);
+}
+
+const Router::Handler* Router::match(const std::string& method, std::string_view path, RouteParams& params) const {
+    int index = method_index(method);
+    if (index < 0 || path.empty() || path[0] != '/') {
+        return nullptr;
+    }
+
+    params.count = 0;
+    const Node* node = find(&root, path.substr(1), params);
+    if (!node || !node->handlers[index]) {
+        return nullptr;
+    }
+    return &node->handlers[index];
+}
+
+bool Router::dispatch(const httplib::Request& req, httplib::Response& res) const {
+    RouteParams params;
+    const Handler* handler = match(req.method, req.path, params);
+    if (!handler) {
+        return false;
+    }
+    (*handler)(req, res, params);
+    return true;
+}
+
+int Router::method_index(const std::string& method) {
+    if (method == "GET" || method == "HEAD") return 0;
+    if (method == "POST") return 1;
+    if (method == "PUT") return 2;
+    if (method == "DELETE") return 3;
+    return -1;
+}
+
+bool Router::parse_number(std::string_view segment, long& value) {
+    if (segment.empty() || segment.size() > 18) {
+        return false;
+    }
+    auto [end, error] = std::from_chars(segment.data(), segment.data() + segment.size(), value);
+    return error == std::errc() && end == segment.data() + segment.size() && segment[0] != '-' && segment[0] != '+';
+}
+
+const Router::Node* Router::find(const Node* node, std::string_view rest, RouteParams& params) {
+    size_t slash = rest.find('/');
+    std::string_view segment = rest.substr(0, slash);
+    std::string_view remainder = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+    bool last = slash == std::string_view::npos;
+
+    for (const auto& [literal, child] : node->literals) {
+        if (literal == segment) {
+            const Node* found = last ? child.get() : find(child.get(), remainder, params);
+            if (found) {
+                return found;
+            }
+            break;
+        }
+    }
+
+    long value = 0;
+    if (node->number && params.count < RouteParams::MAX_PARAMS && parse_number(segment, value)) {
+        size_t saved = params.count;
+        params.values[params.count++] = value;
+        const Node* found = last ? node->number.get() : find(node->number.get(), remainder, params);
+        if (found) {
+            return found;
+        }
+        params.count = saved;
+    }
+    return nullptr;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file scan_scheduler.cpp
+ * @brief Implementation of ScanScheduler
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "scan_scheduler.h"
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// How often the schedule thread looks for roots that are due
+constexpr std::chrono::seconds SCHEDULE_TICK{30};
+
+int parse_field(const std::string& spec, const std::string& value, const char* name) {
+    size_t used = 0;
+    int parsed = 0;
+    try {
+        parsed = std::stoi(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used != value.size() || parsed < 0) {
+        throw std::invalid_argument("Invalid " + std::string(name) + " in library root: " + spec);
+    }
+    return parsed;
+}
+
+} // namespace
+
+LibraryRoot LibraryRoot::parse(const std::string& spec) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t colon = spec.find(':', start);
+        fields.push_back(spec.substr(start, colon - start));
+        if (colon == std::string::npos) {
+            break;
+        }
+        start = colon + 1;
+    }
+    if (fields[0].empty() || fields.size() > 4) {
+        throw std::invalid_argument("Invalid library root: " + spec);
+    }
+
+    LibraryRoot root;
+    root.path = fields[0];
+    if (fields.size() > 1 && !fields[1].empty()) {
+        root.limits.concurrency = std::max(1, parse_field(spec, fields[1], "concurrency"));
+    }
+    if (fields.size() > 2 && !fields[2].empty()) {
+        root.limits.files_per_second = parse_field(spec, fields[2], "files per second");
+    }
+    if (fields.size() > 3 && !fields[3].empty()) {
+        root.interval = std::chrono::minutes(parse_field(spec, fields[3], "interval"));
+    }
+    return root;
+}
+
+ScanScheduler::ScanScheduler(Database* db, BookManager* bm, const std::vector<LibraryRoot>& roots,
+                             std::function<void(long)> on_book_added,
+                             std::function<void()> on_books_removed) {
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& root : roots) {
+        bool duplicate = std::any_of(entries.begin(), entries.end(),
+                                     [&](const Entry& entry) { return entry.root.path == root.path; });
+        if (duplicate) {
+            continue;
+        }
+
+        Entry entry;
+        entry.root = root;
+        entry.scanner = std::make_unique<LibraryScanner>(db, bm, root.limits);
+        if (on_book_added) {
+            entry.scanner->set_book_added_callback(on_book_added);
+        }
+        if (on_books_removed) {
+            entry.scanner->set_books_removed_callback(on_books_removed);
+        }
+        entry.next_run = now + root.interval;
+        entries.push_back(std::move(entry));
+
+        std::cout << "ScanScheduler: library root " << root.path << " (concurrency " << root.limits.concurrency
+                  << ", " << root.limits.files_per_second << " files/s, interval "
+                  << root.interval.count() << " min)" << std::endl;
+    }
+
+    schedule_thread = std::thread(&ScanScheduler::schedule_loop, this);
+}
+
+ScanScheduler::~ScanScheduler() {
+    stop();
+}
+
+void ScanScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(schedule_mutex);
+        if (stopping.exchange(true)) {
+            return;
+        }
+    }
+    schedule_cv.notify_all();
+    if (schedule_thread.joinable()) {
+        schedule_thread.join();
+    }
+    for (auto& entry : entries) {
+        entry.scanner->stop_scan();
+    }
+}
+
+std::vector<std::string> ScanScheduler::start(const std::string& root, bool cleanup_orphaned, bool restart) {
+    std::lock_guard<std::mutex> lock(schedule_mutex);
+    std::vector<std::string> started;
+    for (auto& entry : entries) {
+        if (!root.empty() && entry.root.path != root) {
+            continue;
+        }
+        if (entry.scanner->start_sync_scan(entry.root.path, cleanup_orphaned, restart)) {
+            started.push_back(entry.root.path);
+        }
+    }
+    return started;
+}
+
+void ScanScheduler::stop_scan(const std::string& root, bool discard_checkpoint) {
+    std::lock_guard<std::mutex> lock(schedule_mutex);
+    for (auto& entry : entries) {
+        if (root.empty() || entry.root.path == root) {
+            entry.scanner->stop_scan(discard_checkpoint);
+        }
+    }
+}
+
+void ScanScheduler::resume_interrupted() {
+    std::lock_guard<std::mutex> lock(schedule_mutex);
+    for (auto& entry : entries) {
+        entry.scanner->resume_interrupted_scan(entry.root.path);
+    }
+}
+
+bool ScanScheduler::has_root(const std::string& root) const {
+    return std::any_of(entries.begin(), entries.end(),
+                       [&](const Entry& entry) { return entry.root.path == root; });
+}
+
+std::vector<std::pair<LibraryRoot, ScanStatus>> ScanScheduler::get_status() const {
+    std::vector<std::pair<LibraryRoot, ScanStatus>> statuses;
+    for (const auto& entry : entries) {
+        statuses.emplace_back(entry.root, entry.scanner->get_status());
+    }
+    return statuses;
+}
+
+ScanStatus ScanScheduler::combine(const std::vector<std::pair<LibraryRoot, ScanStatus>>& statuses) {
+    ScanStatus combined;
+    for (const auto& [root, status] : statuses) {
+        combined.total_books += status.total_books;
+        combined.processed_books += status.processed_books;
+        combined.orphaned_cleaned += status.orphaned_cleaned;
+        combined.books_found += status.books_found;
+        combined.resumed = combined.resumed || status.resumed;
+        combined.errors.insert(combined.errors.end(), status.errors.begin(), status.errors.end());
+
+        if (status.is_scanning) {
+            if (!combined.is_scanning || status.start_time < combined.start_time) {
+                combined.start_time = status.start_time;
+            }
+            if (combined.current_book.empty()) {
+                combined.current_book = status.current_book;
+            }
+            combined.is_scanning = true;
+        }
+    }
+    if (combined.total_books > 0) {
+        combined.progress_percentage = (combined.processed_books * 100) / combined.total_books;
+    }
+    return combined;
+}
+
+std::chrono::system_clock::time_point ScanScheduler::next_scheduled_scan(const std::string& root) const {
+    std::lock_guard<std::mutex> lock(schedule_mutex);
+    for (const auto& entry : entries) {
+        if (entry.root.path == root && entry.root.interval.count() > 0) {
+            auto remaining = entry.next_run - std::chrono::steady_clock::now();
+            return std::chrono::system_clock::now() +
+                   std::chrono::duration_cast<std::chrono::system_clock::duration>(remaining);
+        }
+    }
+    return {};
+}
+
+void ScanScheduler::schedule_loop() {
+    std::unique_lock<std::mutex> lock(schedule_mutex);
+    while (!stopping) {
+        auto now = std::chrono::steady_clock::now();
+        for (auto& entry : entries) {
+            if (entry.root.interval.count() == 0) {
+                continue;
+            }
+            if (entry.scanner->is_scan_active()) {
+                // Measure the interval from the end of the previous scan
+                entry.next_run = now + entry.root.interval;
+            } else if (now >= entry.next_run) {
+                std::cout << "ScanScheduler: scheduled scan of " << entry.root.path << std::endl;
+                entry.scanner->start_scan(entry.root.path);
+                entry.next_run = now + entry.root.interval;
+            }
+        }
+        schedule_cv.wait_for(lock, SCHEDULE_TICK, [this] { return stopping.load(); });
+    }
+}
@@ -0,0 +1,296 @@
+/**
+ * @file schema_migrator.cpp
+ * @brief Implementation of SchemaMigrator and the schema history
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-18
+ */
+
+#include "schema_migrator.h"
+#include <openssl/sha.h>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+
+namespace {
+
+constexpr long MIGRATION_LOCK_KEY = 0x6d796c6962;   // "mylib"
+constexpr int LOCK_TIMEOUT_ATTEMPTS = 3;
+constexpr std::chrono::milliseconds LOCK_POLL_INTERVAL{500};
+
+// Never edit an entry once released; add a new one instead
+const std::vector<SchemaMigrator::Migration> MIGRATIONS = {
+    {1, "core tables", R"(
+        CREATE TABLE IF NOT EXISTS users (
+            id SERIAL PRIMARY KEY,
+            username VARCHAR(50) UNIQUE NOT NULL,
+            password_hash VARCHAR(255) NOT NULL,
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+        CREATE TABLE IF NOT EXISTS books (
+            id SERIAL PRIMARY KEY,
+            title VARCHAR(255) NOT NULL,
+            author VARCHAR(255),
+            file_path VARCHAR(500) UNIQUE NOT NULL,
+            file_type VARCHAR(10) NOT NULL,
+            file_size BIGINT NOT NULL DEFAULT 0,
+            uploaded_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+        ALTER TABLE books
+            ADD COLUMN IF NOT EXISTS description TEXT,
+            ADD COLUMN IF NOT EXISTS publisher VARCHAR(255),
+            ADD COLUMN IF NOT EXISTS isbn VARCHAR(20),
+            ADD COLUMN IF NOT EXISTS language VARCHAR(10) DEFAULT 'en',
+            ADD COLUMN IF NOT EXISTS thumbnail_path VARCHAR(500),
+            ADD COLUMN IF NOT EXISTS page_count INTEGER,
+            ADD COLUMN IF NOT EXISTS metadata_extracted BOOLEAN DEFAULT FALSE,
+            ADD COLUMN IF NOT EXISTS extraction_error TEXT,
+            ADD COLUMN IF NOT EXISTS title_sort BYTEA,
+            ADD COLUMN IF NOT EXISTS author_sort BYTEA;
+        CREATE TABLE IF NOT EXISTS user_book_progress (
+            user_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,
+            book_id INTEGER NOT NULL REFERENCES books(id) ON DELETE CASCADE,
+            last_accessed_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            progress_details JSONB,
+            PRIMARY KEY (user_id, book_id)
+        );
+        CREATE TABLE IF NOT EXISTS tags (
+            id SERIAL PRIMARY KEY,
+            name VARCHAR(100) UNIQUE NOT NULL
+        );
+        CREATE TABLE IF NOT EXISTS book_tags (
+            book_id INTEGER NOT NULL REFERENCES books(id) ON DELETE CASCADE,
+            tag_id INTEGER NOT NULL REFERENCES tags(id) ON DELETE CASCADE,
+            PRIMARY KEY (book_id, tag_id)
+        );
+        CREATE TABLE IF NOT EXISTS scan_checkpoints (
+            root TEXT PRIMARY KEY,
+            state JSONB NOT NULL,
+            updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+        CREATE INDEX IF NOT EXISTS idx_users_username ON users(username);
+    )", nullptr},
+
+    {2, "collections", R"(
+        CREATE TABLE IF NOT EXISTS collections (
+            id SERIAL PRIMARY KEY,
+            name VARCHAR(255) NOT NULL,
+            description TEXT,
+            owner_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,
+            is_public BOOLEAN DEFAULT FALSE,
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+        ALTER TABLE collections ADD COLUMN IF NOT EXISTS smart_rules JSONB;
+        CREATE TABLE IF NOT EXISTS collection_books (
+            collection_id INTEGER NOT NULL REFERENCES collections(id) ON DELETE CASCADE,
+            book_id INTEGER NOT NULL REFERENCES books(id) ON DELETE CASCADE,
+            added_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            added_by INTEGER REFERENCES users(id) ON DELETE SET NULL,
+            PRIMARY KEY (collection_id, book_id)
+        );
+        CREATE TABLE IF NOT EXISTS collection_permissions (
+            id SERIAL PRIMARY KEY,
+            collection_id INTEGER NOT NULL REFERENCES collections(id) ON DELETE CASCADE,
+            user_id INTEGER NOT NULL REFERENCES users(id) ON DELETE CASCADE,
+            permission_type VARCHAR(20) NOT NULL CHECK (permission_type IN ('view', 'add_books', 'edit', 'admin')),
+            granted_by INTEGER REFERENCES users(id) ON DELETE SET NULL,
+            granted_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            UNIQUE(collection_id, user_id)
+        );
+        CREATE INDEX IF NOT EXISTS idx_collections_owner ON collections(owner_id);
+        CREATE INDEX IF NOT EXISTS idx_collections_public ON collections(is_public);
+        CREATE INDEX IF NOT EXISTS idx_collections_smart ON collections(id) WHERE smart_rules IS NOT NULL;
+        CREATE INDEX IF NOT EXISTS idx_collections_public_created ON collections(created_at DESC, id DESC) WHERE is_public = true;
+        CREATE INDEX IF NOT EXISTS idx_collection_permissions_collection ON collection_permissions(collection_id);
+        CREATE INDEX IF NOT EXISTS idx_collection_permissions_user ON collection_permissions(user_id);
+    )", nullptr},
+
+    // Tables that grow with the library and its readers
+    {3, "books file path index",
+     "CREATE INDEX CONCURRENTLY IF NOT EXISTS idx_books_file_path ON books(file_path)",
+     "idx_books_file_path"},
+    {4, "books title sort index",
+     "CREATE INDEX CONCURRENTLY IF NOT EXISTS idx_books_title_sort ON books(title_sort, id)",
+     "idx_books_title_sort"},
+    {5, "books author sort index",
+     "CREATE INDEX CONCURRENTLY IF NOT EXISTS idx_books_author_sort ON books(author_sort, title_sort, id)",
+     "idx_books_author_sort"},
+    {6, "progress user index",
+     "CREATE INDEX CONCURRENTLY IF NOT EXISTS idx_progress_user_id ON user_book_progress(user_id)",
+     "idx_progress_user_id"},
+    {7, "book tags tag index",
+     "CREATE INDEX CONCURRENTLY IF NOT EXISTS idx_book_tags_tag_id ON book_tags(tag_id)",
+     "idx_book_tags_tag_id"},
+    {8, "collection books collection index",
+     "CREATE INDEX CONCURRENTLY IF NOT EXISTS idx_collection_books_collection ON collection_books(collection_id)",
+     "idx_collection_books_collection"},
+    {9, "collection books book index",
+     "CREATE INDEX CONCURRENTLY IF NOT EXISTS idx_collection_books_book ON collection_books(book_id)",
+     "idx_collection_books_book"},
+    
+    // Who may change the shared tags of a book
+    {10, "book uploader and admin flag", R"(
+        ALTER TABLE books ADD COLUMN IF NOT EXISTS uploaded_by INTEGER REFERENCES users(id) ON DELETE SET NULL;
+        ALTER TABLE users ADD COLUMN IF NOT EXISTS is_admin BOOLEAN NOT NULL DEFAULT FALSE;
+    )", nullptr},
+};
+
+} // namespace
+
+SchemaMigrator::SchemaMigrator(pqxx::connection& conn) : conn(conn) {
+}
+
+const std::vector<SchemaMigrator::Migration>& SchemaMigrator::migrations() {
+    return MIGRATIONS;
+}
+
+int SchemaMigrator::migrate() {
+    const int latest = MIGRATIONS.back().version;
+
+    // Fast path: one query
+    std::optional<std::map<int, std::string>> applied = load_applied();
+    if (applied && verify(*applied)) {
+        return latest;
+    }
+
+    {
+        pqxx::nontransaction txn(conn);
+        txn.exec(R"(
+            CREATE TABLE IF NOT EXISTS schema_migrations (
+                version INTEGER PRIMARY KEY,
+                name TEXT NOT NULL,
+                checksum TEXT NOT NULL,
+                applied_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            )
+        )");
+    }
+
+    // Poll instead of blocking in pg_advisory_lock: a waiting statement holds a
+    // snapshot, and CREATE INDEX CONCURRENTLY in the lock holder waits for it
+    while (true) {
+        pqxx::nontransaction txn(conn);
+        if (txn.exec_params("SELECT pg_try_advisory_lock($1)", MIGRATION_LOCK_KEY)[0][0].as<bool>()) {
+            break;
+        }
+        std::this_thread::sleep_for(LOCK_POLL_INTERVAL);
+    }
+
+    int applied_count = 0;
+    try {
+        // Another instance may have migrated while we waited for the lock
+        applied = load_applied();
+        verify(*applied);
+        for (const auto& migration : MIGRATIONS) {
+            if (!applied->count(migration.version)) {
+                apply(migration);
+                applied_count++;
+            }
+        }
+    } catch (...) {
+        pqxx::nontransaction txn(conn);
+        txn.exec_params("SELECT pg_advisory_unlock($1)", MIGRATION_LOCK_KEY);
+        throw;
+    }
+    pqxx::nontransaction txn(conn);
+    txn.exec_params("SELECT pg_advisory_unlock($1)", MIGRATION_LOCK_KEY);
+
+    std::cout << "SchemaMigrator: Schema at version " << latest << " (" << applied_count << " migrations applied)" << std::endl;
+    return latest;
+}
+
+std::optional<std::map<int, std::string>> SchemaMigrator::load_applied() {
+    try {
+        pqxx::nontransaction txn(conn);
+        pqxx::result result = txn.exec("SELECT version, checksum FROM schema_migrations ORDER BY version");
+        std::map<int, std::string> applied;
+        for (auto row : result) {
+            applied.emplace(row[0].as<int>(), row[1].as<std::string>());
+        }
+        return applied;
+    } catch (const pqxx::undefined_table&) {
+        return std::nullopt;
+    }
+}
+
+bool SchemaMigrator::verify(const std::map<int, std::string>& applied) {
+    bool complete = true;
+    for (const auto& migration : MIGRATIONS) {
+        auto it = applied.find(migration.version);
+        if (it == applied.end()) {
+            complete = false;
+        } else if (it->second != checksum(migration.sql)) {
+            throw std::runtime_error("SchemaMigrator: Migration " + std::to_string(migration.version) + " (" +
+                                     migration.name + ") differs from the one applied to this database");
+        }
+    }
+    if (!applied.empty() && applied.rbegin()->first > MIGRATIONS.back().version) {
+        std::cerr << "SchemaMigrator: Database schema version " << applied.rbegin()->first
+                  << " is newer than this server (" << MIGRATIONS.back().version << ")" << std::endl;
+    }
+    return complete;
+}
+
+void SchemaMigrator::apply(const Migration& migration) {
+    auto started = std::chrono::steady_clock::now();
+    std::string sum = checksum(migration.sql);
+
+    if (migration.concurrent_index) {
+        // Not in a transaction: CREATE INDEX CONCURRENTLY doesn't allow one
+        try {
+            pqxx::nontransaction txn(conn);
+            pqxx::result invalid = txn.exec_params(
+                "SELECT 1 FROM pg_index i JOIN pg_class c ON c.oid = i.indexrelid "
+                "WHERE c.relname = $1 AND pg_table_is_visible(c.oid) AND NOT i.indisvalid",
+                std::string(migration.concurrent_index));
+            if (!invalid.empty()) {
+                std::cout << "SchemaMigrator: Rebuilding interrupted index " << migration.concurrent_index << std::endl;
+                txn.exec("DROP INDEX CONCURRENTLY IF EXISTS " + txn.quote_name(migration.concurrent_index));
+            }
+            txn.exec(migration.sql);
+            txn.exec_params("INSERT INTO schema_migrations (version, name, checksum) VALUES ($1, $2, $3)",
+                            migration.version, std::string(migration.name), sum);
+        } catch (const std::exception& e) {
+            throw std::runtime_error("SchemaMigrator: Migration " + std::to_string(migration.version) +
+                                     " (" + migration.name + ") failed: " + e.what());
+        }
+    } else {
+        for (int attempt = 1;; attempt++) {
+            try {
+                pqxx::work txn(conn);
+                txn.exec("SET LOCAL lock_timeout = '10s'");
+                txn.exec(migration.sql);
+                txn.exec_params("INSERT INTO schema_migrations (version, name, checksum) VALUES ($1, $2, $3)",
+                                migration.version, std::string(migration.name), sum);
+                txn.commit();
+                break;
+            } catch (const pqxx::sql_error& e) {
+                if (e.sqlstate() != "55P03" || attempt == LOCK_TIMEOUT_ATTEMPTS) {
+                    throw std::runtime_error("SchemaMigrator: Migration " + std::to_string(migration.version) +
+                                             " (" + migration.name + ") failed: " + e.what());
+                }
+                std::cerr << "SchemaMigrator: Migration " << migration.version << " timed out waiting for a lock, retrying"
+                          << std::endl;
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    std::cout << "SchemaMigrator: Applied migration " << migration.version << " (" << migration.name << ") in "
+              << elapsed.count() << " ms" << std::endl;
+}
+
+std::string SchemaMigrator::checksum(const char* sql) {
+    std::string text = sql;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(text.data()), text.size(), digest);
+    static const char HEX[] = "0123456789abcdef";
+    std::string hex;
+    for (unsigned char byte : digest) {
+        hex.push_back(HEX[byte >> 4]);
+        hex.push_back(HEX[byte & 0x0F]);
+    }
+    return hex;
+}
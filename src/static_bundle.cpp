@@ -0,0 +1,288 @@
+/**
+ * @file static_bundle.cpp
+ * @brief Implementation of StaticBundle
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "static_bundle.h"
+#include "file_io.h"
+#include <openssl/sha.h>
+#include <zlib.h>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#ifdef MYLIBRARY_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t MIN_COMPRESS_BYTES = 256;
+constexpr size_t BROTLI_LARGE_FILE = 512 * 1024;   // Compressed with a faster quality at startup
+const char* const IMMUTABLE = "public, max-age=31536000, immutable";
+const char* const REVALIDATE = "no-cache";
+
+} // namespace
+
+StaticBundle::StaticBundle(FileIoBackend* file_io, const std::string& root) {
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+        std::cerr << "StaticBundle: Web directory " << root << " not found, the frontend will not be served" << std::endl;
+        return;
+    }
+
+    std::vector<std::string> paths;
+    std::vector<FileReadRequest> requests;
+    for (auto it = fs::recursive_directory_iterator(root, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (!it->is_regular_file(ec)) {
+            continue;
+        }
+        paths.push_back("/" + fs::relative(it->path(), root, ec).generic_string());
+        requests.push_back(FileReadRequest{it->path().string()});
+    }
+
+    std::vector<FileReadResult> results = file_io->read_batch(requests);
+    std::unordered_map<std::string, std::string> contents;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].ok) {
+            std::cerr << "StaticBundle: Failed to read " << requests[i].path << ": " << results[i].error << std::endl;
+            continue;
+        }
+        contents.emplace(paths[i], std::move(results[i].data));
+    }
+
+    for (auto& [path, data] : contents) {
+        // Precompressed siblings from the build are attached to their original
+        if ((path.ends_with(".gz") || path.ends_with(".br")) && contents.count(path.substr(0, path.size() - 3))) {
+            continue;
+        }
+
+        Asset asset;
+        asset.content_type = content_type_for(path);
+        asset.cache_control = is_hashed_name(path) ? IMMUTABLE : REVALIDATE;
+
+        if (is_compressible(asset.content_type) && data.size() >= MIN_COMPRESS_BYTES) {
+            auto prebuilt = contents.find(path + ".gz");
+            asset.gzip.data = prebuilt != contents.end() ? std::make_shared<const std::string>(prebuilt->second) : gzip(data);
+            prebuilt = contents.find(path + ".br");
+            asset.brotli.data = prebuilt != contents.end() ? std::make_shared<const std::string>(prebuilt->second) : brotli(data);
+
+            for (Variant* variant : {&asset.gzip, &asset.brotli}) {
+                if (variant->data && variant->data->size() >= data.size()) {
+                    variant->data.reset();
+                }
+            }
+        }
+
+        asset.identity.etag = etag_for(data, "");
+        if (asset.gzip.data) {
+            asset.gzip.etag = etag_for(data, "-gz");
+            compressed_bytes += asset.gzip.data->size();
+        }
+        if (asset.brotli.data) {
+            asset.brotli.etag = etag_for(data, "-br");
+            compressed_bytes += asset.brotli.data->size();
+        }
+        identity_bytes += data.size();
+        asset.identity.data = std::make_shared<const std::string>(std::move(data));
+        assets.emplace(path, std::move(asset));
+    }
+
+    std::cout << "StaticBundle: Loaded " << assets.size() << " files (" << identity_bytes / 1024 << " KiB, "
+              << compressed_bytes / 1024 << " KiB compressed variants) from " << root << std::endl;
+}
+
+const StaticBundle::Asset* StaticBundle::find(const std::string& path) const {
+    std::string key = path.empty() || path.back() == '/' ? path + "index.html" : path;
+    auto it = assets.find(key);
+    if (it != assets.end()) {
+        return &it->second;
+    }
+
+    // Client-side routes get the app shell; missing files and API paths don't
+    if (path == "/api" || path.starts_with("/api/")) {
+        return nullptr;
+    }
+    size_t slash = path.rfind('/');
+    if (path.find('.', slash == std::string::npos ? 0 : slash) != std::string::npos) {
+        return nullptr;
+    }
+    it = assets.find("/index.html");
+    return it != assets.end() ? &it->second : nullptr;
+}
+
+const StaticBundle::Variant& StaticBundle::select(const Asset& asset, const std::string& accept_encoding,
+                                                  std::string& encoding) {
+    bool accepts_brotli = false;
+    bool accepts_gzip = false;
+    size_t start = 0;
+    while (start < accept_encoding.size()) {
+        size_t end = accept_encoding.find(',', start);
+        if (end == std::string::npos) {
+            end = accept_encoding.size();
+        }
+        std::string token = accept_encoding.substr(start, end - start);
+        start = end + 1;
+
+        size_t semicolon = token.find(';');
+        std::string name = token.substr(0, semicolon);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (semicolon != std::string::npos) {
+            size_t q = token.find("q=", semicolon);
+            if (q != std::string::npos && std::strtod(token.c_str() + q + 2, nullptr) <= 0.0) {
+                continue;
+            }
+        }
+        accepts_brotli |= name == "br";
+        accepts_gzip |= name == "gzip";
+    }
+
+    if (accepts_brotli && asset.brotli.data) {
+        encoding = "br";
+        return asset.brotli;
+    }
+    if (accepts_gzip && asset.gzip.data) {
+        encoding = "gzip";
+        return asset.gzip;
+    }
+    encoding.clear();
+    return asset.identity;
+}
+
+nlohmann::json StaticBundle::get_stats() const {
+    nlohmann::json stats;
+    stats["files"] = assets.size();
+    stats["bytes"] = identity_bytes;
+    stats["compressed_bytes"] = compressed_bytes;
+#ifdef MYLIBRARY_HAVE_BROTLI
+    stats["brotli"] = true;
+#else
+    stats["brotli"] = false;
+#endif
+    return stats;
+}
+
+std::string StaticBundle::content_type_for(const std::string& path) {
+    static const std::unordered_map<std::string, std::string> TYPES = {
+        {".html", "text/html; charset=utf-8"},
+        {".js", "text/javascript; charset=utf-8"},
+        {".mjs", "text/javascript; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"},
+        {".json", "application/json"},
+        {".map", "application/json"},
+        {".webmanifest", "application/manifest+json"},
+        {".txt", "text/plain; charset=utf-8"},
+        {".xml", "application/xml"},
+        {".svg", "image/svg+xml"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".webp", "image/webp"},
+        {".ico", "image/x-icon"},
+        {".woff", "font/woff"},
+        {".woff2", "font/woff2"},
+        {".ttf", "font/ttf"},
+        {".wasm", "application/wasm"},
+        {".pdf", "application/pdf"},
+        {".gz", "application/gzip"},
+    };
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        auto it = TYPES.find(path.substr(dot));
+        if (it != TYPES.end()) {
+            return it->second;
+        }
+    }
+    return "application/octet-stream";
+}
+
+bool StaticBundle::is_compressible(const std::string& content_type) {
+    return content_type.starts_with("text/") || content_type.starts_with("application/json") ||
+           content_type.starts_with("application/manifest+json") || content_type.starts_with("application/xml") ||
+           content_type == "image/svg+xml" || content_type == "application/wasm" ||
+           content_type == "font/ttf" || content_type == "image/x-icon";
+}
+
+bool StaticBundle::is_hashed_name(const std::string& path) {
+    // Vite emits assets/<name>-<8 character hash>.<ext>
+    if (path.find("/assets/") == std::string::npos) {
+        return false;
+    }
+    std::string name = path.substr(path.rfind('/') + 1);
+    size_t dot = name.find('.');
+    if (dot == std::string::npos || dot < 10 || name[dot - 9] != '-') {
+        return false;
+    }
+    for (size_t i = dot - 8; i < dot; i++) {
+        char c = name[i];
+        bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string StaticBundle::etag_for(const std::string& data, const char* suffix) {
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(data.data()), data.size(), digest);
+    static const char HEX[] = "0123456789abcdef";
+    std::string etag = "\"";
+    for (int i = 0; i < 12; i++) {
+        etag.push_back(HEX[digest[i] >> 4]);
+        etag.push_back(HEX[digest[i] & 0x0F]);
+    }
+    etag += suffix;
+    etag.push_back('"');
+    return etag;
+}
+
+std::shared_ptr<const std::string> StaticBundle::gzip(const std::string& data) {
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return nullptr;
+    }
+    std::string compressed(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+    stream.avail_out = static_cast<uInt>(compressed.size());
+    int result = deflate(&stream, Z_FINISH);
+    size_t produced = stream.total_out;
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        return nullptr;
+    }
+    compressed.resize(produced);
+    return std::make_shared<const std::string>(std::move(compressed));
+}
+
+std::shared_ptr<const std::string> StaticBundle::brotli(const std::string& data) {
+#ifdef MYLIBRARY_HAVE_BROTLI
+    size_t size = BrotliEncoderMaxCompressedSize(data.size());
+    if (size == 0) {
+        return nullptr;
+    }
+    std::string compressed(size, '\0');
+    int quality = data.size() > BROTLI_LARGE_FILE ? 9 : BROTLI_MAX_QUALITY;
+    if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, data.size(),
+                               reinterpret_cast<const uint8_t*>(data.data()), &size,
+                               reinterpret_cast<uint8_t*>(compressed.data()))) {
+        return nullptr;
+    }
+    compressed.resize(size);
+    return std::make_shared<const std::string>(std::move(compressed));
+#else
+    (void)data;
+    return nullptr;
+#endif
+}
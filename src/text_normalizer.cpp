@@ -0,0 +1,302 @@
+/**
+ * @file text_normalizer.cpp
+ * @brief Implementation of TextNormalizer
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "text_normalizer.h"
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <vector>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const char REPLACEMENT[] = "\xEF\xBF\xBD";   // U+FFFD
+
+struct Composition {
+    char32_t base;
+    char32_t mark;
+    char32_t composed;
+};
+
+// Canonical compositions into Latin-1 Supplement and Latin Extended-A,
+// sorted by (base, mark)
+const Composition LATIN_COMPOSITIONS[] = {
+    {0x0041, 0x0300, 0x00C0}, {0x0041, 0x0301, 0x00C1}, {0x0041, 0x0302, 0x00C2}, {0x0041, 0x0303, 0x00C3},
+    {0x0041, 0x0304, 0x0100}, {0x0041, 0x0306, 0x0102}, {0x0041, 0x0308, 0x00C4}, {0x0041, 0x030A, 0x00C5},
+    {0x0041, 0x0328, 0x0104}, {0x0043, 0x0301, 0x0106}, {0x0043, 0x0302, 0x0108}, {0x0043, 0x0307, 0x010A},
+    {0x0043, 0x030C, 0x010C}, {0x0043, 0x0327, 0x00C7}, {0x0044, 0x030C, 0x010E}, {0x0045, 0x0300, 0x00C8},
+    {0x0045, 0x0301, 0x00C9}, {0x0045, 0x0302, 0x00CA}, {0x0045, 0x0304, 0x0112}, {0x0045, 0x0306, 0x0114},
+    {0x0045, 0x0307, 0x0116}, {0x0045, 0x0308, 0x00CB}, {0x0045, 0x030C, 0x011A}, {0x0045, 0x0328, 0x0118},
+    {0x0047, 0x0302, 0x011C}, {0x0047, 0x0306, 0x011E}, {0x0047, 0x0307, 0x0120}, {0x0047, 0x0327, 0x0122},
+    {0x0048, 0x0302, 0x0124}, {0x0049, 0x0300, 0x00CC}, {0x0049, 0x0301, 0x00CD}, {0x0049, 0x0302, 0x00CE},
+    {0x0049, 0x0303, 0x0128}, {0x0049, 0x0304, 0x012A}, {0x0049, 0x0306, 0x012C}, {0x0049, 0x0307, 0x0130},
+    {0x0049, 0x0308, 0x00CF}, {0x0049, 0x0328, 0x012E}, {0x004A, 0x0302, 0x0134}, {0x004B, 0x0327, 0x0136},
+    {0x004C, 0x0301, 0x0139}, {0x004C, 0x030C, 0x013D}, {0x004C, 0x0327, 0x013B}, {0x004E, 0x0301, 0x0143},
+    {0x004E, 0x0303, 0x00D1}, {0x004E, 0x030C, 0x0147}, {0x004E, 0x0327, 0x0145}, {0x004F, 0x0300, 0x00D2},
+    {0x004F, 0x0301, 0x00D3}, {0x004F, 0x0302, 0x00D4}, {0x004F, 0x0303, 0x00D5}, {0x004F, 0x0304, 0x014C},
+    {0x004F, 0x0306, 0x014E}, {0x004F, 0x0308, 0x00D6}, {0x004F, 0x030B, 0x0150}, {0x0052, 0x0301, 0x0154},
+    {0x0052, 0x030C, 0x0158}, {0x0052, 0x0327, 0x0156}, {0x0053, 0x0301, 0x015A}, {0x0053, 0x0302, 0x015C},
+    {0x0053, 0x030C, 0x0160}, {0x0053, 0x0327, 0x015E}, {0x0054, 0x030C, 0x0164}, {0x0054, 0x0327, 0x0162},
+    {0x0055, 0x0300, 0x00D9}, {0x0055, 0x0301, 0x00DA}, {0x0055, 0x0302, 0x00DB}, {0x0055, 0x0303, 0x0168},
+    {0x0055, 0x0304, 0x016A}, {0x0055, 0x0306, 0x016C}, {0x0055, 0x0308, 0x00DC}, {0x0055, 0x030A, 0x016E},
+    {0x0055, 0x030B, 0x0170}, {0x0055, 0x0328, 0x0172}, {0x0057, 0x0302, 0x0174}, {0x0059, 0x0301, 0x00DD},
+    {0x0059, 0x0302, 0x0176}, {0x0059, 0x0308, 0x0178}, {0x005A, 0x0301, 0x0179}, {0x005A, 0x0307, 0x017B},
+    {0x005A, 0x030C, 0x017D}, {0x0061, 0x0300, 0x00E0}, {0x0061, 0x0301, 0x00E1}, {0x0061, 0x0302, 0x00E2},
+    {0x0061, 0x0303, 0x00E3}, {0x0061, 0x0304, 0x0101}, {0x0061, 0x0306, 0x0103}, {0x0061, 0x0308, 0x00E4},
+    {0x0061, 0x030A, 0x00E5}, {0x0061, 0x0328, 0x0105}, {0x0063, 0x0301, 0x0107}, {0x0063, 0x0302, 0x0109},
+    {0x0063, 0x0307, 0x010B}, {0x0063, 0x030C, 0x010D}, {0x0063, 0x0327, 0x00E7}, {0x0064, 0x030C, 0x010F},
+    {0x0065, 0x0300, 0x00E8}, {0x0065, 0x0301, 0x00E9}, {0x0065, 0x0302, 0x00EA}, {0x0065, 0x0304, 0x0113},
+    {0x0065, 0x0306, 0x0115}, {0x0065, 0x0307, 0x0117}, {0x0065, 0x0308, 0x00EB}, {0x0065, 0x030C, 0x011B},
+    {0x0065, 0x0328, 0x0119}, {0x0067, 0x0302, 0x011D}, {0x0067, 0x0306, 0x011F}, {0x0067, 0x0307, 0x0121},
+    {0x0067, 0x0327, 0x0123}, {0x0068, 0x0302, 0x0125}, {0x0069, 0x0300, 0x00EC}, {0x0069, 0x0301, 0x00ED},
+    {0x0069, 0x0302, 0x00EE}, {0x0069, 0x0303, 0x0129}, {0x0069, 0x0304, 0x012B}, {0x0069, 0x0306, 0x012D},
+    {0x0069, 0x0308, 0x00EF}, {0x0069, 0x0328, 0x012F}, {0x006A, 0x0302, 0x0135}, {0x006B, 0x0327, 0x0137},
+    {0x006C, 0x0301, 0x013A}, {0x006C, 0x030C, 0x013E}, {0x006C, 0x0327, 0x013C}, {0x006E, 0x0301, 0x0144},
+    {0x006E, 0x0303, 0x00F1}, {0x006E, 0x030C, 0x0148}, {0x006E, 0x0327, 0x0146}, {0x006F, 0x0300, 0x00F2},
+    {0x006F, 0x0301, 0x00F3}, {0x006F, 0x0302, 0x00F4}, {0x006F, 0x0303, 0x00F5}, {0x006F, 0x0304, 0x014D},
+    {0x006F, 0x0306, 0x014F}, {0x006F, 0x0308, 0x00F6}, {0x006F, 0x030B, 0x0151}, {0x0072, 0x0301, 0x0155},
+    {0x0072, 0x030C, 0x0159}, {0x0072, 0x0327, 0x0157}, {0x0073, 0x0301, 0x015B}, {0x0073, 0x0302, 0x015D},
+    {0x0073, 0x030C, 0x0161}, {0x0073, 0x0327, 0x015F}, {0x0074, 0x030C, 0x0165}, {0x0074, 0x0327, 0x0163},
+    {0x0075, 0x0300, 0x00F9}, {0x0075, 0x0301, 0x00FA}, {0x0075, 0x0302, 0x00FB}, {0x0075, 0x0303, 0x0169},
+    {0x0075, 0x0304, 0x016B}, {0x0075, 0x0306, 0x016D}, {0x0075, 0x0308, 0x00FC}, {0x0075, 0x030A, 0x016F},
+    {0x0075, 0x030B, 0x0171}, {0x0075, 0x0328, 0x0173}, {0x0077, 0x0302, 0x0175}, {0x0079, 0x0301, 0x00FD},
+    {0x0079, 0x0302, 0x0177}, {0x0079, 0x0308, 0x00FF}, {0x007A, 0x0301, 0x017A}, {0x007A, 0x0307, 0x017C},
+    {0x007A, 0x030C, 0x017E}
+};
+
+bool is_hangul_initial(char32_t cp) { return cp >= 0x1100 && cp <= 0x1112; }
+bool is_hangul_medial(char32_t cp) { return cp >= 0x1161 && cp <= 0x1175; }
+bool is_hangul_final(char32_t cp) { return cp >= 0x11A8 && cp <= 0x11C2; }
+
+// Hiragana/katakana with a voiced (U+3099) or semi-voiced (U+309A) sound mark
+char32_t compose_kana(char32_t base, char32_t mark) {
+    char32_t hiragana = base >= 0x30A1 && base <= 0x30FA ? base - 0x60 : base;
+    bool voiced_row = (hiragana >= 0x304B && hiragana <= 0x3061 && hiragana % 2 == 1) ||
+                      hiragana == 0x3064 || hiragana == 0x3066 || hiragana == 0x3068;
+    bool ha_row = hiragana == 0x306F || hiragana == 0x3072 || hiragana == 0x3075 ||
+                  hiragana == 0x3078 || hiragana == 0x307B;
+    if (mark == 0x3099) {
+        if (voiced_row || ha_row) return base + 1;
+        if (base == 0x3046) return 0x3094;                       // ゔ
+        if (base == 0x30A6) return 0x30F4;                       // ヴ
+        if (base >= 0x30EF && base <= 0x30F2) return base + 8;   // ヷ-ヺ
+        if (base == 0x309D || base == 0x30FD) return base + 1;   // iteration marks
+    } else if (mark == 0x309A && ha_row) {
+        return base + 2;
+    }
+    return 0;
+}
+
+// Composed form of a pair, 0 if the pair doesn't compose
+char32_t compose_pair(char32_t first, char32_t second) {
+    if (is_hangul_initial(first) && is_hangul_medial(second)) {
+        return 0xAC00 + ((first - 0x1100) * 21 + (second - 0x1161)) * 28;
+    }
+    if (first >= 0xAC00 && first <= 0xD7A3 && (first - 0xAC00) % 28 == 0 && is_hangul_final(second)) {
+        return first + (second - 0x11A7);
+    }
+    if (second >= 0x0300 && second <= 0x036F && first < 0x0180) {
+        const Composition* end = LATIN_COMPOSITIONS + std::size(LATIN_COMPOSITIONS);
+        const Composition* it = std::lower_bound(LATIN_COMPOSITIONS, end, Composition{first, second, 0},
+            [](const Composition& a, const Composition& b) {
+                return a.base != b.base ? a.base < b.base : a.mark < b.mark;
+            });
+        return it != end && it->base == first && it->mark == second ? it->composed : 0;
+    }
+    if (second == 0x3099 || second == 0x309A) {
+        return compose_kana(first, second);
+    }
+    return 0;
+}
+
+void append_utf8(std::string& out, char32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+// Whether text contains anything compose() could combine with the character before it
+bool has_combining_candidates(const std::string& text) {
+    for (size_t i = 0; i + 1 < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        unsigned char next = static_cast<unsigned char>(text[i + 1]);
+        if (c == 0xCC || (c == 0xCD && next < 0xB0)) {
+            return true;   // U+0300-U+036F
+        }
+        if (c == 0xE1 && next >= 0x85 && next <= 0x87) {
+            return true;   // conjoining medials and finals
+        }
+        if (c == 0xE3 && next == 0x82 && i + 2 < text.size() &&
+            (static_cast<unsigned char>(text[i + 2]) == 0x99 || static_cast<unsigned char>(text[i + 2]) == 0x9A)) {
+            return true;   // kana sound marks
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::string TextNormalizer::normalize(const std::string& text) {
+    if (ascii_prefix(text.data(), text.size()) == text.size() && text.find('\0') == std::string::npos) {
+        return text;
+    }
+    return compose(is_valid_utf8(text) ? text : repair_utf8(text));
+}
+
+bool TextNormalizer::is_valid_utf8(const std::string& text) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(text.data());
+    size_t i = 0;
+    while (i < text.size()) {
+        i += ascii_prefix(text.data() + i, text.size() - i);
+        if (i >= text.size()) {
+            break;
+        }
+        bool valid = false;
+        size_t length = scan_sequence(data + i, text.size() - i, valid);
+        if (!valid) {
+            return false;
+        }
+        i += length;
+    }
+    return text.find('\0') == std::string::npos;
+}
+
+std::string TextNormalizer::repair_utf8(const std::string& text) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(text.data());
+    std::string repaired;
+    repaired.reserve(text.size() + 8);
+    size_t i = 0;
+    while (i < text.size()) {
+        size_t run = ascii_prefix(text.data() + i, text.size() - i);
+        for (size_t k = i; k < i + run; k++) {
+            if (text[k] != '\0') {
+                repaired.push_back(text[k]);   // PostgreSQL text can't hold NUL
+            }
+        }
+        i += run;
+        if (i >= text.size()) {
+            break;
+        }
+        bool valid = false;
+        size_t length = scan_sequence(data + i, text.size() - i, valid);
+        if (valid) {
+            repaired.append(text, i, length);
+        } else {
+            repaired += REPLACEMENT;
+        }
+        i += length;
+    }
+    return repaired;
+}
+
+std::string TextNormalizer::compose(const std::string& text) {
+    if (!has_combining_candidates(text)) {
+        return text;
+    }
+
+    std::vector<char32_t> code_points;
+    code_points.reserve(text.size());
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(text.data());
+    size_t i = 0;
+    while (i < text.size()) {
+        bool valid = false;
+        size_t length = scan_sequence(data + i, text.size() - i, valid);
+        char32_t cp = 0xFFFD;
+        if (valid) {
+            cp = length == 1 ? data[i] : data[i] & (0x7F >> length);
+            for (size_t k = 1; k < length; k++) {
+                cp = (cp << 6) | (data[i + k] & 0x3F);
+            }
+        }
+        // Each mark combines with the (possibly already composed) character before it
+        char32_t composed = code_points.empty() ? 0 : compose_pair(code_points.back(), cp);
+        if (composed) {
+            code_points.back() = composed;
+        } else {
+            code_points.push_back(cp);
+        }
+        i += length;
+    }
+
+    std::string out;
+    out.reserve(text.size());
+    for (char32_t cp : code_points) {
+        append_utf8(out, cp);
+    }
+    return out;
+}
+
+size_t TextNormalizer::ascii_prefix(const char* data, size_t size) {
+    size_t i = 0;
+#ifdef __SSE2__
+    // The sign bit of every byte, 16 at a time
+    for (; i + 16 <= size; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        if (mask != 0) {
+            return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+    while (i < size && static_cast<unsigned char>(data[i]) < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+size_t TextNormalizer::scan_sequence(const unsigned char* data, size_t size, bool& valid) {
+    valid = false;
+    unsigned char lead = data[0];
+    if (lead < 0x80) {
+        valid = lead != 0;
+        return 1;
+    }
+
+    // Allowed range of the second byte rules out overlong forms, surrogates and > U+10FFFF
+    size_t needed;
+    unsigned char low = 0x80, high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        needed = 1;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        needed = 2;
+        if (lead == 0xE0) low = 0xA0;
+        if (lead == 0xED) high = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        needed = 3;
+        if (lead == 0xF0) low = 0x90;
+        if (lead == 0xF4) high = 0x8F;
+    } else {
+        return 1;
+    }
+
+    for (size_t k = 1; k <= needed; k++) {
+        if (k >= size) {
+            return k;
+        }
+        unsigned char c = data[k];
+        if (k == 1 ? (c < low || c > high) : (c < 0x80 || c > 0xBF)) {
+            return k;
+        }
+    }
+    valid = true;
+    return needed + 1;
+}
@@ -0,0 +1,774 @@
+/**
+ * @file transfer_engine.cpp
+ * @brief Implementation of TransferEngine (epoll + non-blocking sockets + sendfile)
+ * @author MyLibrary Team
+ * @version 0.1.0
+ * @date 2026-10-17
+ */
+
+#include "transfer_engine.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr size_t MAX_HEAD_SIZE = 16 * 1024;           // Reject request heads larger than this
+constexpr size_t READ_CHUNK = 4096;
+constexpr size_t SENDFILE_SLICE = 1024 * 1024;        // Max bytes per sendfile call (fairness)
+constexpr int MAX_EVENTS = 256;
+constexpr auto IDLE_TIMEOUT = std::chrono::seconds(60);
+
+std::string to_lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+}
+
+/**
+ * @brief Whether a header name is a valid HTTP token
+ */
+bool is_header_name(const std::string& name) {
+    static const std::string specials = "!#$%&'*+-.^_`|~";
+    if (name.empty()) return false;
+    return std::all_of(name.begin(), name.end(), [](unsigned char c) {
+        return std::isalnum(c) || specials.find(static_cast<char>(c)) != std::string::npos;
+    });
+}
+
+/**
+ * @brief Drops control characters from a header value
+ *
+ * Values may carry text from book metadata; a CR or LF would end the
+ * header and let the rest be read as headers or a body of its own.
+ */
+std::string header_value(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (unsigned char c : value) {
+        if ((c >= 0x20 && c != 0x7F) || c == '\t') {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Whether a comma-separated header value lists a token (case-insensitive)
+ */
+bool has_token(const std::string& value, const std::string& token) {
+    std::stringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        if (to_lower(trim(item)) == token) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Percent-decodes a path or query component
+ * @param plus_as_space Decode '+' as a space (form-encoded query strings only)
+ */
+std::string url_decode(const std::string& s, bool plus_as_space) {
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '%' && i + 2 < s.size() &&
+            std::isxdigit(static_cast<unsigned char>(s[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(s[i + 2]))) {
+            out += static_cast<char>(std::stoi(s.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else if (s[i] == '+' && plus_as_space) {
+            out += ' ';
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+const char* status_text(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Content Too Large";
+        case 416: return "Range Not Satisfiable";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        default:  return "Unknown";
+    }
+}
+
+/**
+ * @brief Parses a single "bytes=a-b" range against a file size
+ * @return true if a satisfiable range was parsed into [first, last]
+ */
+bool parse_range(const std::string& value, off_t size, off_t& first, off_t& last) {
+    if (value.rfind("bytes=", 0) != 0 || value.find(',') != std::string::npos || size == 0) {
+        return false;
+    }
+    std::string spec = value.substr(6);
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos) return false;
+
+    std::string a = trim(spec.substr(0, dash));
+    std::string b = trim(spec.substr(dash + 1));
+    try {
+        if (a.empty()) {
+            // Suffix range: last N bytes
+            off_t n = std::stoll(b);
+            if (n <= 0) return false;
+            first = std::max<off_t>(0, size - n);
+            last = size - 1;
+        } else {
+            first = std::stoll(a);
+            last = b.empty() ? size - 1 : std::min<off_t>(std::stoll(b), size - 1);
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return first >= 0 && first <= last && first < size;
+}
+
+} // namespace
+
+// ========== TransferRequest ==========
+
+std::string TransferRequest::header(const std::string& name) const {
+    auto it = headers.find(to_lower(name));
+    return it != headers.end() ? it->second : "";
+}
+
+std::string TransferRequest::query_param(const std::string& name) const {
+    size_t pos = 0;
+    while (pos <= query.size()) {
+        size_t amp = query.find('&', pos);
+        std::string pair = query.substr(pos, amp == std::string::npos ? std::string::npos : amp - pos);
+        size_t eq = pair.find('=');
+        if (url_decode(pair.substr(0, eq), true) == name) {
+            return eq == std::string::npos ? "" : url_decode(pair.substr(eq + 1), true);
+        }
+        if (amp == std::string::npos) break;
+        pos = amp + 1;
+    }
+    return "";
+}
+
+// ========== TransferEngine ==========
+
+TransferEngine::TransferEngine(int listen_port, Resolver resolver_fn, size_t workers_n)
+    : port(listen_port), resolver(std::move(resolver_fn)), worker_count(std::max<size_t>(1, workers_n)) {
+}
+
+TransferEngine::~TransferEngine() {
+    stop();
+}
+
+bool TransferEngine::start() {
+    if (running.load()) {
+        return true;
+    }
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        std::cerr << "TransferEngine: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int yes = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0) {
+        std::cerr << "TransferEngine: failed to listen on port " << port << ": "
+                  << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        std::cerr << "TransferEngine: epoll/eventfd setup failed: " << std::strerror(errno) << std::endl;
+        stop();
+        return false;
+    }
+
+    // Listening socket and wake-up eventfd are tagged with the high bit so
+    // they never collide with connection ids
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = (1ULL << 63) | static_cast<uint64_t>(listen_fd);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+    ev.data.u64 = (1ULL << 63) | static_cast<uint64_t>(wake_fd);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+
+    running.store(true);
+    for (size_t i = 0; i < worker_count; i++) {
+        workers.emplace_back(&TransferEngine::worker_loop, this);
+    }
+    loop_thread = std::thread(&TransferEngine::event_loop, this);
+
+    std::cout << "TransferEngine: streaming on port " << port
+              << " with " << worker_count << " resolver workers" << std::endl;
+    return true;
+}
+
+void TransferEngine::stop() {
+    bool was_running = running.exchange(false);
+
+    if (was_running) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+        jobs_cv.notify_all();
+    }
+
+    if (loop_thread.joinable()) {
+        loop_thread.join();
+    }
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+
+    // Anything still queued belongs to connections that are gone now
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex);
+        for (auto& c : completions) {
+            if (c.file_fd >= 0) close(c.file_fd);
+        }
+        completions.clear();
+    }
+    std::vector<uint64_t> ids;
+    for (const auto& [id, conn] : connections) ids.push_back(id);
+    for (uint64_t id : ids) close_connection(id);
+
+    if (listen_fd >= 0) { close(listen_fd); listen_fd = -1; }
+    if (wake_fd >= 0) { close(wake_fd); wake_fd = -1; }
+    if (epoll_fd >= 0) { close(epoll_fd); epoll_fd = -1; }
+
+    if (was_running) {
+        std::cout << "TransferEngine: stopped" << std::endl;
+    }
+}
+
+void TransferEngine::event_loop() {
+    epoll_event events[MAX_EVENTS];
+    auto last_sweep = std::chrono::steady_clock::now();
+
+    while (running.load()) {
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, 1000);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "TransferEngine: epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            uint64_t tag = events[i].data.u64;
+            if (tag & (1ULL << 63)) {
+                int fd = static_cast<int>(tag & ~(1ULL << 63));
+                if (fd == listen_fd) {
+                    accept_connections();
+                } else if (fd == wake_fd) {
+                    uint64_t count;
+                    while (read(wake_fd, &count, sizeof(count)) > 0) {}
+                    drain_completions();
+                }
+                continue;
+            }
+
+            auto it = connections.find(tag);
+            if (it == connections.end()) continue;
+            Connection& conn = *it->second;
+
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                close_connection(conn.id);
+                continue;
+            }
+            if (events[i].events & EPOLLRDHUP) {
+                // Half-close: the client may still be waiting for the answer to
+                // what it sent, so keep the connection until the output is out
+                if (conn.state == ConnectionState::RESOLVING) {
+                    conn.peer_closed = true;
+                    update_interest(conn, 0);
+                } else if (conn.state == ConnectionState::SENDING) {
+                    conn.peer_closed = true;
+                    update_interest(conn, EPOLLOUT);
+                }
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLRDHUP)) && conn.state == ConnectionState::READING_HEAD) {
+                handle_readable(conn);
+                if (connections.find(tag) == connections.end()) continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                handle_writable(conn);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_sweep >= std::chrono::seconds(5)) {
+            sweep_idle_connections();
+            last_sweep = now;
+        }
+    }
+}
+
+void TransferEngine::accept_connections() {
+    while (true) {
+        int client = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "TransferEngine: accept failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        int yes = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        auto conn = std::make_unique<Connection>();
+        conn->id = next_connection_id++;
+        conn->fd = client;
+        conn->last_activity = std::chrono::steady_clock::now();
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = conn->id;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &ev) < 0) {
+            close(client);
+            continue;
+        }
+
+        connections.emplace(conn->id, std::move(conn));
+        connection_count.fetch_add(1);
+    }
+}
+
+void TransferEngine::handle_readable(Connection& conn) {
+    if (conn.state != ConnectionState::READING_HEAD) {
+        // Pipelined bytes while we are busy: leave them in the kernel buffer
+        return;
+    }
+
+    char buffer[READ_CHUNK];
+    while (true) {
+        ssize_t n = read(conn.fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            conn.in.append(buffer, static_cast<size_t>(n));
+            conn.last_activity = std::chrono::steady_clock::now();
+            if (conn.in.size() > MAX_HEAD_SIZE) break;
+            continue;
+        }
+        if (n == 0) {
+            conn.peer_closed = true;
+            break;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        if (errno == EINTR) continue;
+        close_connection(conn.id);
+        return;
+    }
+
+    size_t head_end = conn.in.find("\r\n\r\n");
+    if (head_end == std::string::npos) {
+        if (conn.in.size() > MAX_HEAD_SIZE) {
+            reject_request(conn, 431);
+        } else if (conn.peer_closed) {
+            close_connection(conn.id);
+        }
+        return;
+    }
+
+    std::string head = conn.in.substr(0, head_end + 4);
+    conn.in.erase(0, head_end + 4);
+
+    TransferRequest request;
+    if (!parse_request_head(head, request)) {
+        reject_request(conn, 400);
+        return;
+    }
+
+    // Every route is a GET/HEAD; a body would be read as the next request
+    // head, so requests carrying one are refused and the connection closed
+    std::string content_length = request.header("content-length");
+    if (!request.header("transfer-encoding").empty() ||
+        (!content_length.empty() && content_length.find_first_not_of('0') != std::string::npos)) {
+        reject_request(conn, 413);
+        return;
+    }
+
+    // HTTP/1.1 connections persist unless closed, HTTP/1.0 ones only on request
+    std::string connection = request.header("connection");
+    bool keep_alive = request.version == "HTTP/1.0" ? has_token(connection, "keep-alive")
+                                                    : !has_token(connection, "close");
+    dispatch_request(conn, std::move(request), keep_alive);
+}
+
+void TransferEngine::reject_request(Connection& conn, int status) {
+    conn.out = "HTTP/1.1 " + std::to_string(status) + " " + status_text(status) +
+               "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    conn.out_offset = 0;
+    conn.keep_alive = false;
+    conn.state = ConnectionState::SENDING;
+    update_interest(conn, EPOLLOUT);
+}
+
+void TransferEngine::dispatch_request(Connection& conn, TransferRequest request, bool keep_alive) {
+    conn.state = ConnectionState::RESOLVING;
+    update_interest(conn, EPOLLRDHUP);
+
+    uint64_t id = conn.id;
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        jobs.emplace_back([this, id, request = std::move(request), keep_alive]() {
+            Completion completion = build_completion(id, request, keep_alive);
+            {
+                std::lock_guard<std::mutex> done_lock(completions_mutex);
+                completions.push_back(std::move(completion));
+            }
+            uint64_t one = 1;
+            ssize_t ignored = write(wake_fd, &one, sizeof(one));
+            (void)ignored;
+        });
+    }
+    jobs_cv.notify_one();
+}
+
+void TransferEngine::worker_loop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            jobs_cv.wait(lock, [this] { return !jobs.empty() || !running.load(); });
+            if (!running.load()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+TransferEngine::Completion TransferEngine::build_completion(uint64_t connection_id,
+                                                            const TransferRequest& request,
+                                                            bool keep_alive) {
+    Completion completion{connection_id, "", "", nullptr, -1, 0, 0, keep_alive};
+
+    TransferTarget target;
+    try {
+        target = resolver(request);
+    } catch (const std::exception& e) {
+        target = TransferTarget{};
+        target.status = 500;
+        target.body = std::string(R"({"success":false,"error":"Internal server error"})");
+        std::cerr << "TransferEngine: resolver error for " << request.path << ": " << e.what() << std::endl;
+    }
+
+    off_t body_length = static_cast<off_t>(target.shared_body ? target.shared_body->size() : target.body.size());
+    int status = target.status;
+    std::string range_header;
+
+    if (!target.file_path.empty() && status == 200) {
+        int fd = open(target.file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st{};
+        if (fd < 0 || fstat(fd, &st) < 0) {
+            if (fd >= 0) close(fd);
+            status = 404;
+            target.content_type = "application/json";
+            target.body = R"({"success":false,"error":"File not found on disk"})";
+            target.shared_body.reset();
+            body_length = static_cast<off_t>(target.body.size());
+        } else {
+            completion.file_fd = fd;
+            completion.file_offset = 0;
+            completion.file_end = st.st_size;
+
+            std::string range = request.header("range");
+            off_t first = 0, last = 0;
+            if (!range.empty()) {
+                if (parse_range(range, st.st_size, first, last)) {
+                    status = 206;
+                    completion.file_offset = first;
+                    completion.file_end = last + 1;
+                    range_header = "bytes " + std::to_string(first) + "-" + std::to_string(last) +
+                                   "/" + std::to_string(st.st_size);
+                } else {
+                    close(fd);
+                    completion.file_fd = -1;
+                    completion.file_end = 0;
+                    status = 416;
+                    range_header = "bytes */" + std::to_string(st.st_size);
+                }
+            }
+            body_length = completion.file_end - completion.file_offset;
+        }
+    }
+
+    std::ostringstream head;
+    head << "HTTP/1.1 " << status << " " << status_text(status) << "\r\n";
+    head << "Content-Type: " << header_value(target.content_type) << "\r\n";
+    head << "Content-Length: " << (status == 416 ? 0 : body_length) << "\r\n";
+    head << "Access-Control-Allow-Origin: *\r\n";
+    if (completion.file_fd >= 0 || status == 416) {
+        head << "Accept-Ranges: bytes\r\n";
+    }
+    if (!range_header.empty()) {
+        head << "Content-Range: " << range_header << "\r\n";
+    }
+    for (const auto& [name, value] : target.headers) {
+        if (!is_header_name(name)) {
+            std::cerr << "TransferEngine: Dropping header with invalid name" << std::endl;
+            continue;
+        }
+        head << name << ": " << header_value(value) << "\r\n";
+    }
+    head << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n\r\n";
+    completion.head = head.str();
+
+    if (request.method == "HEAD") {
+        if (completion.file_fd >= 0) close(completion.file_fd);
+        completion.file_fd = -1;
+    } else if (completion.file_fd < 0 && status != 416) {
+        completion.body = std::move(target.body);
+        completion.shared_body = std::move(target.shared_body);
+    }
+
+    return completion;
+}
+
+void TransferEngine::drain_completions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex);
+        ready.swap(completions);
+    }
+
+    for (auto& completion : ready) {
+        auto it = connections.find(completion.connection_id);
+        if (it == connections.end()) {
+            // Client went away while we were resolving
+            if (completion.file_fd >= 0) close(completion.file_fd);
+            continue;
+        }
+
+        Connection& conn = *it->second;
+        conn.out = std::move(completion.head);
+        conn.out += completion.body;
+        conn.out_offset = 0;
+        conn.shared_body = std::move(completion.shared_body);
+        conn.shared_offset = 0;
+        conn.file_fd = completion.file_fd;
+        conn.file_offset = completion.file_offset;
+        conn.file_end = completion.file_end;
+        conn.keep_alive = completion.keep_alive;
+        conn.state = ConnectionState::SENDING;
+        conn.last_activity = std::chrono::steady_clock::now();
+
+        // Try to make progress right away; most small responses finish here
+        handle_writable(conn);
+    }
+}
+
+void TransferEngine::handle_writable(Connection& conn) {
+    if (conn.state != ConnectionState::SENDING) {
+        return;
+    }
+
+    // 1. Response head (and in-memory body)
+    while (conn.out_offset < conn.out.size()) {
+        ssize_t n = send(conn.fd, conn.out.data() + conn.out_offset,
+                         conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_offset += static_cast<size_t>(n);
+            conn.last_activity = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            update_interest(conn, EPOLLOUT | EPOLLRDHUP);
+            return;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        close_connection(conn.id);
+        return;
+    }
+
+    // 2. Cached body, straight from the cache's buffer
+    while (conn.shared_body && conn.shared_offset < conn.shared_body->size()) {
+        ssize_t n = send(conn.fd, conn.shared_body->data() + conn.shared_offset,
+                         conn.shared_body->size() - conn.shared_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.shared_offset += static_cast<size_t>(n);
+            conn.last_activity = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            update_interest(conn, EPOLLOUT | EPOLLRDHUP);
+            return;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        close_connection(conn.id);
+        return;
+    }
+
+    // 3. File body via sendfile, one bounded slice per wake-up so that a
+    //    single fast client cannot starve the others
+    if (conn.file_fd >= 0 && conn.file_offset < conn.file_end) {
+        size_t remaining = static_cast<size_t>(conn.file_end - conn.file_offset);
+        ssize_t n = sendfile(conn.fd, conn.file_fd, &conn.file_offset, std::min(remaining, SENDFILE_SLICE));
+        if (n > 0) {
+            conn.last_activity = std::chrono::steady_clock::now();
+        } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            close_connection(conn.id);
+            return;
+        } else if (n == 0) {
+            // File shrank underneath us; the promised Content-Length can't be met
+            close_connection(conn.id);
+            return;
+        }
+
+        if (conn.file_offset < conn.file_end) {
+            update_interest(conn, EPOLLOUT | EPOLLRDHUP);
+            return;
+        }
+    }
+
+    // 4. Response complete
+    if (conn.file_fd >= 0) {
+        close(conn.file_fd);
+        conn.file_fd = -1;
+    }
+    conn.out.clear();
+    conn.out_offset = 0;
+    conn.shared_body.reset();
+
+    if (!conn.keep_alive) {
+        close_connection(conn.id);
+        return;
+    }
+
+    conn.state = ConnectionState::READING_HEAD;
+    update_interest(conn, EPOLLIN | EPOLLRDHUP);
+
+    // A pipelined request may already be sitting in the input buffer. A
+    // half-closed client won't signal again: read what it left and close
+    if (conn.peer_closed || conn.in.find("\r\n\r\n") != std::string::npos) {
+        handle_readable(conn);
+    }
+}
+
+void TransferEngine::update_interest(const Connection& conn, uint32_t events) {
+    // After a half-close both would report ready forever
+    if (conn.peer_closed) {
+        events &= ~static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP);
+    }
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.u64 = conn.id;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+void TransferEngine::close_connection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+
+    Connection& conn = *it->second;
+    if (epoll_fd >= 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn.fd, nullptr);
+    }
+    close(conn.fd);
+    if (conn.file_fd >= 0) {
+        close(conn.file_fd);
+    }
+
+    connections.erase(it);
+    connection_count.fetch_sub(1);
+}
+
+void TransferEngine::sweep_idle_connections() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<uint64_t> idle;
+    for (const auto& [id, conn] : connections) {
+        // Connections waiting on a worker are not idle, the worker will come back
+        if (conn->state != ConnectionState::RESOLVING && now - conn->last_activity > IDLE_TIMEOUT) {
+            idle.push_back(id);
+        }
+    }
+    for (uint64_t id : idle) {
+        close_connection(id);
+    }
+}
+
+bool TransferEngine::parse_request_head(const std::string& head, TransferRequest& request) {
+    std::istringstream stream(head);
+    std::string line;
+
+    if (!std::getline(stream, line)) {
+        return false;
+    }
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+
+    // Request line: METHOD SP target SP version
+    size_t sp1 = line.find(' ');
+    size_t sp2 = line.rfind(' ');
+    if (sp1 == std::string::npos || sp2 == sp1) {
+        return false;
+    }
+    request.method = line.substr(0, sp1);
+    std::string target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    request.version = line.substr(sp2 + 1);
+    if (request.version.rfind("HTTP/", 0) != 0 || target.empty() || target[0] != '/') {
+        return false;
+    }
+
+    size_t q = target.find('?');
+    request.path = url_decode(target.substr(0, q), false);
+    request.query = q == std::string::npos ? "" : target.substr(q + 1);
+
+    while (std::getline(stream, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) break;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        request.headers[to_lower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+    }
+
+    return true;
+}